@@ -0,0 +1,61 @@
+// Generates `wcwidth_table.h`, the two-level lookup table behind `ffWcwidth()` (src/util/wcwidth.c).
+// Build and run manually after updating wcwidth.c:
+//   cc -o gentable gentable.c && ./gentable > wcwidth_table.h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#undef _WIN32 // Always include the planes 2 and 3. Must run where wchar_t has 32 bits
+#include "wcwidth.c"
+
+#define FF_WCWIDTH_BLOCK_SIZE 256
+#define FF_WCWIDTH_BLOCKS (0x110000 / FF_WCWIDTH_BLOCK_SIZE)
+
+int main(void)
+{
+    static uint8_t stage1[FF_WCWIDTH_BLOCKS];
+    static uint8_t stage2[256][FF_WCWIDTH_BLOCK_SIZE / 4];
+    int stage2Count = 0;
+
+    for (int block = 0; block < FF_WCWIDTH_BLOCKS; ++block)
+    {
+        // 2 bits per code point: the width, or 3 for control characters
+        uint8_t packed[FF_WCWIDTH_BLOCK_SIZE / 4] = {0};
+        for (int i = 0; i < FF_WCWIDTH_BLOCK_SIZE; ++i)
+        {
+            int width = mk_wcwidth(block * FF_WCWIDTH_BLOCK_SIZE + i);
+            packed[i / 4] |= (uint8_t) ((width < 0 ? 3 : width) << (i % 4 * 2));
+        }
+
+        int index = 0;
+        while (index < stage2Count && memcmp(stage2[index], packed, sizeof(packed)) != 0)
+            ++index;
+        if (index == stage2Count)
+        {
+            if (stage2Count == 256)
+                return 1;
+            memcpy(stage2[stage2Count++], packed, sizeof(packed));
+        }
+        stage1[block] = (uint8_t) index;
+    }
+
+    puts("// Generated by gentable.c from mk_wcwidth(). Do not edit");
+    puts("#pragma once\n");
+    puts("#include <stdint.h>\n");
+    printf("#define FF_WCWIDTH_BLOCK_SIZE %d\n\n", FF_WCWIDTH_BLOCK_SIZE);
+    printf("static const uint8_t ffWcwidthStage1[%d] = {", FF_WCWIDTH_BLOCKS);
+    for (int i = 0; i < FF_WCWIDTH_BLOCKS; ++i)
+        printf("%s%u,", i % 32 == 0 ? "\n    " : " ", stage1[i]);
+    puts("\n};\n");
+    printf("static const uint8_t ffWcwidthStage2[%d][%d] = {\n", stage2Count, FF_WCWIDTH_BLOCK_SIZE / 4);
+    for (int i = 0; i < stage2Count; ++i)
+    {
+        printf("    {");
+        for (int j = 0; j < FF_WCWIDTH_BLOCK_SIZE / 4; ++j)
+            printf("%s0x%02x,", j % 16 == 0 ? "\n        " : " ", stage2[i][j]);
+        puts("\n    },");
+    }
+    puts("};");
+    return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "fastfetch.h"
+
+// Called for every matching string. `str` is NUL-terminated and `length` excludes the NUL. Returning false stops the scan
+typedef bool FFBinaryStringCallback(const char* str, uint32_t length, void* data);
+
+// Maps an executable and calls `callback` for every string in its read-only data (`.rodata`) that starts with `prefix`.
+// Lets us read version literals compiled into a program without running it
+const char* ffBinaryFindStrings(const char* file, const char* prefix, FFBinaryStringCallback* callback, void* data);
+
+typedef struct FFBinaryVersionPattern
+{
+    const char* prefix; // Literal that the version string starts with, e.g. `@(#)Bash version `
+    const char* skipTo; // Optional. The version starts after the first occurrence of this in the rest of the string
+    const char* terminators; // The version ends before the first of these chars
+} FFBinaryVersionPattern;
+
+// The version of the first string matching `pattern`. Candidates must start with a digit and contain no `*` or `%`,
+// which rules out wildcards and format strings that share the prefix (e.g. `OpenSSH_7.4*`)
+bool ffBinaryFindVersion(const char* file, const FFBinaryVersionPattern* pattern, FFstrbuf* version);
+
+// Version of an executable cached on disk by a previous run. `name` identifies the entry, e.g. `shell-bash`.
+// An entry is valid as long as the device, inode and mtime of `file` are unchanged
+bool ffBinaryVersionCacheRead(const char* name, const char* file, FFstrbuf* version);
+void ffBinaryVersionCacheWrite(const char* name, const char* file, const FFstrbuf* version);
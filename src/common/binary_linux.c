@@ -0,0 +1,237 @@
+#include "binary.h"
+#include "common/io/io.h"
+
+#include <elf.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    #define FF_ELFDATA_NATIVE ELFDATA2LSB
+#else
+    #define FF_ELFDATA_NATIVE ELFDATA2MSB
+#endif
+
+typedef struct FFElfSection
+{
+    uint32_t name;
+    uint32_t type;
+    uint64_t offset;
+    uint64_t size;
+} FFElfSection;
+
+static bool readSection(const uint8_t* base, bool is64, uint64_t shoff, uint16_t shentsize, uint16_t index, FFElfSection* section)
+{
+    const uint8_t* p = base + shoff + (uint64_t) index * shentsize;
+    if (is64)
+    {
+        if (shentsize < sizeof(Elf64_Shdr)) return false;
+        Elf64_Shdr shdr;
+        memcpy(&shdr, p, sizeof(shdr));
+        *section = (FFElfSection) { shdr.sh_name, shdr.sh_type, shdr.sh_offset, shdr.sh_size };
+    }
+    else
+    {
+        if (shentsize < sizeof(Elf32_Shdr)) return false;
+        Elf32_Shdr shdr;
+        memcpy(&shdr, p, sizeof(shdr));
+        *section = (FFElfSection) { shdr.sh_name, shdr.sh_type, shdr.sh_offset, shdr.sh_size };
+    }
+    return true;
+}
+
+// Locates `.rodata` using the section headers. Fails for foreign byte orders and images without section headers
+static const char* findRodata(const uint8_t* base, size_t size, uint64_t* offset, uint64_t* length)
+{
+    if (size < EI_NIDENT || memcmp(base, ELFMAG, SELFMAG) != 0)
+        return "Not an ELF file";
+    if (base[EI_DATA] != FF_ELFDATA_NATIVE)
+        return "Unsupported ELF byte order";
+
+    bool is64 = base[EI_CLASS] == ELFCLASS64;
+    uint64_t shoff;
+    uint16_t shentsize, shnum, shstrndx;
+    if (is64)
+    {
+        if (size < sizeof(Elf64_Ehdr)) return "Truncated ELF header";
+        Elf64_Ehdr ehdr;
+        memcpy(&ehdr, base, sizeof(ehdr));
+        shoff = ehdr.e_shoff;
+        shentsize = ehdr.e_shentsize;
+        shnum = ehdr.e_shnum;
+        shstrndx = ehdr.e_shstrndx;
+    }
+    else if (base[EI_CLASS] == ELFCLASS32)
+    {
+        if (size < sizeof(Elf32_Ehdr)) return "Truncated ELF header";
+        Elf32_Ehdr ehdr;
+        memcpy(&ehdr, base, sizeof(ehdr));
+        shoff = ehdr.e_shoff;
+        shentsize = ehdr.e_shentsize;
+        shnum = ehdr.e_shnum;
+        shstrndx = ehdr.e_shstrndx;
+    }
+    else
+        return "Unsupported ELF class";
+
+    if (shoff == 0 || shoff >= size || shentsize == 0 || shnum > (size - shoff) / shentsize || shstrndx >= shnum)
+        return "Invalid or missing ELF section headers";
+
+    FFElfSection strtab;
+    if (!readSection(base, is64, shoff, shentsize, shstrndx, &strtab) ||
+        strtab.offset >= size || strtab.size > size - strtab.offset)
+        return "Invalid ELF section name table";
+
+    for (uint16_t i = 0; i < shnum; ++i)
+    {
+        FFElfSection section;
+        if (!readSection(base, is64, shoff, shentsize, i, &section))
+            return "Invalid ELF section header";
+
+        if (section.type != SHT_PROGBITS || section.name + sizeof(".rodata") > strtab.size)
+            continue;
+        if (memcmp(base + strtab.offset + section.name, ".rodata", sizeof(".rodata")) != 0)
+            continue;
+
+        if (section.offset >= size || section.size > size - section.offset)
+            return "Invalid .rodata section";
+
+        *offset = section.offset;
+        *length = section.size;
+        return NULL;
+    }
+
+    return "No .rodata section";
+}
+
+const char* ffBinaryFindStrings(const char* file, const char* prefix, FFBinaryStringCallback* callback, void* data)
+{
+    FF_AUTO_CLOSE_FD int fd = open(file, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return "open(file) failed";
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < EI_NIDENT)
+        return "Not a regular file";
+
+    size_t size = (size_t) st.st_size;
+    uint8_t* base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED)
+        return "mmap(file) failed";
+
+    uint64_t offset, length;
+    const char* error = findRodata(base, size, &offset, &length);
+    if (error == NULL)
+    {
+        const char* start = (const char*) base + offset;
+        const char* end = start + length;
+        size_t prefixLength = strlen(prefix);
+
+        for (const char* p = start; p < end; )
+        {
+            const char* hit = memmem(p, (size_t) (end - p), prefix, prefixLength);
+            if (!hit) break;
+
+            const char* nul = memchr(hit, '\0', (size_t) (end - hit));
+            if (!nul) break;
+
+            // Only strings starting with `prefix`; not literals that merely contain it
+            if ((hit == start || hit[-1] == '\0') && !callback(hit, (uint32_t) (nul - hit), data))
+                break;
+
+            p = nul + 1;
+        }
+    }
+
+    munmap(base, size);
+    return error;
+}
+
+typedef struct FFBinaryVersionContext
+{
+    const FFBinaryVersionPattern* pattern;
+    FFstrbuf* version;
+} FFBinaryVersionContext;
+
+static bool matchVersion(const char* str, FF_MAYBE_UNUSED uint32_t length, void* data)
+{
+    FFBinaryVersionContext* context = (FFBinaryVersionContext*) data;
+    const FFBinaryVersionPattern* pattern = context->pattern;
+
+    str += strlen(pattern->prefix);
+    if (pattern->skipTo)
+    {
+        str = strstr(str, pattern->skipTo);
+        if (!str) return true;
+        str += strlen(pattern->skipTo);
+    }
+
+    if (*str < '0' || *str > '9')
+        return true;
+
+    size_t versionLength = strcspn(str, pattern->terminators);
+    if (memchr(str, '*', versionLength) || memchr(str, '%', versionLength))
+        return true;
+
+    ffStrbufSetNS(context->version, (uint32_t) versionLength, str);
+    ffStrbufTrimRightSpace(context->version);
+    return false;
+}
+
+bool ffBinaryFindVersion(const char* file, const FFBinaryVersionPattern* pattern, FFstrbuf* version)
+{
+    ffStrbufClear(version);
+    FFBinaryVersionContext context = { pattern, version };
+    if (ffBinaryFindStrings(file, pattern->prefix, matchVersion, &context) != NULL)
+        return false;
+    return version->length > 0;
+}
+
+static void getCachePath(FFstrbuf* path, const char* name)
+{
+    ffStrbufSet(path, &instance.state.platform.cacheDir);
+    ffStrbufAppendS(path, "fastfetch/versions/");
+    ffStrbufAppendS(path, name);
+}
+
+static bool getFileKey(const char* file, FFstrbuf* key)
+{
+    struct stat st;
+    if (stat(file, &st) != 0)
+        return false;
+
+    ffStrbufSetF(key, "%" PRIu64 ":%" PRIu64 ":%lld.%09ld\n",
+        (uint64_t) st.st_dev, (uint64_t) st.st_ino, (long long) st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+    return true;
+}
+
+// Format: <dev>:<inode>:<mtime>\n<version>
+bool ffBinaryVersionCacheRead(const char* name, const char* file, FFstrbuf* version)
+{
+    FF_STRBUF_AUTO_DESTROY key = ffStrbufCreate();
+    if (!getFileKey(file, &key))
+        return false;
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getCachePath(&path, name);
+
+    FF_STRBUF_AUTO_DESTROY cache = ffStrbufCreate();
+    if (!ffReadFileBuffer(path.chars, &cache) || !ffStrbufStartsWith(&cache, &key) || cache.length == key.length)
+        return false;
+
+    ffStrbufSetNS(version, cache.length - key.length, cache.chars + key.length);
+    return true;
+}
+
+void ffBinaryVersionCacheWrite(const char* name, const char* file, const FFstrbuf* version)
+{
+    FF_STRBUF_AUTO_DESTROY cache = ffStrbufCreate();
+    if (version->length == 0 || !getFileKey(file, &cache))
+        return;
+    ffStrbufAppend(&cache, version);
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getCachePath(&path, name);
+    ffWriteFileBufferAtomic(path.chars, &cache);
+}
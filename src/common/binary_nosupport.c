@@ -0,0 +1,24 @@
+#include "binary.h"
+
+const char* ffBinaryFindStrings(const char* file, const char* prefix, FFBinaryStringCallback* callback, void* data)
+{
+    FF_UNUSED(file, prefix, callback, data);
+    return "Not supported on this platform";
+}
+
+bool ffBinaryFindVersion(const char* file, const FFBinaryVersionPattern* pattern, FFstrbuf* version)
+{
+    FF_UNUSED(file, pattern, version);
+    return false;
+}
+
+bool ffBinaryVersionCacheRead(const char* name, const char* file, FFstrbuf* version)
+{
+    FF_UNUSED(name, file, version);
+    return false;
+}
+
+void ffBinaryVersionCacheWrite(const char* name, const char* file, const FFstrbuf* version)
+{
+    FF_UNUSED(name, file, version);
+}
@@ -31,6 +31,12 @@ void ffPrepareCommandOption(FFdata* data)
     if(ffStrbufContainIgnCaseS(&data->structure, FF_CPUUSAGE_MODULE_NAME))
         ffPrepareCPUUsage();
 
+    if(ffStrbufContainIgnCaseS(&data->structure, FF_COMMAND_MODULE_NAME))
+        ffPrepareCommand(&options->command);
+
+    if(ffStrbufContainIgnCaseS(&data->structure, FF_GPU_MODULE_NAME))
+        ffPrepareGPUUsage(&options->gpu);
+
     if(ffStrbufContainIgnCaseS(&data->structure, FF_DISKIO_MODULE_NAME))
         ffPrepareDiskIO(&options->diskIo);
 
@@ -3,6 +3,7 @@
 #ifdef FF_HAVE_DBUS
 
 #include "common/thread.h"
+#include "util/mallocHelper.h"
 #include "util/stringUtils.h"
 
 static bool loadLibSymbols(FFDBusLibrary* lib)
@@ -19,12 +20,12 @@ static bool loadLibSymbols(FFDBusLibrary* lib)
     FF_LIBRARY_LOAD_SYMBOL_PTR(dbus, lib, dbus_message_iter_has_next, false)
     FF_LIBRARY_LOAD_SYMBOL_PTR(dbus, lib, dbus_message_iter_next, false)
     FF_LIBRARY_LOAD_SYMBOL_PTR(dbus, lib, dbus_message_unref, false)
-    FF_LIBRARY_LOAD_SYMBOL_PTR(dbus, lib, dbus_connection_send_with_reply_and_block, false)
+    FF_LIBRARY_LOAD_SYMBOL_PTR(dbus, lib, dbus_message_get_type, false)
+    FF_LIBRARY_LOAD_SYMBOL_PTR(dbus, lib, dbus_connection_send_with_reply, false)
     FF_LIBRARY_LOAD_SYMBOL_PTR(dbus, lib, dbus_connection_flush, false)
     FF_LIBRARY_LOAD_SYMBOL_PTR(dbus, lib, dbus_pending_call_block, false)
     FF_LIBRARY_LOAD_SYMBOL_PTR(dbus, lib, dbus_pending_call_steal_reply, false)
     FF_LIBRARY_LOAD_SYMBOL_PTR(dbus, lib, dbus_pending_call_unref, false)
-    dbus = NULL; // don't auto dlclose
     return true;
 }
 
@@ -45,11 +46,33 @@ static const FFDBusLibrary* loadLib(void)
 
 const char* ffDBusLoadData(DBusBusType busType, FFDBusData* data)
 {
+    // Indexed by DBusBusType. Connections are never closed; libdbus keeps the shared ones open anyway
+    static DBusConnection* connections[DBUS_BUS_STARTER + 1];
+    static bool connected[DBUS_BUS_STARTER + 1];
+    #ifdef FF_HAVE_THREADS
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    #endif
+
+    if((unsigned) busType > DBUS_BUS_STARTER)
+        return "Invalid DBus bus type";
+
     data->lib = loadLib();
     if(data->lib == NULL)
         return "Failed to load DBus library";
 
-    data->connection = data->lib->ffdbus_bus_get(busType, NULL);
+    #ifdef FF_HAVE_THREADS
+    ffThreadMutexLock(&mutex);
+    #endif
+    if(!connected[busType])
+    {
+        connected[busType] = true;
+        connections[busType] = data->lib->ffdbus_bus_get(busType, NULL);
+    }
+    data->connection = connections[busType];
+    #ifdef FF_HAVE_THREADS
+    ffThreadMutexUnlock(&mutex);
+    #endif
+
     if(data->connection == NULL)
         return "Failed to connect to DBus";
 
@@ -140,61 +163,109 @@ bool ffDBusGetByte(FFDBusData* dbus, DBusMessageIter* iter, uint8_t* result)
     return ffDBusGetByte(dbus, &subIter, result);
 }
 
-DBusMessage* ffDBusGetMethodReply(FFDBusData* dbus, const char* busName, const char* objectPath, const char* interface, const char* method)
+static DBusMessage* createMessage(FFDBusData* dbus, const FFDBusCall* call)
 {
-    DBusMessage* message = dbus->lib->ffdbus_message_new_method_call(busName, objectPath, interface, method);
-    if(message == NULL)
-        return NULL;
-
-    DBusMessage* reply = dbus->lib->ffdbus_connection_send_with_reply_and_block(dbus->connection, message, FF_DBUS_TIMEOUT_MILLISECONDS, NULL);
-
-    dbus->lib->ffdbus_message_unref(message);
-
-    return reply;
-}
+    if(call->property == NULL)
+        return dbus->lib->ffdbus_message_new_method_call(call->busName, call->objectPath, call->interface, call->method);
 
-DBusMessage* ffDBusGetProperty(FFDBusData* dbus, const char* busName, const char* objectPath, const char* interface, const char* property)
-{
-    DBusMessage* message = dbus->lib->ffdbus_message_new_method_call(busName, objectPath, "org.freedesktop.DBus.Properties", "Get");
+    DBusMessage* message = dbus->lib->ffdbus_message_new_method_call(call->busName, call->objectPath, "org.freedesktop.DBus.Properties", "Get");
     if(message == NULL)
         return NULL;
 
     DBusMessageIter requestIterator;
     dbus->lib->ffdbus_message_iter_init_append(message, &requestIterator);
 
-    if(!dbus->lib->ffdbus_message_iter_append_basic(&requestIterator, DBUS_TYPE_STRING, &interface))
+    if(
+        !dbus->lib->ffdbus_message_iter_append_basic(&requestIterator, DBUS_TYPE_STRING, &call->interface) ||
+        !dbus->lib->ffdbus_message_iter_append_basic(&requestIterator, DBUS_TYPE_STRING, &call->property)
+    )
     {
         dbus->lib->ffdbus_message_unref(message);
         return NULL;
     }
 
-    if(!dbus->lib->ffdbus_message_iter_append_basic(&requestIterator, DBUS_TYPE_STRING, &property))
+    return message;
+}
+
+void ffDBusCallAll(FFDBusData* dbus, FFDBusCall* calls, uint32_t count)
+{
+    FF_AUTO_FREE DBusPendingCall** pendings = calloc(count, sizeof(*pendings));
+
+    for(uint32_t i = 0; i < count; ++i)
     {
+        calls[i].reply = NULL;
+
+        DBusMessage* message = createMessage(dbus, &calls[i]);
+        if(message == NULL)
+            continue;
+
+        // The timeout starts now, so all calls of a batch share one deadline
+        if(!dbus->lib->ffdbus_connection_send_with_reply(dbus->connection, message, &pendings[i], FF_DBUS_TIMEOUT_MILLISECONDS))
+            pendings[i] = NULL;
         dbus->lib->ffdbus_message_unref(message);
-        return NULL;
     }
 
-    DBusMessage* reply = dbus->lib->ffdbus_connection_send_with_reply_and_block(dbus->connection, message, FF_DBUS_TIMEOUT_MILLISECONDS, NULL);
+    dbus->lib->ffdbus_connection_flush(dbus->connection);
 
-    dbus->lib->ffdbus_message_unref(message);
+    for(uint32_t i = 0; i < count; ++i)
+    {
+        if(pendings[i] == NULL)
+            continue;
+
+        dbus->lib->ffdbus_pending_call_block(pendings[i]);
+        DBusMessage* reply = dbus->lib->ffdbus_pending_call_steal_reply(pendings[i]);
+        dbus->lib->ffdbus_pending_call_unref(pendings[i]);
 
-    return reply;
+        // Timeouts and errors are reported as error messages
+        if(reply != NULL && dbus->lib->ffdbus_message_get_type(reply) != DBUS_MESSAGE_TYPE_METHOD_RETURN)
+        {
+            dbus->lib->ffdbus_message_unref(reply);
+            reply = NULL;
+        }
+        calls[i].reply = reply;
+    }
 }
 
-bool ffDBusGetPropertyString(FFDBusData* dbus, const char* busName, const char* objectPath, const char* interface, const char* property, FFstrbuf* result)
+DBusMessage* ffDBusGetMethodReply(FFDBusData* dbus, const char* busName, const char* objectPath, const char* interface, const char* method)
 {
-    DBusMessage* reply = ffDBusGetProperty(dbus, busName, objectPath, interface, property);
-    if(reply == NULL)
-        return false;
+    FFDBusCall call = {
+        .busName = busName,
+        .objectPath = objectPath,
+        .interface = interface,
+        .method = method,
+    };
+    ffDBusCallAll(dbus, &call, 1);
+    return call.reply;
+}
+
+DBusMessage* ffDBusGetProperty(FFDBusData* dbus, const char* busName, const char* objectPath, const char* interface, const char* property)
+{
+    FFDBusCall call = {
+        .busName = busName,
+        .objectPath = objectPath,
+        .interface = interface,
+        .property = property,
+    };
+    ffDBusCallAll(dbus, &call, 1);
+    return call.reply;
+}
 
+bool ffDBusGetReplyString(FFDBusData* dbus, DBusMessage* reply, FFstrbuf* result)
+{
     DBusMessageIter rootIterator;
     if(!dbus->lib->ffdbus_message_iter_init(reply, &rootIterator))
-    {
-        dbus->lib->ffdbus_message_unref(reply);
         return false;
-    }
 
-    bool ret = ffDBusGetValue(dbus, &rootIterator, result);
+    return ffDBusGetValue(dbus, &rootIterator, result);
+}
+
+bool ffDBusGetPropertyString(FFDBusData* dbus, const char* busName, const char* objectPath, const char* interface, const char* property, FFstrbuf* result)
+{
+    DBusMessage* reply = ffDBusGetProperty(dbus, busName, objectPath, interface, property);
+    if(reply == NULL)
+        return false;
+
+    bool ret = ffDBusGetReplyString(dbus, reply, result);
 
     dbus->lib->ffdbus_message_unref(reply);
 
@@ -29,7 +29,8 @@ typedef struct FFDBusLibrary
     FF_LIBRARY_SYMBOL(dbus_message_iter_has_next)
     FF_LIBRARY_SYMBOL(dbus_message_iter_next)
     FF_LIBRARY_SYMBOL(dbus_message_unref)
-    FF_LIBRARY_SYMBOL(dbus_connection_send_with_reply_and_block)
+    FF_LIBRARY_SYMBOL(dbus_message_get_type)
+    FF_LIBRARY_SYMBOL(dbus_connection_send_with_reply)
     FF_LIBRARY_SYMBOL(dbus_connection_flush)
     FF_LIBRARY_SYMBOL(dbus_pending_call_block)
     FF_LIBRARY_SYMBOL(dbus_pending_call_steal_reply)
@@ -42,12 +43,27 @@ typedef struct FFDBusData
     DBusConnection* connection;
 } FFDBusData;
 
+// A method call of a batch. If `property` is set, `org.freedesktop.DBus.Properties.Get(interface, property)` is called instead of `method`
+typedef struct FFDBusCall
+{
+    const char* busName;
+    const char* objectPath;
+    const char* interface;
+    const char* method;
+    const char* property;
+    DBusMessage* reply; // Set by ffDBusCallAll; NULL if the call failed. Must be unref-ed by the caller
+} FFDBusCall;
+
+// The connection is opened once per bus type and shared by all callers
 const char* ffDBusLoadData(DBusBusType busType, FFDBusData* data); //Returns an error message or NULL on success
+// Sends all calls before waiting for any reply, so that they cost one round trip and one timeout in total
+void ffDBusCallAll(FFDBusData* dbus, FFDBusCall* calls, uint32_t count);
 bool ffDBusGetValue(FFDBusData* dbus, DBusMessageIter* iter, FFstrbuf* result);
 bool ffDBusGetBool(FFDBusData* dbus, DBusMessageIter* iter, bool* result);
 bool ffDBusGetByte(FFDBusData* dbus, DBusMessageIter* iter, uint8_t* result);
 DBusMessage* ffDBusGetMethodReply(FFDBusData* dbus, const char* busName, const char* objectPath, const char* interface, const char* method);
 DBusMessage* ffDBusGetProperty(FFDBusData* dbus, const char* busName, const char* objectPath, const char* interface, const char* property);
+bool ffDBusGetReplyString(FFDBusData* dbus, DBusMessage* reply, FFstrbuf* result); // The first value of `reply`, which is not unref-ed
 bool ffDBusGetPropertyString(FFDBusData* dbus, const char* busName, const char* objectPath, const char* interface, const char* property, FFstrbuf* result);
 
 #endif // FF_HAVE_DBUS
@@ -50,6 +50,14 @@ static inline bool ffWriteFileBuffer(const char* fileName, const FFstrbuf* buffe
     return ffWriteFileData(fileName, buffer->length, buffer->chars);
 }
 
+// Writes to a temporary file and renames it over `fileName`, so that readers never see a partially written file
+bool ffWriteFileDataAtomic(const char* fileName, size_t dataSize, const void* data);
+
+static inline bool ffWriteFileBufferAtomic(const char* fileName, const FFstrbuf* buffer)
+{
+    return ffWriteFileDataAtomic(fileName, buffer->length, buffer->chars);
+}
+
 static inline ssize_t ffReadFDData(FFNativeFD fd, size_t dataSize, void* data)
 {
     #ifndef _WIN32
@@ -74,6 +82,18 @@ static inline bool ffReadFileBuffer(const char* fileName, FFstrbuf* buffer)
     return ffAppendFileBuffer(fileName, buffer);
 }
 
+#ifndef _WIN32
+// Same as above, but `fileName` is relative to the directory `dfd` (openat)
+ssize_t ffReadFileDataRelative(int dfd, const char* fileName, size_t dataSize, void* data);
+bool ffAppendFileBufferRelative(int dfd, const char* fileName, FFstrbuf* buffer);
+
+static inline bool ffReadFileBufferRelative(int dfd, const char* fileName, FFstrbuf* buffer)
+{
+    ffStrbufClear(buffer);
+    return ffAppendFileBufferRelative(dfd, fileName, buffer);
+}
+#endif
+
 //Bit flags, combine with |
 typedef enum FFPathType
 {
@@ -123,6 +143,25 @@ bool ffPathExpandEnv(const char* in, FFstrbuf* out);
 FF_C_SCANF(2, 3)
 const char* ffGetTerminalResponse(const char* request, const char* format, ...);
 
+typedef struct FFTerminalQuery
+{
+    const char* request; // e.g. "\e[14t"
+    const char* format; // scanf format of the reply, e.g. "\e[4;%hu;%hut". Its literal prefix and last char identify the reply
+    void* args[4]; // Arguments of `format`
+    bool answered; // Set if the reply was found and parsed
+} FFTerminalQuery;
+
+// Sends all requests in one write, followed by a DA1 request (`\e[c`) that every terminal answers, and reads until the DA1 reply arrives.
+// Terminals answer in order, so a query the terminal doesn't support costs nothing but its unanswered slot.
+// Fails only if nothing could be read within FF_IO_TERM_RESP_WAIT_MS
+const char* ffGetTerminalResponses(FFTerminalQuery* queries, uint32_t count);
+
+#ifndef _WIN32
+struct winsize;
+// Fills the members of `winsize` that are 0 (e.g. pixels not reported by TIOCGWINSZ) with `\e[18t` and `\e[14t`, in one round trip
+void ffGetTerminalWinsize(struct winsize* winsize);
+#endif
+
 // Not thread safe!
 bool ffSuppressIO(bool suppress);
 
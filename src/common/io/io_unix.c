@@ -1,9 +1,11 @@
 #include "io.h"
 #include "fastfetch.h"
+#include "common/time.h"
 #include "util/stringUtils.h"
 
 #include <fcntl.h>
 #include <termios.h>
+#include <sys/ioctl.h>
 #include <poll.h>
 #include <dirent.h>
 #include <errno.h>
@@ -47,6 +49,32 @@ bool ffWriteFileData(const char* fileName, size_t dataSize, const void* data)
     return write(fd, data, dataSize) > 0;
 }
 
+bool ffWriteFileDataAtomic(const char* fileName, size_t dataSize, const void* data)
+{
+    // Written next to the target, so that rename(2) replaces it in one step
+    FF_STRBUF_AUTO_DESTROY tmpPath = ffStrbufCreateF("%s.XXXXXX", fileName);
+
+    int FF_AUTO_CLOSE_FD fd = mkostemp(tmpPath.chars, O_CLOEXEC);
+    if(fd == -1)
+    {
+        if (errno != ENOENT)
+            return false;
+        createSubfolders(fileName);
+        ffStrbufSetF(&tmpPath, "%s.XXXXXX", fileName); // The template may have been modified
+        fd = mkostemp(tmpPath.chars, O_CLOEXEC);
+        if(fd == -1)
+            return false;
+    }
+
+    fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (write(fd, data, dataSize) != (ssize_t) dataSize || rename(tmpPath.chars, fileName) != 0)
+    {
+        unlink(tmpPath.chars);
+        return false;
+    }
+    return true;
+}
+
 static inline void readWithLength(int fd, FFstrbuf* buffer, uint32_t length)
 {
     ffStrbufEnsureFixedLengthFree(buffer, length);
@@ -108,6 +136,24 @@ bool ffAppendFileBuffer(const char* fileName, FFstrbuf* buffer)
     return ffAppendFDBuffer(fd, buffer);
 }
 
+ssize_t ffReadFileDataRelative(int dfd, const char* fileName, size_t dataSize, void* data)
+{
+    int FF_AUTO_CLOSE_FD fd = openat(dfd, fileName, O_RDONLY | O_CLOEXEC);
+    if(fd == -1)
+        return -1;
+
+    return ffReadFDData(fd, dataSize, data);
+}
+
+bool ffAppendFileBufferRelative(int dfd, const char* fileName, FFstrbuf* buffer)
+{
+    int FF_AUTO_CLOSE_FD fd = openat(dfd, fileName, O_RDONLY | O_CLOEXEC);
+    if(fd == -1)
+        return false;
+
+    return ffAppendFDBuffer(fd, buffer);
+}
+
 bool ffPathExpandEnv(FF_MAYBE_UNUSED const char* in, FF_MAYBE_UNUSED FFstrbuf* out)
 {
     bool result = false;
@@ -131,7 +177,59 @@ bool ffPathExpandEnv(FF_MAYBE_UNUSED const char* in, FF_MAYBE_UNUSED FFstrbuf* o
     return result;
 }
 
-const char* ffGetTerminalResponse(const char* request, const char* format, ...)
+// Length of the escape sequence at `p`: CSI (`\e[` params final), or OSC / DCS / APC terminated by BEL or ST.
+// 0 if it is incomplete, i.e. more input is needed
+static uint32_t getEscapeSequenceLength(const char* p, const char* end)
+{
+    // Compare as unsigned: bytes >= 0x80 must not be taken for the ranges below
+    const unsigned char* s = (const unsigned char*) p;
+    const unsigned char* e = (const unsigned char*) end;
+    if (e - s < 2 || s[0] != '\e')
+        return 0;
+
+    const unsigned char* q = s + 2;
+    if (s[1] == '[')
+    {
+        while (q < e && *q >= 0x20 && *q <= 0x3F) ++q;
+        if (q == e)
+            return 0;
+        // A malformed sequence ends before the unexpected byte; skip it rather than wait for more input
+        return (uint32_t) (q - s) + (*q >= 0x40 && *q <= 0x7E);
+    }
+    if (s[1] == ']' || s[1] == 'P' || s[1] == '_')
+    {
+        for (; q < e; ++q)
+        {
+            if (*q == '\a') return (uint32_t) (q - s + 1);
+            if (*q == '\e' && q + 1 < e && q[1] == '\\') return (uint32_t) (q - s + 2);
+        }
+        return 0;
+    }
+    return 2;
+}
+
+// Calls `callback` for every complete escape sequence in `replies`. Returns false if it stopped the iteration
+static bool forEachReply(const FFstrbuf* replies, bool (*callback)(const char* reply, uint32_t length, void* data), void* data)
+{
+    const char* end = replies->chars + replies->length;
+    for (const char* p = replies->chars; (p = memchr(p, '\e', (size_t) (end - p))) != NULL; )
+    {
+        uint32_t length = getEscapeSequenceLength(p, end);
+        if (length == 0) break;
+        if (!callback(p, length, data)) return false;
+        p += length;
+    }
+    return true;
+}
+
+static bool isNotDA1Reply(const char* reply, uint32_t length, FF_MAYBE_UNUSED void* data)
+{
+    // \e[?<attributes>c
+    return !(length >= 4 && reply[1] == '[' && reply[2] == '?' && reply[length - 1] == 'c');
+}
+
+// Writes `requests` followed by DA1 in raw mode, and collects the replies until the DA1 reply
+static const char* queryTerminal(const char* requests, FFstrbuf* replies)
 {
     if (instance.config.display.pipe)
         return "Not supported in --pipe mode";
@@ -145,34 +243,140 @@ const char* ffGetTerminalResponse(const char* request, const char* format, ...)
     if(tcsetattr(STDIN_FILENO, TCSANOW, &newTerm) == -1)
         return "tcsetattr(STDIN_FILENO, TCSANOW, &newTerm)";
 
-    fputs(request, stdout);
+    fputs(requests, stdout);
+    fputs("\e[c", stdout);
     fflush(stdout);
 
-    //Give the terminal 35ms to respond
-    if(poll(&(struct pollfd) { .fd = STDIN_FILENO, .events = POLLIN }, 1, FF_IO_TERM_RESP_WAIT_MS) <= 0)
+    //Give the terminal 100ms to respond, unless the DA1 reply tells us it's done earlier
+    uint64_t deadline = ffTimeGetTick() + FF_IO_TERM_RESP_WAIT_MS;
+    while (true)
     {
-        tcsetattr(STDIN_FILENO, TCSANOW, &oldTerm);
+        uint64_t now = ffTimeGetTick();
+        if (now >= deadline ||
+            poll(&(struct pollfd) { .fd = STDIN_FILENO, .events = POLLIN }, 1, (int) (deadline - now)) <= 0)
+            break;
+
+        ffStrbufEnsureFree(replies, 511);
+        ssize_t bytesRead = read(STDIN_FILENO, replies->chars + replies->length, ffStrbufGetFree(replies));
+        if (bytesRead <= 0)
+            break;
+        replies->length += (uint32_t) bytesRead;
+        replies->chars[replies->length] = '\0';
+
+        if (!forEachReply(replies, isNotDA1Reply, NULL))
+            break;
+    }
+
+    tcsetattr(STDIN_FILENO, TCSANOW, &oldTerm);
+
+    if (replies->length == 0)
         return "poll() timeout or failed";
+    return NULL;
+}
+
+typedef struct FFTerminalReplyMatch
+{
+    const char* format;
+    uint32_t skip; // Number of matching replies that belong to earlier queries
+    FFstrbuf* reply;
+} FFTerminalReplyMatch;
+
+static bool matchReply(const char* reply, uint32_t length, void* data)
+{
+    FFTerminalReplyMatch* match = data;
+
+    size_t prefixLength = strcspn(match->format, "%");
+    size_t formatLength = strlen(match->format);
+    if (length <= prefixLength || memcmp(reply, match->format, prefixLength) != 0)
+        return true;
+    // CSI replies are told apart by their final byte. OSC replies may be terminated by BEL instead of ST
+    if (match->format[1] == '[' && reply[length - 1] != match->format[formatLength - 1])
+        return true;
+
+    if (match->skip > 0)
+    {
+        --match->skip;
+        return true;
     }
 
-    char buffer[512];
-    ssize_t bytesRead = read(STDIN_FILENO, buffer, sizeof(buffer) - 1);
+    ffStrbufSetNS(match->reply, length, reply);
+    return false;
+}
 
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldTerm);
+// The reply to the query with the given format, skipping `skip` replies of the same kind
+static bool findReply(const FFstrbuf* replies, const char* format, uint32_t skip, FFstrbuf* reply)
+{
+    FFTerminalReplyMatch match = { format, skip, reply };
+    return !forEachReply(replies, matchReply, &match);
+}
 
-    if(bytesRead <= 0)
-        return "read(STDIN_FILENO, buffer, sizeof(buffer) - 1) failed";
+const char* ffGetTerminalResponse(const char* request, const char* format, ...)
+{
+    FF_STRBUF_AUTO_DESTROY replies = ffStrbufCreate();
+    const char* error = queryTerminal(request, &replies);
+    if (error)
+        return error;
 
-    buffer[bytesRead] = '\0';
+    FF_STRBUF_AUTO_DESTROY reply = ffStrbufCreate();
+    if (!findReply(&replies, format, 0, &reply))
+        return "No matching terminal response";
 
     va_list args;
     va_start(args, format);
-    vsscanf(buffer, format, args);
+    vsscanf(reply.chars, format, args);
     va_end(args);
 
     return NULL;
 }
 
+const char* ffGetTerminalResponses(FFTerminalQuery* queries, uint32_t count)
+{
+    FF_STRBUF_AUTO_DESTROY requests = ffStrbufCreate();
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        queries[i].answered = false;
+        ffStrbufAppendS(&requests, queries[i].request);
+    }
+
+    FF_STRBUF_AUTO_DESTROY replies = ffStrbufCreate();
+    const char* error = queryTerminal(requests.chars, &replies);
+    if (error)
+        return error;
+
+    FF_STRBUF_AUTO_DESTROY reply = ffStrbufCreate();
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        FFTerminalQuery* query = &queries[i];
+
+        // Earlier queries whose replies look the same, e.g. OSC 10 and OSC 11
+        uint32_t skip = 0;
+        for (uint32_t j = 0; j < i; ++j)
+        {
+            if (queries[j].answered && strcmp(queries[j].format, query->format) == 0)
+                ++skip;
+        }
+
+        if (findReply(&replies, query->format, skip, &reply))
+            query->answered = sscanf(reply.chars, query->format, query->args[0], query->args[1], query->args[2], query->args[3]) > 0;
+    }
+
+    return NULL;
+}
+
+void ffGetTerminalWinsize(struct winsize* winsize)
+{
+    FFTerminalQuery queries[2];
+    uint32_t count = 0;
+
+    if (winsize->ws_row == 0 || winsize->ws_col == 0)
+        queries[count++] = (FFTerminalQuery) { .request = "\e[18t", .format = "\e[8;%hu;%hut", .args = { &winsize->ws_row, &winsize->ws_col } };
+    if (winsize->ws_ypixel == 0 || winsize->ws_xpixel == 0)
+        queries[count++] = (FFTerminalQuery) { .request = "\e[14t", .format = "\e[4;%hu;%hut", .args = { &winsize->ws_ypixel, &winsize->ws_xpixel } };
+
+    if (count > 0)
+        ffGetTerminalResponses(queries, count);
+}
+
 bool ffSuppressIO(bool suppress)
 {
     static bool init = false;
@@ -36,6 +36,20 @@ bool ffWriteFileData(const char* fileName, size_t dataSize, const void* data)
     return !!WriteFile(handle, data, (DWORD)dataSize, &written, NULL);
 }
 
+bool ffWriteFileDataAtomic(const char* fileName, size_t dataSize, const void* data)
+{
+    FF_STRBUF_AUTO_DESTROY tmpPath = ffStrbufCreateF("%s.%lu.%lu", fileName, GetCurrentProcessId(), GetCurrentThreadId());
+    if (!ffWriteFileData(tmpPath.chars, dataSize, data))
+        return false;
+
+    if (!MoveFileExA(tmpPath.chars, fileName, MOVEFILE_REPLACE_EXISTING))
+    {
+        DeleteFileA(tmpPath.chars);
+        return false;
+    }
+    return true;
+}
+
 static inline void readWithLength(HANDLE handle, FFstrbuf* buffer, uint32_t length)
 {
     ffStrbufEnsureFixedLengthFree(buffer, length);
@@ -173,7 +187,7 @@ void ffListFilesRecursively(const char* path, bool pretty)
     listFilesRecursively(folder.length, &folder, 0, NULL, pretty);
 }
 
-const char* ffGetTerminalResponse(const char* request, const char* format, ...)
+static const char* queryTerminal(const char* request, char* buffer, DWORD size)
 {
     if (instance.config.display.pipe)
         return "Not supported in --pipe mode";
@@ -212,9 +226,8 @@ const char* ffGetTerminalResponse(const char* request, const char* format, ...)
             ReadConsoleInputW(hInput, &record, 1, &len);
     }
 
-    char buffer[512];
     bytes = 0;
-    ReadFile(hInput, buffer, sizeof(buffer) - 1, &bytes, NULL);
+    ReadFile(hInput, buffer, size - 1, &bytes, NULL);
 
     SetConsoleMode(hInput, prev_mode);
 
@@ -222,6 +235,15 @@ const char* ffGetTerminalResponse(const char* request, const char* format, ...)
         return "ReadFile() failed";
 
     buffer[bytes] = '\0';
+    return NULL;
+}
+
+const char* ffGetTerminalResponse(const char* request, const char* format, ...)
+{
+    char buffer[512];
+    const char* error = queryTerminal(request, buffer, sizeof(buffer));
+    if (error)
+        return error;
 
     va_list args;
     va_start(args, format);
@@ -230,3 +252,20 @@ const char* ffGetTerminalResponse(const char* request, const char* format, ...)
 
     return NULL;
 }
+
+const char* ffGetTerminalResponses(FFTerminalQuery* queries, uint32_t count)
+{
+    // The console input is read per reply here; there is no round trip to save on Windows
+    const char* error = NULL;
+    bool answered = false;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        FFTerminalQuery* query = &queries[i];
+        char buffer[512];
+        error = queryTerminal(query->request, buffer, sizeof(buffer));
+        query->answered = error == NULL &&
+            sscanf(buffer, query->format, query->args[0], query->args[1], query->args[2], query->args[3]) > 0;
+        answered |= query->answered;
+    }
+    return answered ? NULL : error;
+}
@@ -117,6 +117,29 @@ static bool parseModuleJsonObject(const char* type, yyjson_val* jsonVal, yyjson_
     return false;
 }
 
+// Commands, public IPs and weathers are usually used several times with different options, and every instance starts its own work.
+// The prepare pass parses them into copies, so that the print pass starts from the same options as this pass
+static struct
+{
+    FFCommandOptions command;
+    FFPublicIpOptions publicIp;
+    FFWeatherOptions weather;
+    bool commandInited;
+    bool publicIpInited;
+    bool weatherInited;
+} prepareOptions;
+
+static void destroyPrepareOptions(void)
+{
+    if (prepareOptions.commandInited)
+        ffDestroyCommandOptions(&prepareOptions.command);
+    if (prepareOptions.publicIpInited)
+        ffDestroyPublicIpOptions(&prepareOptions.publicIp);
+    if (prepareOptions.weatherInited)
+        ffDestroyWeatherOptions(&prepareOptions.weather);
+    prepareOptions.commandInited = prepareOptions.publicIpInited = prepareOptions.weatherInited = false;
+}
+
 static void prepareModuleJsonObject(const char* type, yyjson_val* module)
 {
     FFconfig* cfg = &instance.config;
@@ -127,6 +150,23 @@ static void prepareModuleJsonObject(const char* type, yyjson_val* module)
                 ffPrepareCPUUsage();
             break;
         }
+        case 'c': case 'C': {
+            if (ffStrEqualsIgnCase(type, FF_COMMAND_MODULE_NAME))
+            {
+                FFCommandOptions* options = &prepareOptions.command;
+                if (!prepareOptions.commandInited)
+                {
+                    ffInitCommandOptions(options);
+                    ffStrbufSet(&options->shell, &cfg->modules.command.shell);
+                    ffStrbufSet(&options->text, &cfg->modules.command.text);
+                    options->cacheTtl = cfg->modules.command.cacheTtl;
+                    prepareOptions.commandInited = true;
+                }
+                if (module) options->moduleInfo.parseJsonObject(options, module);
+                ffPrepareCommand(options);
+            }
+            break;
+        }
         case 'd': case 'D': {
             if (ffStrEqualsIgnCase(type, FF_DISKIO_MODULE_NAME))
             {
@@ -135,6 +175,14 @@ static void prepareModuleJsonObject(const char* type, yyjson_val* module)
             }
             break;
         }
+        case 'g': case 'G': {
+            if (ffStrEqualsIgnCase(type, FF_GPU_MODULE_NAME))
+            {
+                if (module) cfg->modules.gpu.moduleInfo.parseJsonObject(&cfg->modules.gpu, module);
+                ffPrepareGPUUsage(&cfg->modules.gpu);
+            }
+            break;
+        }
         case 'n': case 'N': {
             if (ffStrEqualsIgnCase(type, FF_NETIO_MODULE_NAME))
             {
@@ -146,16 +194,38 @@ static void prepareModuleJsonObject(const char* type, yyjson_val* module)
         case 'p': case 'P': {
             if (ffStrEqualsIgnCase(type, FF_PUBLICIP_MODULE_NAME))
             {
-                if (module) cfg->modules.publicIP.moduleInfo.parseJsonObject(&cfg->modules.publicIP, module);
-                ffPreparePublicIp(&cfg->modules.publicIP);
+                FFPublicIpOptions* options = &prepareOptions.publicIp;
+                if (!prepareOptions.publicIpInited)
+                {
+                    ffInitPublicIpOptions(options);
+                    ffStrbufSet(&options->url, &cfg->modules.publicIP.url);
+                    options->timeout = cfg->modules.publicIP.timeout;
+                    options->ipv6 = cfg->modules.publicIP.ipv6;
+                    options->cacheTtl = cfg->modules.publicIP.cacheTtl;
+                    options->cacheRefresh = cfg->modules.publicIP.cacheRefresh;
+                    prepareOptions.publicIpInited = true;
+                }
+                if (module) options->moduleInfo.parseJsonObject(options, module);
+                ffPreparePublicIp(options);
             }
             break;
         }
         case 'w': case 'W': {
             if (ffStrEqualsIgnCase(type, FF_WEATHER_MODULE_NAME))
             {
-                if (module) cfg->modules.weather.moduleInfo.parseJsonObject(&cfg->modules.weather, module);
-                ffPrepareWeather(&cfg->modules.weather);
+                FFWeatherOptions* options = &prepareOptions.weather;
+                if (!prepareOptions.weatherInited)
+                {
+                    ffInitWeatherOptions(options);
+                    ffStrbufSet(&options->location, &cfg->modules.weather.location);
+                    ffStrbufSet(&options->outputFormat, &cfg->modules.weather.outputFormat);
+                    options->timeout = cfg->modules.weather.timeout;
+                    options->cacheTtl = cfg->modules.weather.cacheTtl;
+                    options->cacheRefresh = cfg->modules.weather.cacheRefresh;
+                    prepareOptions.weatherInited = true;
+                }
+                if (module) options->moduleInfo.parseJsonObject(options, module);
+                ffPrepareWeather(options);
             }
             break;
         }
@@ -231,6 +301,8 @@ static const char* printJsonConfig(bool prepare, yyjson_mut_doc* jsonDoc)
 void ffPrintJsonConfig(bool prepare, yyjson_mut_doc* jsonDoc)
 {
     const char* error = printJsonConfig(prepare, jsonDoc);
+    if (prepare)
+        destroyPrepareOptions();
     if (error)
     {
         if (jsonDoc)
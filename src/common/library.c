@@ -1,5 +1,7 @@
 #include "fastfetch.h"
 #include "common/library.h"
+#include "common/thread.h"
+#include "common/io/io.h"
 
 #include <stdarg.h>
 
@@ -18,17 +20,82 @@
     #endif
 #endif
 
-static void* libraryLoad(const char* path, int maxVersion)
+// Every library name is opened at most once per process. Handles are shared by all detectors
+// and never closed; failed names are remembered as well so they aren't probed again
+typedef struct FFLibraryEntry
+{
+    FFstrbuf name;
+    void* handle;
+} FFLibraryEntry;
+
+static FFlist libraries = { .elementSize = sizeof(FFLibraryEntry) };
+#ifdef FF_HAVE_THREADS
+static FFThreadMutex librariesMutex = FF_THREAD_MUTEX_INITIALIZER;
+#endif
+
+static FFLibraryEntry* findLibrary(const char* name)
+{
+    FF_LIST_FOR_EACH(FFLibraryEntry, entry, libraries)
+    {
+        if (ffStrbufEqualS(&entry->name, name))
+            return entry;
+    }
+    return NULL;
+}
+
+#ifndef _WIN32
+
+// The versioned file name that was found by probing, e.g. `libdbus-1.so` => `libdbus-1.so.3`
+static void getSonameCachePath(FFstrbuf* path, const char* name)
 {
-    void* result = dlopen(path, FF_DLOPEN_FLAGS);
+    ffStrbufSet(path, &instance.state.platform.cacheDir);
+    ffStrbufAppendS(path, "fastfetch/libraries/");
+    ffStrbufAppendS(path, name);
+}
 
+static void* libraryLoadCached(const char* name)
+{
+    if (instance.state.platform.cacheDir.length == 0)
+        return NULL;
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getSonameCachePath(&path, name);
+
+    FF_STRBUF_AUTO_DESTROY soname = ffStrbufCreate();
+    if (!ffReadFileBuffer(path.chars, &soname) || soname.length == 0)
+        return NULL;
+
+    // May fail if the library has been upgraded or removed; it's probed again then
+    return dlopen(soname.chars, FF_DLOPEN_FLAGS);
+}
+
+static void libraryWriteCache(const char* name, const FFstrbuf* soname)
+{
+    if (instance.state.platform.cacheDir.length == 0)
+        return;
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getSonameCachePath(&path, name);
+    ffWriteFileBufferAtomic(path.chars, soname);
+}
+
+#endif
+
+static void* libraryLoad(const char* path, int maxVersion)
+{
     #ifdef _WIN32
 
     // libX.dll.1 never exists on Windows, while libX-1.dll may exist
     FF_UNUSED(maxVersion)
+    return dlopen(path, FF_DLOPEN_FLAGS);
 
     #else
 
+    void* result = maxVersion >= 0 ? libraryLoadCached(path) : NULL;
+    if (result != NULL)
+        return result;
+
+    result = dlopen(path, FF_DLOPEN_FLAGS);
     if(result != NULL || maxVersion < 0)
         return result;
 
@@ -43,37 +110,63 @@ static void* libraryLoad(const char* path, int maxVersion)
 
         result = dlopen(pathbuf.chars, FF_DLOPEN_FLAGS);
         if(result != NULL)
+        {
+            libraryWriteCache(path, &pathbuf);
             break;
+        }
 
         ffStrbufSubstrBefore(&pathbuf, originalLength);
     }
 
+    return result;
+
     #endif
+}
 
-    return result;
+// Must be called with `librariesMutex` held
+static void* libraryGet(const char* path, int maxVersion)
+{
+    FFLibraryEntry* entry = findLibrary(path);
+    if (entry == NULL)
+    {
+        entry = ffListAdd(&libraries);
+        ffStrbufInitS(&entry->name, path);
+        entry->handle = libraryLoad(path, maxVersion);
+    }
+    return entry->handle;
 }
 
 void* ffLibraryLoad(const FFstrbuf* userProvidedName, ...)
 {
-    if(userProvidedName != NULL && userProvidedName->length > 0)
-        return dlopen(userProvidedName->chars, FF_DLOPEN_FLAGS);
-
-    va_list defaultNames;
-    va_start(defaultNames, userProvidedName);
-
     void* result = NULL;
 
-    while(result == NULL)
+    #ifdef FF_HAVE_THREADS
+    ffThreadMutexLock(&librariesMutex);
+    #endif
+
+    if(userProvidedName != NULL && userProvidedName->length > 0)
+        result = libraryGet(userProvidedName->chars, -1);
+    else
     {
-        const char* path = va_arg(defaultNames, const char*);
-        if(path == NULL)
-            break;
+        va_list defaultNames;
+        va_start(defaultNames, userProvidedName);
+
+        while(result == NULL)
+        {
+            const char* path = va_arg(defaultNames, const char*);
+            if(path == NULL)
+                break;
 
-        int maxVersion = va_arg(defaultNames, int);
-        result = libraryLoad(path, maxVersion);
+            int maxVersion = va_arg(defaultNames, int);
+            result = libraryGet(path, maxVersion);
+        }
+
+        va_end(defaultNames);
     }
 
-    va_end(defaultNames);
+    #ifdef FF_HAVE_THREADS
+    ffThreadMutexUnlock(&librariesMutex);
+    #endif
 
     return result;
 }
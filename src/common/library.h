@@ -21,18 +21,11 @@
     #define FF_LIBRARY_EXTENSION ".so"
 #endif
 
-static inline void ffLibraryUnload(void** handle)
-{
-    assert(handle);
-    if (*handle)
-        dlclose(*handle);
-}
-
 #define FF_LIBRARY_SYMBOL(symbolName) \
     __typeof__(&symbolName) ff ## symbolName;
 
 #define FF_LIBRARY_LOAD(libraryObjectName, userLibraryName, returnValue, ...) \
-    void* __attribute__((__cleanup__(ffLibraryUnload))) libraryObjectName = ffLibraryLoad(userLibraryName, __VA_ARGS__, NULL);\
+    void* libraryObjectName = ffLibraryLoad(userLibraryName, __VA_ARGS__, NULL);\
     if(libraryObjectName == NULL) \
         return returnValue;
 
@@ -70,4 +63,5 @@ static inline void ffLibraryUnload(void** handle)
 #define FF_LIBRARY_LOAD_SYMBOL_PTR(library, varName, symbolName, returnValue) \
     FF_LIBRARY_LOAD_SYMBOL_ADDRESS(library, (varName)->ff ## symbolName, symbolName, returnValue);
 
+// Returns a handle shared by all callers loading the same library. It must not be dlclose'd
 void* ffLibraryLoad(const FFstrbuf* userProvidedName, ...);
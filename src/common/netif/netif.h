@@ -7,3 +7,37 @@ const char* ffNetifGetDefaultRouteIfName();
 #endif
 
 uint32_t ffNetifGetDefaultRouteIfIndex();
+
+#ifdef __linux__
+#include <net/if.h>
+
+struct nlmsghdr;
+
+typedef struct FFNetifAddress
+{
+    uint8_t family; // AF_INET or AF_INET6
+    uint8_t prefixLength;
+    uint8_t addr[16];
+} FFNetifAddress;
+
+typedef struct FFNetifInterface
+{
+    uint32_t index;
+    char name[IF_NAMESIZE + 1];
+    uint32_t flags; // IFF_*
+    uint8_t operState; // IF_OPER_*
+    uint8_t macLength; // 0 if the link has no hardware address
+    uint8_t mac[6];
+    FFlist addresses; // List of FFNetifAddress
+} FFNetifInterface;
+
+// Called for every message of a netlink dump. Returning false stops the dump
+typedef bool FFNetifNetlinkCallback(struct nlmsghdr* nlh, void* data);
+
+// Sends a NETLINK_ROUTE dump request (RTM_GETLINK, RTM_GETADDR, RTM_GETROUTE, ...) and feeds the replies to `callback`
+const char* ffNetifNetlinkDump(uint16_t type, uint8_t family, FFNetifNetlinkCallback* callback, void* data);
+
+// All links and their addresses, gathered with one RTM_GETLINK and one RTM_GETADDR dump and cached.
+// Returns NULL if netlink is not usable (e.g. restricted on Android)
+const FFlist* ffNetifGetInterfaces(void);
+#endif
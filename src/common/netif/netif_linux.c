@@ -3,11 +3,167 @@
 
 #include <net/if.h>
 #include <stdio.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+#include <linux/if_addr.h>
+#include <sys/socket.h>
 
 #define FF_STR_INDIR(x) #x
 #define FF_STR(x) FF_STR_INDIR(x)
 
-bool ffNetifGetDefaultRouteImpl(char iface[IF_NAMESIZE + 1], uint32_t* ifIndex)
+// From <linux/if.h>, which conflicts with <net/if.h>
+#ifndef IF_OPER_UP
+    #define IF_OPER_UNKNOWN 0
+    #define IF_OPER_UP 6
+#endif
+
+// RTA_NEXT mixes signed and unsigned arithmetic
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+
+const char* ffNetifNetlinkDump(uint16_t type, uint8_t family, FFNetifNetlinkCallback* callback, void* data)
+{
+    FF_AUTO_CLOSE_FD int sock = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (sock < 0)
+        return "socket(AF_NETLINK) failed";
+
+    // All request headers start with the address family
+    struct {
+        struct nlmsghdr nlh;
+        union {
+            struct rtgenmsg gen;
+            struct ifinfomsg ifi;
+            struct ifaddrmsg ifa;
+            struct rtmsg rtm;
+        };
+    } request = {
+        .nlh = {
+            .nlmsg_type = type,
+            .nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP,
+            .nlmsg_seq = 1,
+        },
+        .gen = {
+            .rtgen_family = family,
+        },
+    };
+
+    switch (type)
+    {
+        case RTM_GETLINK: request.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg)); break;
+        case RTM_GETADDR: request.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifaddrmsg)); break;
+        case RTM_GETROUTE: request.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg)); break;
+        default: request.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtgenmsg)); break;
+    }
+
+    if (send(sock, &request, request.nlh.nlmsg_len, 0) < 0)
+        return "send(netlink) failed";
+
+    // Large enough for several messages per recv; the kernel never splits a message
+    uint8_t __attribute__((aligned(NLMSG_ALIGNTO))) buffer[32768];
+
+    while (true)
+    {
+        ssize_t received = recv(sock, buffer, sizeof(buffer), 0);
+        if (received < 0)
+            return "recv(netlink) failed";
+
+        uint32_t len = (uint32_t) received;
+        for (struct nlmsghdr* nlh = (struct nlmsghdr*) buffer; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len))
+        {
+            if (nlh->nlmsg_type == NLMSG_DONE)
+                return NULL;
+
+            if (nlh->nlmsg_type == NLMSG_ERROR)
+                return "netlink dump returned an error";
+
+            if (!callback(nlh, data))
+                return NULL;
+        }
+    }
+}
+
+typedef struct FFNetifDefaultRoute
+{
+    uint32_t ifIndex;
+    uint32_t priority;
+    uint8_t family;
+} FFNetifDefaultRoute;
+
+static bool parseRoute(struct nlmsghdr* nlh, void* data)
+{
+    if (nlh->nlmsg_type != RTM_NEWROUTE)
+        return true;
+
+    struct rtmsg* rtm = (struct rtmsg*) NLMSG_DATA(nlh);
+    if (rtm->rtm_dst_len != 0 || rtm->rtm_type != RTN_UNICAST || (rtm->rtm_family != AF_INET && rtm->rtm_family != AF_INET6))
+        return true;
+
+    uint32_t table = rtm->rtm_table, ifIndex = 0, priority = 0;
+
+    int len = (int) RTM_PAYLOAD(nlh);
+    for (struct rtattr* rta = RTM_RTA(rtm); RTA_OK(rta, len); rta = RTA_NEXT(rta, len))
+    {
+        switch (rta->rta_type)
+        {
+            case RTA_TABLE:
+                table = *(const uint32_t*) RTA_DATA(rta);
+                break;
+            case RTA_OIF:
+                ifIndex = *(const uint32_t*) RTA_DATA(rta);
+                break;
+            case RTA_PRIORITY:
+                priority = *(const uint32_t*) RTA_DATA(rta);
+                break;
+            case RTA_MULTIPATH:
+                // ECMP default route; use its first hop
+                if (ifIndex == 0 && RTA_PAYLOAD(rta) >= sizeof(struct rtnexthop))
+                    ifIndex = (uint32_t) ((const struct rtnexthop*) RTA_DATA(rta))->rtnh_ifindex;
+                break;
+        }
+    }
+
+    if (table != RT_TABLE_MAIN || ifIndex == 0)
+        return true;
+
+    // Prefer IPv4 like `/proc/net/route` did, then the route with the lowest metric
+    FFNetifDefaultRoute* best = (FFNetifDefaultRoute*) data;
+    if (best->ifIndex == 0 ||
+        (rtm->rtm_family == AF_INET && best->family != AF_INET) ||
+        (rtm->rtm_family == best->family && priority < best->priority))
+    {
+        best->ifIndex = ifIndex;
+        best->priority = priority;
+        best->family = rtm->rtm_family;
+    }
+    return true;
+}
+
+static bool getDefaultRouteNetlink(char iface[IF_NAMESIZE + 1], uint32_t* ifIndex)
+{
+    // IPv4 and IPv6 routes in a single dump
+    FFNetifDefaultRoute best = {};
+    if (ffNetifNetlinkDump(RTM_GETROUTE, AF_UNSPEC, parseRoute, &best) != NULL || best.ifIndex == 0)
+        return false;
+
+    const FFlist* interfaces = ffNetifGetInterfaces();
+    if (interfaces)
+    {
+        FF_LIST_FOR_EACH(FFNetifInterface, inf, *interfaces)
+        {
+            if (inf->index != best.ifIndex) continue;
+            strcpy(iface, inf->name);
+            *ifIndex = best.ifIndex;
+            return true;
+        }
+    }
+
+    if (!if_indextoname(best.ifIndex, iface))
+        return false;
+    *ifIndex = best.ifIndex;
+    return true;
+}
+
+static bool getDefaultRouteProcNetRoute(char iface[IF_NAMESIZE + 1], uint32_t* ifIndex)
 {
     FILE* FF_AUTO_CLOSE_FILE netRoute = fopen("/proc/net/route", "r");
     if (!netRoute) return false;
@@ -26,3 +182,104 @@ bool ffNetifGetDefaultRouteImpl(char iface[IF_NAMESIZE + 1], uint32_t* ifIndex)
     }
     return false;
 }
+
+bool ffNetifGetDefaultRouteImpl(char iface[IF_NAMESIZE + 1], uint32_t* ifIndex)
+{
+    return getDefaultRouteNetlink(iface, ifIndex) || getDefaultRouteProcNetRoute(iface, ifIndex);
+}
+
+static bool parseLink(struct nlmsghdr* nlh, void* data)
+{
+    if (nlh->nlmsg_type != RTM_NEWLINK)
+        return true;
+
+    struct ifinfomsg* ifi = (struct ifinfomsg*) NLMSG_DATA(nlh);
+
+    FFNetifInterface* inf = (FFNetifInterface*) ffListAdd((FFlist*) data);
+    *inf = (FFNetifInterface) {
+        .index = (uint32_t) ifi->ifi_index,
+        .flags = ifi->ifi_flags,
+        .operState = IF_OPER_UNKNOWN,
+    };
+    ffListInit(&inf->addresses, sizeof(FFNetifAddress));
+
+    int len = (int) IFLA_PAYLOAD(nlh);
+    for (struct rtattr* rta = IFLA_RTA(ifi); RTA_OK(rta, len); rta = RTA_NEXT(rta, len))
+    {
+        switch (rta->rta_type)
+        {
+            case IFLA_IFNAME:
+                snprintf(inf->name, sizeof(inf->name), "%s", (const char*) RTA_DATA(rta));
+                break;
+            case IFLA_OPERSTATE:
+                inf->operState = *(const uint8_t*) RTA_DATA(rta);
+                break;
+            case IFLA_ADDRESS:
+                if (RTA_PAYLOAD(rta) >= sizeof(inf->mac))
+                {
+                    inf->macLength = sizeof(inf->mac);
+                    memcpy(inf->mac, RTA_DATA(rta), sizeof(inf->mac));
+                }
+                break;
+        }
+    }
+    return true;
+}
+
+static bool parseAddr(struct nlmsghdr* nlh, void* data)
+{
+    if (nlh->nlmsg_type != RTM_NEWADDR)
+        return true;
+
+    struct ifaddrmsg* ifa = (struct ifaddrmsg*) NLMSG_DATA(nlh);
+    if (ifa->ifa_family != AF_INET && ifa->ifa_family != AF_INET6)
+        return true;
+
+    FFNetifInterface* inf = NULL;
+    FF_LIST_FOR_EACH(FFNetifInterface, temp, *(FFlist*) data)
+    {
+        if (temp->index != ifa->ifa_index) continue;
+        inf = temp;
+        break;
+    }
+    if (!inf) return true;
+
+    // IFA_LOCAL is the local address of point-to-point links, where IFA_ADDRESS is the peer
+    const void* address = NULL;
+    const void* local = NULL;
+    uint32_t addrLength = ifa->ifa_family == AF_INET ? 4 : 16;
+
+    int len = (int) IFA_PAYLOAD(nlh);
+    for (struct rtattr* rta = IFA_RTA(ifa); RTA_OK(rta, len); rta = RTA_NEXT(rta, len))
+    {
+        if (RTA_PAYLOAD(rta) < addrLength) continue;
+        if (rta->rta_type == IFA_ADDRESS)
+            address = RTA_DATA(rta);
+        else if (rta->rta_type == IFA_LOCAL)
+            local = RTA_DATA(rta);
+    }
+    if (local) address = local;
+    if (!address) return true;
+
+    FFNetifAddress* addr = (FFNetifAddress*) ffListAdd(&inf->addresses);
+    addr->family = ifa->ifa_family;
+    addr->prefixLength = ifa->ifa_prefixlen;
+    memset(addr->addr, 0, sizeof(addr->addr));
+    memcpy(addr->addr, address, addrLength);
+    return true;
+}
+
+const FFlist* ffNetifGetInterfaces(void)
+{
+    static FFlist interfaces;
+    static bool inited, available;
+    if (inited)
+        return available ? &interfaces : NULL;
+    inited = true;
+
+    ffListInit(&interfaces, sizeof(FFNetifInterface));
+    available = ffNetifNetlinkDump(RTM_GETLINK, AF_UNSPEC, parseLink, &interfaces) == NULL &&
+        ffNetifNetlinkDump(RTM_GETADDR, AF_UNSPEC, parseAddr, &interfaces) == NULL;
+
+    return available ? &interfaces : NULL;
+}
@@ -7,23 +7,90 @@
     #include <minwindef.h>
 #endif
 
+#ifndef _WIN32
+    #define FF_NETWORKING_MAX_CANDIDATES 4
+    #define FF_NETWORKING_MAX_ATTEMPTS FF_NETWORKING_MAX_CANDIDATES
+
+    struct addrinfo;
+    struct FFNetworkingResolver;
+#endif
+
 typedef struct FFNetworkingState {
     #ifdef _WIN32
         uintptr_t sockfd;
         OVERLAPPED overlapped;
     #else
-        int sockfd;
-        FFstrbuf host;
+        int sockfd; // The connected socket
         FFstrbuf command;
+        FFstrbuf response;
+        const char* error;
+        uint8_t stage;
 
-        #ifdef FF_HAVE_THREADS
-            FFThreadType thread;
-        #endif
+        struct FFNetworkingResolver* resolver; // Pending getaddrinfo on a worker thread
+        struct addrinfo* addrs;
+        struct addrinfo* candidates[FF_NETWORKING_MAX_CANDIDATES]; // Resolved addresses, families interleaved
+        uint8_t candidateCount;
+        uint8_t nextCandidate;
+        int attempts[FF_NETWORKING_MAX_ATTEMPTS]; // Connections being raced (RFC 8305)
+        uint64_t nextAttempt; // When to start racing the next candidate
+        uint64_t deadline; // 0 for none
+
+        uint32_t sent;
+        uint32_t headerLength;
+        uint32_t contentLength;
     #endif
 
     uint32_t timeout;
     bool ipv6;
+    bool dualStack; // Ignore `ipv6` and race IPv6 and IPv4 connections
 } FFNetworkingState;
 
+// Splits `host[:port]` or `[ipv6]:port`. `port` defaults to 80
+static inline void ffNetworkingSplitHost(const char* host, FFstrbuf* name, char port[6])
+{
+    const char* colon = strrchr(host, ':');
+    if (host[0] == '[')
+    {
+        const char* bracket = strchr(host, ']');
+        if (bracket)
+        {
+            ffStrbufSetNS(name, (uint32_t) (bracket - host - 1), host + 1);
+            colon = bracket[1] == ':' ? bracket + 1 : NULL;
+        }
+        else
+            ffStrbufSetS(name, host);
+    }
+    else if (colon && strchr(host, ':') == colon)
+        ffStrbufSetNS(name, (uint32_t) (colon - host), host);
+    else
+    {
+        ffStrbufSetS(name, host); // Plain IPv6 address
+        colon = NULL;
+    }
+
+    if (colon && colon[1] != '\0' && strlen(colon + 1) < 6)
+        strcpy(port, colon + 1);
+    else
+        strcpy(port, "80");
+}
+
+// Starts a request. Requests progress concurrently, driven by one event loop whenever any of them is being received
 const char* ffNetworkingSendHttpRequest(FFNetworkingState* state, const char* host, const char* path, const char* headers);
 const char* ffNetworkingRecvHttpResponse(FFNetworkingState* state, FFstrbuf* buffer);
+// Releases a request that has been sent but whose response will never be received
+void ffNetworkingAbortHttpRequest(FFNetworkingState* state);
+
+// Response cache of modules that fetch data over the network. An entry is a response body; the mtime of the file is the time it was fetched.
+// Entries are keyed by `module`, `key` (usually the URL), `ipv6` and the default route (interface and its address), so switching networks doesn't show stale data
+void ffNetworkingGetCachePath(FFstrbuf* path, const char* module, const FFstrbuf* key, bool ipv6);
+// Returns false if there is no entry. `stale` is set if it is older than `ttl` seconds
+bool ffNetworkingReadCache(const FFstrbuf* path, uint32_t ttl, FFstrbuf* body, bool* stale);
+void ffNetworkingWriteCache(const FFstrbuf* path, const FFstrbuf* body);
+// Fetches the response in a detached process that replaces the cache entry when done, for the next run. Returns false if not supported
+bool ffNetworkingRefreshCache(const FFNetworkingState* options, const char* host, const char* path, const char* headers, const FFstrbuf* cachePath);
+
+#ifndef _WIN32
+// The refreshing process: fastfetch re-executed as `fastfetch FF_NETWORKING_REFRESH_COMMAND <args>`. Returns the exit code
+#define FF_NETWORKING_REFRESH_COMMAND "--internal-refresh-network-cache"
+int ffNetworkingRefreshCacheMain(int argc, char** argv);
+#endif
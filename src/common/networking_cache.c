@@ -0,0 +1,79 @@
+#include "fastfetch.h"
+#include "common/networking.h"
+#include "common/netif/netif.h"
+#include "common/io/io.h"
+#include "util/hash.h"
+
+#include <inttypes.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#ifdef __linux__
+    #include <arpa/inet.h>
+#endif
+
+static void appendRouteKey(FFstrbuf* key, FF_MAYBE_UNUSED bool ipv6)
+{
+    uint32_t ifIndex = ffNetifGetDefaultRouteIfIndex();
+    #ifndef _WIN32
+    ffStrbufAppendS(key, ffNetifGetDefaultRouteIfName());
+    #endif
+    ffStrbufAppendC(key, '\0');
+    ffStrbufAppendF(key, "%u", ifIndex);
+
+    #ifdef __linux__
+    // The first global address of the interface. Link-local addresses are the same on every network
+    const FFlist* interfaces = ffNetifGetInterfaces();
+    if (!interfaces) return;
+
+    FF_LIST_FOR_EACH(FFNetifInterface, inf, *interfaces)
+    {
+        if (inf->index != ifIndex) continue;
+
+        FF_LIST_FOR_EACH(FFNetifAddress, addr, inf->addresses)
+        {
+            if (addr->family != (ipv6 ? AF_INET6 : AF_INET)) continue;
+            if (addr->family == AF_INET6 && addr->addr[0] == 0xfe && (addr->addr[1] & 0xc0) == 0x80) continue;
+
+            char buf[INET6_ADDRSTRLEN];
+            if (inet_ntop(addr->family, addr->addr, buf, sizeof(buf)))
+            {
+                ffStrbufAppendC(key, '\0');
+                ffStrbufAppendS(key, buf);
+            }
+            return;
+        }
+    }
+    #endif
+}
+
+void ffNetworkingGetCachePath(FFstrbuf* path, const char* module, const FFstrbuf* key, bool ipv6)
+{
+    FF_STRBUF_AUTO_DESTROY full = ffStrbufCreateCopy(key);
+    ffStrbufAppendC(&full, '\0');
+    ffStrbufAppendC(&full, ipv6 ? '6' : '4');
+    appendRouteKey(&full, ipv6);
+
+    ffStrbufSet(path, &instance.state.platform.cacheDir);
+    ffStrbufAppendF(path, "fastfetch/%s/%016" PRIx64, module, ffHashFnv1aStrbuf(&full));
+}
+
+bool ffNetworkingReadCache(const FFstrbuf* path, uint32_t ttl, FFstrbuf* body, bool* stale)
+{
+    struct stat st;
+    if (stat(path->chars, &st) != 0 || !ffReadFileBuffer(path->chars, body))
+        return false;
+
+    if (body->length == 0)
+        return false;
+
+    *stale = time(NULL) - st.st_mtime >= (time_t) ttl;
+    return true;
+}
+
+void ffNetworkingWriteCache(const FFstrbuf* path, const FFstrbuf* body)
+{
+    // Replaced atomically; other fastfetch instances may read it at any time
+    if (body->length > 0)
+        ffWriteFileBufferAtomic(path->chars, body);
+}
@@ -1,6 +1,12 @@
 #include "fastfetch.h"
 #include "common/networking.h"
+#include "common/time.h"
+#include "common/processing.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <sys/time.h>
 #include <sys/socket.h>
@@ -8,129 +14,563 @@
 #include <netinet/in.h> // For FreeBSD
 #include <netinet/tcp.h>
 
-static const char* connectAndSend(FFNetworkingState* state)
+#ifndef MSG_NOSIGNAL
+    #define MSG_NOSIGNAL 0 // Apple platforms use SO_NOSIGPIPE instead
+#endif
+
+// RFC 8305: start the next connection attempt if the previous one has not succeeded after this delay
+#define FF_NETWORKING_ATTEMPT_DELAY 250
+
+enum
+{
+    FF_NETWORKING_STAGE_RESOLVING,
+    FF_NETWORKING_STAGE_CONNECTING,
+    FF_NETWORKING_STAGE_SENDING,
+    FF_NETWORKING_STAGE_RECEIVING,
+    FF_NETWORKING_STAGE_DONE,
+};
+
+// getaddrinfo running on a worker thread. It is shared by the worker and the request, and freed by whichever releases it last,
+// so a request that times out while the lookup hangs can simply drop it
+typedef struct FFNetworkingResolver
+{
+    char* host;
+    char port[6];
+    int family;
+    int status;
+    struct addrinfo* result;
+    int fds[2]; // socketpair; the worker writes a byte to fds[1] when done, the event loop polls fds[0]
+    uint32_t refs;
+} FFNetworkingResolver;
+
+// Requests that have been sent but not completed yet. All of them are driven by whichever request is being received
+static FFlist activeRequests = { .elementSize = sizeof(FFNetworkingState*) };
+
+static void setNoSigPipe(FF_MAYBE_UNUSED int fd)
+{
+    #ifdef SO_NOSIGPIPE
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &(int) { 1 }, sizeof(int));
+    #endif
+}
+
+static void releaseResolver(FFNetworkingResolver* resolver)
 {
-    const char* ret = NULL;
-    struct addrinfo* addr;
+    if (__atomic_sub_fetch(&resolver->refs, 1, __ATOMIC_ACQ_REL) > 0)
+        return;
 
-    if(getaddrinfo(state->host.chars, "80", &(struct addrinfo) {
-        .ai_family = state->ipv6 ? AF_INET6 : AF_INET,
+    if (resolver->result)
+        freeaddrinfo(resolver->result);
+    free(resolver->host);
+    free(resolver);
+}
+
+static void resolve(FFNetworkingResolver* resolver)
+{
+    resolver->status = getaddrinfo(resolver->host, resolver->port, &(struct addrinfo) {
+        .ai_family = resolver->family,
         .ai_socktype = SOCK_STREAM,
-    }, &addr) != 0)
+    }, &resolver->result);
+
+    send(resolver->fds[1], "", 1, MSG_NOSIGNAL);
+    close(resolver->fds[1]);
+    releaseResolver(resolver);
+}
+
+FF_THREAD_ENTRY_DECL_WRAPPER(resolve, FFNetworkingResolver*);
+
+static int getFamily(const FFNetworkingState* state)
+{
+    if (state->dualStack)
+        return AF_UNSPEC;
+    return state->ipv6 ? AF_INET6 : AF_INET;
+}
+
+static void closeAttempts(FFNetworkingState* state)
+{
+    for (uint32_t i = 0; i < FF_NETWORKING_MAX_ATTEMPTS; ++i)
     {
-        ret = "getaddrinfo() failed";
-        goto error;
+        if (state->attempts[i] < 0) continue;
+        close(state->attempts[i]);
+        state->attempts[i] = -1;
     }
+}
 
-    state->sockfd = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
-    if(state->sockfd == -1)
+static void finishRequest(FFNetworkingState* state, const char* error)
+{
+    state->error = error;
+    state->stage = FF_NETWORKING_STAGE_DONE;
+
+    if (state->resolver)
+    {
+        close(state->resolver->fds[0]);
+        releaseResolver(state->resolver);
+        state->resolver = NULL;
+    }
+    closeAttempts(state);
+    if (state->sockfd >= 0)
     {
-        freeaddrinfo(addr);
-        ret = "socket() failed";
-        goto error;
+        close(state->sockfd);
+        state->sockfd = -1;
+    }
+    if (state->addrs)
+    {
+        freeaddrinfo(state->addrs);
+        state->addrs = NULL;
     }
+    ffStrbufDestroy(&state->command);
+    if (error)
+        ffStrbufDestroy(&state->response);
 
-    if (state->timeout > 0)
+    for (uint32_t i = 0; i < activeRequests.length; ++i)
     {
-        FF_MAYBE_UNUSED uint32_t sec = state->timeout / 1000;
-        if (sec == 0) sec = 1;
+        if (*(FFNetworkingState**) ffListGet(&activeRequests, i) != state) continue;
+        memmove(ffListGet(&activeRequests, i), ffListGet(&activeRequests, i + 1), (activeRequests.length - i - 1) * sizeof(state));
+        --activeRequests.length;
+        break;
+    }
+}
+
+// Orders the resolved addresses so that the address families alternate, starting with the first one returned (RFC 8305, section 4)
+static void sortCandidates(FFNetworkingState* state)
+{
+    struct addrinfo* byFamily[2][FF_NETWORKING_MAX_CANDIDATES];
+    uint32_t counts[2] = {};
+    int firstFamily = state->addrs->ai_family;
 
-        #ifdef TCP_CONNECTIONTIMEOUT
-        setsockopt(state->sockfd, IPPROTO_TCP, TCP_CONNECTIONTIMEOUT, &sec, sizeof(sec));
-        #elif defined(TCP_KEEPINIT)
-        setsockopt(state->sockfd, IPPROTO_TCP, TCP_KEEPINIT, &sec, sizeof(sec));
-        #elif defined(TCP_USER_TIMEOUT)
-        setsockopt(state->sockfd, IPPROTO_TCP, TCP_USER_TIMEOUT, &state->timeout, sizeof(state->timeout));
-        #endif
+    for (struct addrinfo* addr = state->addrs; addr; addr = addr->ai_next)
+    {
+        uint32_t index = addr->ai_family == firstFamily ? 0 : 1;
+        if (counts[index] < FF_NETWORKING_MAX_CANDIDATES)
+            byFamily[index][counts[index]++] = addr;
     }
 
-    if(connect(state->sockfd, addr->ai_addr, addr->ai_addrlen) == -1)
+    state->candidateCount = 0;
+    for (uint32_t i = 0; state->candidateCount < FF_NETWORKING_MAX_CANDIDATES && (i < counts[0] || i < counts[1]); ++i)
     {
-        close(state->sockfd);
-        freeaddrinfo(addr);
-        ret = "connect() failed";
-        goto error;
+        for (uint32_t family = 0; family < 2; ++family)
+        {
+            if (i < counts[family] && state->candidateCount < FF_NETWORKING_MAX_CANDIDATES)
+                state->candidates[state->candidateCount++] = byFamily[family][i];
+        }
     }
+    state->nextCandidate = 0;
+}
 
-    freeaddrinfo(addr);
+static void setConnectTimeout(FFNetworkingState* state, int sockfd)
+{
+    if (state->timeout == 0)
+        return;
 
-    if(send(state->sockfd, state->command.chars, state->command.length, 0) < 0)
+    FF_MAYBE_UNUSED uint32_t sec = state->timeout / 1000;
+    if (sec == 0) sec = 1;
+
+    #ifdef TCP_CONNECTIONTIMEOUT
+    setsockopt(sockfd, IPPROTO_TCP, TCP_CONNECTIONTIMEOUT, &sec, sizeof(sec));
+    #elif defined(TCP_KEEPINIT)
+    setsockopt(sockfd, IPPROTO_TCP, TCP_KEEPINIT, &sec, sizeof(sec));
+    #elif defined(TCP_USER_TIMEOUT)
+    setsockopt(sockfd, IPPROTO_TCP, TCP_USER_TIMEOUT, &state->timeout, sizeof(state->timeout));
+    #endif
+}
+
+// Starts a non-blocking connection to the next candidate address. Returns false if there are none left
+static bool startAttempt(FFNetworkingState* state, uint64_t now)
+{
+    while (state->nextCandidate < state->candidateCount)
     {
-        close(state->sockfd);
-        ret = "send() failed";
-        goto error;
+        struct addrinfo* addr = state->candidates[state->nextCandidate++];
+
+        uint32_t slot = 0;
+        while (slot < FF_NETWORKING_MAX_ATTEMPTS && state->attempts[slot] >= 0) ++slot;
+        if (slot == FF_NETWORKING_MAX_ATTEMPTS) return false;
+
+        int sockfd = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+        if (sockfd < 0) continue;
+
+        fcntl(sockfd, F_SETFD, FD_CLOEXEC);
+        fcntl(sockfd, F_SETFL, fcntl(sockfd, F_GETFL) | O_NONBLOCK);
+        setNoSigPipe(sockfd);
+        setConnectTimeout(state, sockfd);
+
+        if (connect(sockfd, addr->ai_addr, addr->ai_addrlen) < 0 && errno != EINPROGRESS)
+        {
+            close(sockfd);
+            continue;
+        }
+
+        state->attempts[slot] = sockfd;
+        state->nextAttempt = now + FF_NETWORKING_ATTEMPT_DELAY;
+        return true;
+    }
+    return false;
+}
+
+static bool hasAttempts(const FFNetworkingState* state)
+{
+    for (uint32_t i = 0; i < FF_NETWORKING_MAX_ATTEMPTS; ++i)
+    {
+        if (state->attempts[i] >= 0) return true;
     }
+    return false;
+}
 
-    goto exit;
+static void startConnecting(FFNetworkingState* state, uint64_t now)
+{
+    sortCandidates(state);
+    state->stage = FF_NETWORKING_STAGE_CONNECTING;
+    if (!startAttempt(state, now))
+        finishRequest(state, "connect() failed");
+}
 
-error:
-    state->sockfd = -1;
+static void onResolved(FFNetworkingState* state, uint64_t now)
+{
+    FFNetworkingResolver* resolver = state->resolver;
+    state->resolver = NULL;
+    close(resolver->fds[0]);
 
-exit:
-    ffStrbufDestroy(&state->host);
-    ffStrbufDestroy(&state->command);
+    if (resolver->status == 0 && resolver->result)
+    {
+        state->addrs = resolver->result;
+        resolver->result = NULL;
+    }
+    releaseResolver(resolver);
 
-    return ret;
+    if (!state->addrs)
+        finishRequest(state, "getaddrinfo() failed");
+    else
+        startConnecting(state, now);
 }
 
-FF_THREAD_ENTRY_DECL_WRAPPER(connectAndSend, FFNetworkingState*);
+static void onConnectEvent(FFNetworkingState* state, uint32_t slot, short pollRevents, uint64_t now)
+{
+    int sockfd = state->attempts[slot];
+
+    // The fd may have been reused by a newer attempt of this round that is still in progress
+    struct sockaddr_storage peer;
+    socklen_t peerLen = sizeof(peer);
+    if (getpeername(sockfd, (struct sockaddr*) &peer, &peerLen) < 0 && errno == ENOTCONN && !(pollRevents & (POLLERR | POLLHUP)))
+        return;
+
+    int error = 0;
+    socklen_t len = sizeof(error);
+    if (getsockopt(sockfd, SOL_SOCKET, SO_ERROR, &error, &len) < 0 || error != 0)
+    {
+        close(sockfd);
+        state->attempts[slot] = -1;
+        // Failed attempts don't wait for the attempt delay
+        if (!startAttempt(state, now) && !hasAttempts(state))
+            finishRequest(state, "connect() failed");
+        return;
+    }
+
+    // The first connection wins, the others are abandoned
+    state->attempts[slot] = -1;
+    closeAttempts(state);
+    state->sockfd = sockfd;
+    state->stage = FF_NETWORKING_STAGE_SENDING;
+    freeaddrinfo(state->addrs);
+    state->addrs = NULL;
+}
+
+static void onSendable(FFNetworkingState* state)
+{
+    ssize_t sent = send(state->sockfd, state->command.chars + state->sent, state->command.length - state->sent, MSG_NOSIGNAL);
+    if (sent < 0)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            finishRequest(state, "send() failed");
+        return;
+    }
+
+    state->sent += (uint32_t) sent;
+    if (state->sent == state->command.length)
+        state->stage = FF_NETWORKING_STAGE_RECEIVING;
+}
+
+// The response is complete once the body has reached Content-Length. Without it we wait for the server to close (we send `Connection: close`)
+static bool isResponseComplete(FFNetworkingState* state)
+{
+    if (state->headerLength == 0)
+    {
+        const char* end = strstr(state->response.chars, "\r\n\r\n");
+        if (!end) return false;
+        state->headerLength = (uint32_t) (end - state->response.chars) + 4;
+
+        const char* contentLength = strcasestr(state->response.chars, "\r\nContent-Length:");
+        if (contentLength && contentLength < end)
+            state->contentLength = (uint32_t) strtoul(contentLength + strlen("\r\nContent-Length:"), NULL, 10);
+        else
+            state->contentLength = UINT32_MAX;
+    }
+
+    return state->contentLength != UINT32_MAX && state->response.length - state->headerLength >= state->contentLength;
+}
+
+static void onReadable(FFNetworkingState* state)
+{
+    ffStrbufEnsureFree(&state->response, 4095);
+    ssize_t received = recv(state->sockfd, state->response.chars + state->response.length, ffStrbufGetFree(&state->response), 0);
+    if (received < 0)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            finishRequest(state, "recv() failed");
+        return;
+    }
+
+    state->response.length += (uint32_t) received;
+    state->response.chars[state->response.length] = '\0';
+
+    if (received == 0 || isResponseComplete(state))
+    {
+        bool ok = ffStrbufStartsWithS(&state->response, "HTTP/1.1 200 ") || ffStrbufStartsWithS(&state->response, "HTTP/1.0 200 ");
+        finishRequest(state, ok ? NULL : "Invalid response");
+    }
+}
+
+// One round of the event loop: a single poll() over the sockets of all active requests
+static void driveRequests(void)
+{
+    uint32_t count = activeRequests.length;
+    if (count == 0) return;
+
+    FF_LIST_AUTO_DESTROY pollfds = ffListCreate(sizeof(struct pollfd));
+    FF_LIST_AUTO_DESTROY owners = ffListCreate(sizeof(FFNetworkingState*));
+    FF_LIST_AUTO_DESTROY slots = ffListCreate(sizeof(uint32_t));
+
+    uint64_t now = ffTimeGetTick();
+    int wait = -1;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        FFNetworkingState* state = *(FFNetworkingState**) ffListGet(&activeRequests, i);
+
+        #define FF_ADD_POLLFD(fd_, events_, slot_) do { \
+            *(struct pollfd*) ffListAdd(&pollfds) = (struct pollfd) { (fd_), (events_), 0 }; \
+            *(FFNetworkingState**) ffListAdd(&owners) = state; \
+            *(uint32_t*) ffListAdd(&slots) = (slot_); \
+        } while (0)
+
+        switch (state->stage)
+        {
+            case FF_NETWORKING_STAGE_RESOLVING:
+                FF_ADD_POLLFD(state->resolver->fds[0], POLLIN, 0);
+                break;
+            case FF_NETWORKING_STAGE_CONNECTING:
+                for (uint32_t slot = 0; slot < FF_NETWORKING_MAX_ATTEMPTS; ++slot)
+                {
+                    if (state->attempts[slot] >= 0)
+                        FF_ADD_POLLFD(state->attempts[slot], POLLOUT, slot);
+                }
+                if (state->nextCandidate < state->candidateCount)
+                {
+                    int remaining = state->nextAttempt > now ? (int) (state->nextAttempt - now) : 0;
+                    if (wait < 0 || remaining < wait) wait = remaining;
+                }
+                break;
+            case FF_NETWORKING_STAGE_SENDING:
+                FF_ADD_POLLFD(state->sockfd, POLLOUT, 0);
+                break;
+            case FF_NETWORKING_STAGE_RECEIVING:
+                FF_ADD_POLLFD(state->sockfd, POLLIN, 0);
+                break;
+        }
+
+        #undef FF_ADD_POLLFD
+
+        if (state->deadline > 0)
+        {
+            int remaining = state->deadline > now ? (int) (state->deadline - now) : 0;
+            if (wait < 0 || remaining < wait) wait = remaining;
+        }
+    }
+
+    if (poll((struct pollfd*) pollfds.data, pollfds.length, wait) < 0 && errno != EINTR)
+    {
+        while (activeRequests.length > 0)
+            finishRequest(*(FFNetworkingState**) ffListGet(&activeRequests, 0), "poll() failed");
+        return;
+    }
+    now = ffTimeGetTick();
+
+    for (uint32_t i = 0; i < pollfds.length; ++i)
+    {
+        const struct pollfd* pfd = ffListGet(&pollfds, i);
+        FFNetworkingState* state = *(FFNetworkingState**) ffListGet(&owners, i);
+        uint32_t slot = *(uint32_t*) ffListGet(&slots, i);
+        if (pfd->revents == 0) continue;
+
+        switch (state->stage)
+        {
+            case FF_NETWORKING_STAGE_RESOLVING:
+                onResolved(state, now);
+                break;
+            case FF_NETWORKING_STAGE_CONNECTING:
+                if (state->attempts[slot] == pfd->fd)
+                    onConnectEvent(state, slot, pfd->revents, now);
+                break;
+            case FF_NETWORKING_STAGE_SENDING:
+                onSendable(state);
+                break;
+            case FF_NETWORKING_STAGE_RECEIVING:
+                if (pfd->revents & (POLLIN | POLLHUP | POLLERR))
+                    onReadable(state);
+                break;
+        }
+    }
+
+    // Attempt delays and deadlines. Iterate backwards, finished requests are removed from the list
+    for (uint32_t i = activeRequests.length; i > 0; --i)
+    {
+        FFNetworkingState* state = *(FFNetworkingState**) ffListGet(&activeRequests, i - 1);
+
+        if (state->deadline > 0 && now >= state->deadline)
+        {
+            finishRequest(state, state->stage == FF_NETWORKING_STAGE_RESOLVING ? "getaddrinfo() timeout" : "Request timeout");
+            continue;
+        }
+
+        if (state->stage == FF_NETWORKING_STAGE_CONNECTING && now >= state->nextAttempt)
+            startAttempt(state, now);
+    }
+}
 
 const char* ffNetworkingSendHttpRequest(FFNetworkingState* state, const char* host, const char* path, const char* headers)
 {
-    ffStrbufInitS(&state->host, host);
+    state->sockfd = -1;
+    for (uint32_t i = 0; i < FF_NETWORKING_MAX_ATTEMPTS; ++i)
+        state->attempts[i] = -1;
+    state->resolver = NULL;
+    state->addrs = NULL;
+    state->sent = state->headerLength = state->contentLength = 0;
+    state->error = NULL;
+
+    uint64_t now = ffTimeGetTick();
+    state->deadline = state->timeout > 0 ? now + state->timeout : 0;
+
+    ffStrbufInitA(&state->response, 4096);
 
     ffStrbufInitA(&state->command, 64);
     ffStrbufAppendS(&state->command, "GET ");
     ffStrbufAppendS(&state->command, path);
-    ffStrbufAppendS(&state->command, " HTTP/1.1\nHost: ");
+    ffStrbufAppendS(&state->command, " HTTP/1.1\r\nHost: ");
     ffStrbufAppendS(&state->command, host);
-    ffStrbufAppendS(&state->command, "\r\n");
+    ffStrbufAppendS(&state->command, "\r\nConnection: close\r\n");
     ffStrbufAppendS(&state->command, headers);
     ffStrbufAppendS(&state->command, "\r\n");
 
+    *(FFNetworkingState**) ffListAdd(&activeRequests) = state;
+
+    FF_STRBUF_AUTO_DESTROY name = ffStrbufCreate();
+    char port[6];
+    ffNetworkingSplitHost(host, &name, port);
+
     #ifdef FF_HAVE_THREADS
     if (instance.config.general.multithreading)
     {
-        state->thread = ffThreadCreate(connectAndSendThreadMain, state);
-        return state->thread ? NULL : "ffThreadCreate(connectAndSend) failed";
+        FFNetworkingResolver* resolver = malloc(sizeof(*resolver));
+        *resolver = (FFNetworkingResolver) {
+            .host = strdup(name.chars),
+            .family = getFamily(state),
+            .refs = 2,
+        };
+        strcpy(resolver->port, port);
+
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, resolver->fds) == 0)
+        {
+            fcntl(resolver->fds[0], F_SETFD, FD_CLOEXEC);
+            fcntl(resolver->fds[1], F_SETFD, FD_CLOEXEC);
+            setNoSigPipe(resolver->fds[1]);
+            FFThreadType thread = ffThreadCreate(resolveThreadMain, resolver);
+            if (thread)
+            {
+                ffThreadDetach(thread);
+                state->resolver = resolver;
+                state->stage = FF_NETWORKING_STAGE_RESOLVING;
+                return NULL;
+            }
+            close(resolver->fds[0]);
+            close(resolver->fds[1]);
+        }
+        free(resolver->host);
+        free(resolver);
     }
     #endif
 
-    return connectAndSend(state);
+    if (getaddrinfo(name.chars, port, &(struct addrinfo) {
+        .ai_family = getFamily(state),
+        .ai_socktype = SOCK_STREAM,
+    }, &state->addrs) != 0)
+    {
+        state->addrs = NULL;
+        finishRequest(state, "getaddrinfo() failed");
+        return state->error;
+    }
+
+    startConnecting(state, now);
+    return state->stage == FF_NETWORKING_STAGE_DONE ? state->error : NULL;
 }
 
 const char* ffNetworkingRecvHttpResponse(FFNetworkingState* state, FFstrbuf* buffer)
 {
-    uint32_t timeout = state->timeout;
+    while (state->stage != FF_NETWORKING_STAGE_DONE)
+        driveRequests();
 
-    #ifdef FF_HAVE_THREADS
-    if (instance.config.general.multithreading)
-    {
-        if (!ffThreadJoin(state->thread, timeout))
-            return "ffThreadJoin() failed or timeout";
-    }
-    #endif
+    if (state->error == NULL)
+        ffStrbufAppend(buffer, &state->response);
+    ffStrbufDestroy(&state->response);
+    return state->error;
+}
 
-    if(state->sockfd == -1)
-        return "ffNetworkingSendHttpRequest() failed";
+void ffNetworkingAbortHttpRequest(FFNetworkingState* state)
+{
+    if (state->stage != FF_NETWORKING_STAGE_DONE)
+        finishRequest(state, "Request aborted");
+    ffStrbufDestroy(&state->response);
+}
 
-    if(timeout > 0)
-    {
-        struct timeval timev;
-        timev.tv_sec = timeout / 1000;
-        timev.tv_usec = (__typeof__(timev.tv_usec)) ((timeout % 1000) * 1000); //milliseconds to microseconds
-        setsockopt(state->sockfd, SOL_SOCKET, SO_RCVTIMEO, &timev, sizeof(timev));
-    }
+bool ffNetworkingRefreshCache(const FFNetworkingState* options, const char* host, const char* path, const char* headers, const FFstrbuf* cachePath)
+{
+    // A fresh process instead of fork(): we are multithreaded, and only async-signal-safe calls may follow fork() then
+    if (instance.state.platform.exePath.length == 0)
+        return false;
+
+    char timeout[16], flags[3];
+    snprintf(timeout, sizeof(timeout), "%u", options->timeout);
+    flags[0] = options->ipv6 ? '6' : '4';
+    flags[1] = options->dualStack ? 'd' : '-';
+    flags[2] = '\0';
+
+    return ffProcessSpawnDetached((char* const[]) {
+        instance.state.platform.exePath.chars,
+        FF_NETWORKING_REFRESH_COMMAND,
+        cachePath->chars,
+        (char*) host,
+        (char*) path,
+        (char*) (headers ? headers : ""),
+        timeout,
+        flags,
+        NULL,
+    }) == NULL;
+}
+
+// argv: fastfetch FF_NETWORKING_REFRESH_COMMAND <cache path> <host> <path> <headers> <timeout> <4|6><d|->
+int ffNetworkingRefreshCacheMain(int argc, char** argv)
+{
+    if (argc != 8 || strlen(argv[7]) != 2)
+        return 1;
 
-    uint32_t recvStart;
-    do {
-        recvStart = buffer->length;
-        ssize_t received = recv(state->sockfd, buffer->chars + buffer->length, ffStrbufGetFree(buffer), 0);
-        if (received <= 0) break;
-        buffer->length += (uint32_t) received;
-        buffer->chars[buffer->length] = '\0';
-    } while (ffStrbufGetFree(buffer) > 0 && strstr(buffer->chars + recvStart, "\r\n\r\n") == NULL);
+    FFNetworkingState state = {
+        .timeout = (uint32_t) strtoul(argv[6], NULL, 10),
+        .ipv6 = argv[7][0] == '6',
+        .dualStack = argv[7][1] == 'd',
+    };
+    FF_STRBUF_AUTO_DESTROY response = ffStrbufCreate();
+    if (ffNetworkingSendHttpRequest(&state, argv[3], argv[4], argv[5][0] ? argv[5] : NULL) != NULL ||
+        ffNetworkingRecvHttpResponse(&state, &response) != NULL)
+        return 1;
 
-    close(state->sockfd);
-    return ffStrbufStartsWithS(buffer, "HTTP/1.1 200 OK\r\n") ? NULL : "Invalid response";
+    ffStrbufSubstrAfterFirstS(&response, "\r\n\r\n");
+    FF_STRBUF_AUTO_DESTROY cachePath = ffStrbufCreateS(argv[2]);
+    ffNetworkingWriteCache(&cachePath, &response);
+    return response.length > 0 ? 0 : 1;
 }
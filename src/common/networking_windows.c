@@ -50,8 +50,12 @@ const char* ffNetworkingSendHttpRequest(FFNetworkingState* state, const char* ho
 
     struct addrinfo* addr;
 
-    if(getaddrinfo(host, "80", &(struct addrinfo) {
-        .ai_family = state->ipv6 ? AF_INET6 : AF_INET,
+    FF_STRBUF_AUTO_DESTROY name = ffStrbufCreate();
+    char port[6];
+    ffNetworkingSplitHost(host, &name, port);
+
+    if(getaddrinfo(name.chars, port, &(struct addrinfo) {
+        .ai_family = state->dualStack ? AF_UNSPEC : state->ipv6 ? AF_INET6 : AF_INET,
         .ai_socktype = SOCK_STREAM,
     }, &addr) != 0)
         return "getaddrinfo() failed";
@@ -142,3 +146,20 @@ const char* ffNetworkingRecvHttpResponse(FFNetworkingState* state, FFstrbuf* buf
     closesocket(state->sockfd);
     return ffStrbufStartsWithS(buffer, "HTTP/1.1 200 OK\r\n") ? NULL : "Invalid response";
 }
+
+void ffNetworkingAbortHttpRequest(FFNetworkingState* state)
+{
+    if (state->sockfd == INVALID_SOCKET)
+        return;
+
+    CancelIo((HANDLE) state->sockfd);
+    closesocket(state->sockfd);
+    state->sockfd = INVALID_SOCKET;
+}
+
+bool ffNetworkingRefreshCache(const FFNetworkingState* options, const char* host, const char* path, const char* headers, const FFstrbuf* cachePath)
+{
+    // Needs fork(); stale entries are refreshed in the foreground instead
+    FF_UNUSED(options, host, path, headers, cachePath);
+    return false;
+}
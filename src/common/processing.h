@@ -2,8 +2,51 @@
 
 #include "util/FFstrbuf.h"
 
+#ifndef _WIN32
+    #include <sys/types.h>
+#endif
+
 const char* ffProcessAppendOutput(FFstrbuf* buffer, char* const argv[], bool useStdErr);
 
+typedef struct FFProcessRequest
+{
+    char* const* argv;
+    FFstrbuf* buffer; // Output of the command is appended to it
+    bool useStdErr;
+    const char* error; // Result, set by ffProcessAppendOutputs
+    #ifndef _WIN32
+    int exitStatus; // Result: the exit code, or -1 if the command didn't exit normally or was killed
+    #endif
+} FFProcessRequest;
+
+// Runs all commands concurrently and returns when every one of them has exited or timed out.
+// Each command gets its own processing timeout. Output is not trimmed
+void ffProcessAppendOutputs(FFProcessRequest* requests, uint32_t count);
+
+typedef struct FFProcessHandle
+{
+    #ifdef _WIN32
+    // The command runs synchronously in ffProcessSpawn
+    FFstrbuf output;
+    const char* error;
+    #else
+    pid_t pid;
+    int pipeRead;
+    #endif
+} FFProcessHandle;
+
+// Starts a command without waiting for it. Its output is collected later with ffProcessReadOutput, which must be called exactly once
+const char* ffProcessSpawn(char* const argv[], bool useStdErr, FFProcessHandle* handle);
+const char* ffProcessReadOutput(FFProcessHandle* handle, FFstrbuf* buffer);
+// Releases a handle whose output is no longer wanted, instead of ffProcessReadOutput. The child is killed and reaped
+void ffProcessDiscard(FFProcessHandle* handle);
+
+#ifndef _WIN32
+// Starts a command in a new session with stdin / stdout / stderr on /dev/null, and forgets it.
+// The child is reparented to init once we exit, which is soon for fastfetch
+const char* ffProcessSpawnDetached(char* const argv[]);
+#endif
+
 static inline const char* ffProcessAppendStdOut(FFstrbuf* buffer, char* const argv[])
 {
     const char* error = ffProcessAppendOutput(buffer, argv, false);
@@ -2,6 +2,7 @@
 #include "common/processing.h"
 #include "common/io/io.h"
 #include "common/time.h"
+#include "util/mallocHelper.h"
 
 #include <stdlib.h>
 #include <unistd.h>
@@ -11,8 +12,21 @@
 #include <errno.h>
 #include <sys/wait.h>
 
+#if defined(__ANDROID__) && __ANDROID_API__ < 28
+    // posix_spawn is only available since API level 28
+    #define FF_PROCESS_USE_FORK 1
+#else
+    #include <spawn.h>
+#endif
+
+#ifdef __linux__
+    #include <sys/syscall.h>
+#endif
+
 enum { FF_PIPE_BUFSIZ = 8192 };
 
+extern char** environ;
+
 static inline int ffPipe2(int *fds, int flags)
 {
     #ifdef __APPLE__
@@ -26,78 +40,358 @@ static inline int ffPipe2(int *fds, int flags)
     #endif
 }
 
-const char* ffProcessAppendOutput(FFstrbuf* buffer, char* const argv[], bool useStdErr)
+typedef struct FFProcessChild
 {
-    int pipes[2];
-    const int timeout = instance.config.general.processingTimeout;
+    pid_t pid;
+    int pipeFd; // -1 once the child closed its end
+    int pidFd; // -1 if pidfd is not available; then the child is reaped with a blocking waitpid after EOF
+    uint64_t deadline; // Reset whenever the child writes something
+} FFProcessChild;
 
-    if(ffPipe2(pipes, O_CLOEXEC) == -1)
-        return "pipe() failed";
+// The environment of the children: ours, with LANG=C so that their output can be parsed
+static char** createChildEnvironment(void)
+{
+    uint32_t count = 0;
+    while (environ[count]) ++count;
 
-    pid_t childPid = fork();
-    if(childPid == -1)
+    char** envp = malloc(sizeof(*envp) * (count + 2));
+    uint32_t index = 0;
+    for (uint32_t i = 0; i < count; ++i)
     {
-        close(pipes[0]);
-        close(pipes[1]);
-        return "fork() failed";
+        if (strncmp(environ[i], "LANG=", strlen("LANG=")) != 0)
+            envp[index++] = environ[i];
     }
+    envp[index++] = "LANG=C";
+    envp[index] = NULL;
+    return envp;
+}
+
+static const char* spawnChild(char* const argv[], bool useStdErr, char* const envp[], int pipeWrite, pid_t* pid)
+{
+    #if FF_PROCESS_USE_FORK
+
+    *pid = fork();
+    if (*pid == -1)
+        return "fork() failed";
 
-    //Child
-    if(childPid == 0)
+    if (*pid == 0)
     {
         int nullFile = open("/dev/null", O_WRONLY | O_CLOEXEC);
-        dup2(pipes[1], useStdErr ? STDERR_FILENO : STDOUT_FILENO);
+        dup2(pipeWrite, useStdErr ? STDERR_FILENO : STDOUT_FILENO);
         dup2(nullFile, useStdErr ? STDOUT_FILENO : STDERR_FILENO);
-        setenv("LANG", "C", 1);
-        execvp(argv[0], argv);
+        execvpe(argv[0], argv, envp);
         _exit(127);
     }
+    return NULL;
+
+    #else
+
+    // posix_spawn uses vfork semantics (clone(CLONE_VM | CLONE_VFORK) on glibc and musl),
+    // so our page tables aren't copied just to exec the child
+    posix_spawn_file_actions_t actions;
+    if (posix_spawn_file_actions_init(&actions) != 0)
+        return "posix_spawn_file_actions_init() failed";
+
+    posix_spawn_file_actions_adddup2(&actions, pipeWrite, useStdErr ? STDERR_FILENO : STDOUT_FILENO);
+    posix_spawn_file_actions_addopen(&actions, useStdErr ? STDOUT_FILENO : STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+    int error = posix_spawnp(pid, argv[0], &actions, NULL, argv, envp);
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (error == ENOENT)
+        return "command was not found";
+    if (error != 0)
+        return "posix_spawnp() failed";
+    return NULL;
+
+    #endif
+}
+
+static int openPidFd(FF_MAYBE_UNUSED pid_t pid)
+{
+    #if defined(__linux__) && defined(SYS_pidfd_open)
+    return (int) syscall(SYS_pidfd_open, pid, 0);
+    #else
+    return -1;
+    #endif
+}
+
+static void closeChild(FFProcessChild* child)
+{
+    if (child->pipeFd >= 0)
+    {
+        close(child->pipeFd);
+        child->pipeFd = -1;
+    }
+    if (child->pidFd >= 0)
+    {
+        close(child->pidFd);
+        child->pidFd = -1;
+    }
+    child->pid = 0;
+}
+
+static const char* killChild(FFProcessChild* child, const char* error)
+{
+    kill(child->pid, SIGTERM);
+    waitpid(child->pid, NULL, 0);
+    closeChild(child);
+    return error;
+}
 
-    //Parent
+static const char* reapChild(FFProcessChild* child, int* exitStatus)
+{
+    int stat_loc = 0;
+    pid_t pid = waitpid(child->pid, &stat_loc, 0);
+    closeChild(child);
+
+    if (pid == -1)
+        return "waitpid() failed";
+    if (!WIFEXITED(stat_loc))
+        return "child process exited abnormally";
+    *exitStatus = WEXITSTATUS(stat_loc);
+    if (WEXITSTATUS(stat_loc) == 127)
+        return "command was not found";
+    // We only handle 127 as an error. See `getTerminalVersionUrxvt` in `terminalshell.c`
+    return NULL;
+}
+
+// Creates the pipe and starts the child. Both pipe ends are O_CLOEXEC, so concurrently spawned children don't keep each other's pipes open
+static const char* startChild(char* const argv[], bool useStdErr, char* const envp[], FFProcessChild* child)
+{
+    child->pid = 0;
+    child->pipeFd = child->pidFd = -1;
+
+    int pipes[2];
+    if (ffPipe2(pipes, O_CLOEXEC) == -1)
+        return "pipe() failed";
+
+    const char* error = spawnChild(argv, useStdErr, envp, pipes[1], &child->pid);
     close(pipes[1]);
+    if (error)
+    {
+        close(pipes[0]);
+        child->pid = 0;
+        return error;
+    }
+
+    child->pipeFd = pipes[0];
+    return NULL;
+}
+
+// Serves all started children from one poll loop until each has exited or timed out
+static void waitChildren(FFProcessChild* children, FFProcessRequest* requests, uint32_t count)
+{
+    const int timeout = instance.config.general.processingTimeout;
+
+    FF_AUTO_FREE struct pollfd* pollfds = malloc(sizeof(*pollfds) * count);
+    FF_AUTO_FREE uint32_t* pollIndices = malloc(sizeof(*pollIndices) * count);
+
+    uint32_t active = 0;
+    uint64_t now = ffTimeGetTick();
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        FFProcessChild* child = &children[i];
+        if (child->pid == 0) continue;
+        child->pidFd = openPidFd(child->pid);
+        child->deadline = now + (uint64_t) (timeout >= 0 ? timeout : 0);
+        ++active;
+    }
 
-    int FF_AUTO_CLOSE_FD childPipeFd = pipes[0];
     char str[FF_PIPE_BUFSIZ];
 
-    while(1)
+    while (active > 0)
     {
-        if (timeout >= 0)
+        // One poll for all children: their pipes, or their pidfds once the pipe is closed
+        nfds_t nfds = 0;
+        int wait = -1;
+        for (uint32_t i = 0; i < count; ++i)
         {
-            struct pollfd pollfd = { childPipeFd, POLLIN, 0 };
-            if (poll(&pollfd, 1, timeout) == 0)
-            {
-                kill(childPid, SIGTERM);
-                waitpid(childPid, NULL, 0);
-                return "poll(&pollfd, 1, timeout) timeout (try increasing --processing-timeout)";
-            }
-            else if (pollfd.revents & POLLERR)
+            FFProcessChild* child = &children[i];
+            if (child->pid == 0) continue;
+
+            pollfds[nfds] = (struct pollfd) { child->pipeFd >= 0 ? child->pipeFd : child->pidFd, POLLIN, 0 };
+            pollIndices[nfds++] = i;
+
+            if (timeout >= 0)
             {
-                kill(childPid, SIGTERM);
-                waitpid(childPid, NULL, 0);
-                return "poll(&pollfd, 1, timeout) error";
+                int remaining = child->deadline > now ? (int) (child->deadline - now) : 0;
+                if (wait < 0 || remaining < wait)
+                    wait = remaining;
             }
         }
 
-        ssize_t nRead = read(childPipeFd, str, FF_PIPE_BUFSIZ);
-        if (nRead > 0)
-            ffStrbufAppendNS(buffer, (uint32_t) nRead, str);
-        else if (nRead == 0)
+        if (poll(pollfds, nfds, wait) < 0 && errno != EINTR)
+        {
+            for (uint32_t i = 0; i < nfds; ++i)
+                requests[pollIndices[i]].error = killChild(&children[pollIndices[i]], "poll() failed");
+            break;
+        }
+        now = ffTimeGetTick();
+
+        for (uint32_t i = 0; i < nfds; ++i)
         {
-            int stat_loc = 0;
-            if (waitpid(childPid, &stat_loc, 0) == childPid)
+            FFProcessRequest* request = &requests[pollIndices[i]];
+            FFProcessChild* child = &children[pollIndices[i]];
+            short revents = pollfds[i].revents;
+
+            if (child->pipeFd < 0)
+            {
+                // pidfd readable: the child has exited
+                if (revents & POLLIN)
+                    request->error = reapChild(child, &request->exitStatus);
+            }
+            else if (revents & POLLERR)
+                request->error = killChild(child, "poll(&pollfd, 1, timeout) error");
+            else if (revents & (POLLIN | POLLHUP))
             {
-                if (!WIFEXITED(stat_loc))
-                    return "child process exited abnormally";
-                if (WEXITSTATUS(stat_loc) == 127)
-                    return "command was not found";
-                // We only handle 127 as an error. See `getTerminalVersionUrxvt` in `terminalshell.c`
-                return NULL;
+                ssize_t nRead = read(child->pipeFd, str, FF_PIPE_BUFSIZ);
+                if (nRead > 0)
+                {
+                    ffStrbufAppendNS(request->buffer, (uint32_t) nRead, str);
+                    child->deadline = now + (uint64_t) (timeout >= 0 ? timeout : 0);
+                }
+                else if (nRead == 0)
+                {
+                    close(child->pipeFd);
+                    child->pipeFd = -1;
+                    if (child->pidFd < 0)
+                        request->error = reapChild(child, &request->exitStatus);
+                }
+                else if (errno != EINTR)
+                    request->error = killChild(child, "read(childPipeFd, str, FF_PIPE_BUFSIZ) failed");
             }
-            return "waitpid() failed";
+
+            if (child->pid != 0 && timeout >= 0 && now >= child->deadline)
+                request->error = killChild(child, "poll(&pollfd, 1, timeout) timeout (try increasing --processing-timeout)");
+
+            if (child->pid == 0)
+                --active;
         }
-        else if (nRead < 0)
-            break;
+    }
+}
+
+void ffProcessAppendOutputs(FFProcessRequest* requests, uint32_t count)
+{
+    FF_AUTO_FREE FFProcessChild* children = malloc(sizeof(*children) * count);
+    FF_AUTO_FREE char** envp = createChildEnvironment();
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        requests[i].exitStatus = -1;
+        requests[i].error = startChild(requests[i].argv, requests[i].useStdErr, envp, &children[i]);
+    }
+
+    waitChildren(children, requests, count);
+}
+
+const char* ffProcessAppendOutput(FFstrbuf* buffer, char* const argv[], bool useStdErr)
+{
+    FFProcessRequest request = {
+        .argv = argv,
+        .buffer = buffer,
+        .useStdErr = useStdErr,
+    };
+    ffProcessAppendOutputs(&request, 1);
+    return request.error;
+}
+
+const char* ffProcessSpawn(char* const argv[], bool useStdErr, FFProcessHandle* handle)
+{
+    FF_AUTO_FREE char** envp = createChildEnvironment();
+
+    FFProcessChild child;
+    const char* error = startChild(argv, useStdErr, envp, &child);
+    handle->pid = child.pid;
+    handle->pipeRead = child.pipeFd;
+    return error;
+}
+
+const char* ffProcessSpawnDetached(char* const argv[])
+{
+    pid_t pid;
+
+    #if FF_PROCESS_USE_FORK
+
+    pid = fork();
+    if (pid == -1)
+        return "fork() failed";
+
+    if (pid == 0)
+    {
+        // Only async-signal-safe calls between fork and exec
+        setsid();
+        int nullFile = open("/dev/null", O_RDWR);
+        dup2(nullFile, STDIN_FILENO);
+        dup2(nullFile, STDOUT_FILENO);
+        dup2(nullFile, STDERR_FILENO);
+        execv(argv[0], argv);
+        _exit(127);
+    }
+    return NULL;
+
+    #else
+
+    posix_spawn_file_actions_t actions;
+    if (posix_spawn_file_actions_init(&actions) != 0)
+        return "posix_spawn_file_actions_init() failed";
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+    posix_spawnattr_t attr;
+    if (posix_spawnattr_init(&attr) != 0)
+    {
+        posix_spawn_file_actions_destroy(&actions);
+        return "posix_spawnattr_init() failed";
+    }
+    #ifdef POSIX_SPAWN_SETSID
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSID);
+    #else
+    // Own process group at least, so that ^C in the terminal doesn't reach it
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+    #endif
+
+    int error = posix_spawn(&pid, argv[0], &actions, &attr, argv, environ);
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+
+    return error == 0 ? NULL : "posix_spawn() failed";
+
+    #endif
+}
+
+const char* ffProcessReadOutput(FFProcessHandle* handle, FFstrbuf* buffer)
+{
+    if (handle->pid == 0)
+        return "Process was not spawned";
+
+    FFProcessChild child = {
+        .pid = handle->pid,
+        .pipeFd = handle->pipeRead,
+        .pidFd = -1,
+    };
+    FFProcessRequest request = { .buffer = buffer, .exitStatus = -1 };
+    waitChildren(&child, &request, 1);
+
+    handle->pid = 0;
+    handle->pipeRead = -1;
+    return request.error;
+}
+
+void ffProcessDiscard(FFProcessHandle* handle)
+{
+    if (handle->pid == 0)
+        return;
+
+    FFProcessChild child = {
+        .pid = handle->pid,
+        .pipeFd = handle->pipeRead,
+        .pidFd = -1,
     };
+    killChild(&child, NULL);
 
-    return "read(childPipeFd, str, FF_PIPE_BUFSIZ) failed";
+    handle->pid = 0;
+    handle->pipeRead = -1;
 }
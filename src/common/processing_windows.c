@@ -124,3 +124,29 @@ const char* ffProcessAppendOutput(FFstrbuf* buffer, char* const argv[], bool use
 
     return NULL;
 }
+
+void ffProcessAppendOutputs(FFProcessRequest* requests, uint32_t count)
+{
+    // Not parallelized on Windows
+    for (uint32_t i = 0; i < count; ++i)
+        requests[i].error = ffProcessAppendOutput(requests[i].buffer, requests[i].argv, requests[i].useStdErr);
+}
+
+const char* ffProcessSpawn(char* const argv[], bool useStdErr, FFProcessHandle* handle)
+{
+    ffStrbufInit(&handle->output);
+    handle->error = ffProcessAppendOutput(&handle->output, argv, useStdErr);
+    return handle->error;
+}
+
+const char* ffProcessReadOutput(FFProcessHandle* handle, FFstrbuf* buffer)
+{
+    ffStrbufAppend(buffer, &handle->output);
+    ffStrbufDestroy(&handle->output);
+    return handle->error;
+}
+
+void ffProcessDiscard(FFProcessHandle* handle)
+{
+    ffStrbufDestroy(&handle->output);
+}
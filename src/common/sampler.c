@@ -0,0 +1,145 @@
+#include "common/sampler.h"
+#include "common/time.h"
+
+static FFlist pendingSources; // List of FFSamplerSource*
+
+static void clearSnapshot(FFSamplerSource* source, FFlist* snapshot)
+{
+    if (source->destroy)
+    {
+        for (uint32_t i = 0; i < snapshot->length; ++i)
+            source->destroy(ffListGet(snapshot, i));
+    }
+    ffListClear(snapshot);
+}
+
+static inline uint32_t getIntervalCount(const FFSamplerSource* source)
+{
+    return source->intervals > 1 ? source->intervals : 1;
+}
+
+static void queueSource(FFSamplerSource* source)
+{
+    if (pendingSources.elementSize == 0)
+        ffListInit(&pendingSources, sizeof(FFSamplerSource*));
+
+    source->pending = true;
+    source->consumed = false;
+    source->tick = 0;
+    source->intermediateTime = source->times[0];
+    *(FFSamplerSource**) ffListAdd(&pendingSources) = source;
+}
+
+void ffSamplerStart(FFSamplerSource* source)
+{
+    if (ffSamplerStarted(source))
+        return;
+
+    ffListInit(&source->snapshots[0], source->elementSize);
+    ffListInit(&source->snapshots[1], source->elementSize);
+    ffListInit(&source->intermediate, source->elementSize);
+    source->error = source->snapshot(&source->snapshots[0], source->options);
+    source->times[0] = ffTimeGetTickNs();
+    queueSource(source);
+}
+
+static void restartSource(FFSamplerSource* source)
+{
+    // The last snapshot becomes the first one of the next window
+    clearSnapshot(source, &source->snapshots[0]);
+    FFlist temp = source->snapshots[0];
+    source->snapshots[0] = source->snapshots[1];
+    source->snapshots[1] = temp;
+    source->times[0] = source->times[1];
+    source->error = NULL;
+    queueSource(source);
+}
+
+static void takeSnapshot(FFSamplerSource* source, uint64_t now)
+{
+    bool last = ++source->tick == getIntervalCount(source);
+    const FFlist* previous = source->tick == 1 ? &source->snapshots[0] : &source->intermediate;
+
+    FFlist current;
+    ffListInit(&current, source->elementSize);
+    FFlist* target = last ? &source->snapshots[1] : &current;
+
+    if (!source->error)
+    {
+        source->error = source->snapshot(target, source->options);
+        if (!source->error && source->interval)
+            source->interval(source, previous, target, now - source->intermediateTime);
+    }
+
+    clearSnapshot(source, &source->intermediate);
+    if (last)
+    {
+        ffListDestroy(&current);
+        source->times[1] = now;
+        source->pending = false;
+    }
+    else
+    {
+        ffListDestroy(&source->intermediate);
+        source->intermediate = current;
+        source->intermediateTime = now;
+    }
+}
+
+// Sub intervals of every source are spread evenly over the shared window
+static inline uint64_t getNextSnapshotTime(const FFSamplerSource* source, uint64_t deadline)
+{
+    return source->times[0] + (deadline - source->times[0]) * (source->tick + 1) / getIntervalCount(source);
+}
+
+static void finishPendingSources(void)
+{
+    uint64_t deadline = 0;
+    FF_LIST_FOR_EACH(FFSamplerSource*, pSource, pendingSources)
+    {
+        uint64_t end = (*pSource)->times[0] + (*pSource)->window * 1000000ULL;
+        if (end > deadline) deadline = end;
+    }
+
+    while (true)
+    {
+        uint64_t next = UINT64_MAX;
+        FF_LIST_FOR_EACH(FFSamplerSource*, pSource, pendingSources)
+        {
+            FFSamplerSource* source = *pSource;
+            if (!source->pending) continue;
+            uint64_t time = getNextSnapshotTime(source, deadline);
+            if (time < next) next = time;
+        }
+        if (next == UINT64_MAX) break;
+
+        uint64_t now = ffTimeGetTickNs();
+        while (now < next)
+        {
+            ffTimeSleep((uint32_t) ((next - now + 999999) / 1000000));
+            now = ffTimeGetTickNs();
+        }
+
+        FF_LIST_FOR_EACH(FFSamplerSource*, pSource, pendingSources)
+        {
+            FFSamplerSource* source = *pSource;
+            if (source->pending && getNextSnapshotTime(source, deadline) <= now)
+                takeSnapshot(source, now);
+        }
+    }
+    ffListClear(&pendingSources);
+}
+
+const char* ffSamplerSample(FFSamplerSource* source)
+{
+    if (!ffSamplerStarted(source))
+        ffSamplerStart(source);
+    else if (source->consumed)
+        restartSource(source);
+
+    if (source->pending)
+        finishPendingSources();
+
+    source->consumed = true;
+    return source->error;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "util/FFlist.h"
+
+// Rate modules (CPUUsage, NetIO, DiskIO) compute their results from two snapshots of some counters.
+// First snapshots are taken at prepare time. The second snapshots of all started sources are taken together,
+// once the longest pending window has elapsed, so that these modules add a single window of latency in total.
+
+typedef struct FFSamplerSource FFSamplerSource;
+
+typedef const char* FFSamplerSnapshotFunc(FFlist* result, void* options);
+typedef void FFSamplerDestroyFunc(void* item);
+typedef void FFSamplerIntervalFunc(FFSamplerSource* source, const FFlist* previous, const FFlist* current, uint64_t elapsedNs);
+
+struct FFSamplerSource
+{
+    FFSamplerSnapshotFunc* snapshot;
+    FFSamplerDestroyFunc* destroy; // Frees what an item of a snapshot owns, may be NULL
+    FFSamplerIntervalFunc* interval; // Called for every pair of consecutive snapshots, may be NULL
+    uint32_t elementSize;
+    uint32_t window; // Minimum time in ms between the first and the last snapshot
+    uint32_t intervals; // Number of evenly spread sub intervals of the window, 0 or 1 for none
+    void* options;
+
+    FFlist snapshots[2]; // First and last
+    uint64_t times[2]; // ffTimeGetTickNs()
+    const char* error;
+    bool pending; // Waiting for the last snapshot
+    bool consumed; // The last snapshot has been used, sample again on next request
+
+    FFlist intermediate;
+    uint64_t intermediateTime;
+    uint32_t tick;
+};
+
+static inline bool ffSamplerStarted(const FFSamplerSource* source)
+{
+    return source->snapshots[0].elementSize != 0;
+}
+
+// Takes the first snapshot. Does nothing if the source has been started already
+void ffSamplerStart(FFSamplerSource* source);
+
+// Makes sure that both snapshots of the source are available, starting it if necessary.
+// Waits for the windows of all pending sources and takes their remaining snapshots
+const char* ffSamplerSample(FFSamplerSource* source);
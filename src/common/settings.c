@@ -29,7 +29,6 @@ typedef enum FFInitState
 #define FF_LIBRARY_DATA_LOAD_SYMBOL(symbolName) \
     data.ff ## symbolName = dlsym(libraryHandle, #symbolName); \
     if(data.ff ## symbolName == NULL) { \
-        dlclose(libraryHandle); \
         initState = FF_INITSTATE_FAILED; \
         return NULL; \
     }
@@ -40,7 +39,6 @@ typedef enum FFInitState
 
 #define FF_LIBRARY_DATA_LOAD_ERROR \
     { \
-        dlclose(libraryHandle); \
         initState = FF_INITSTATE_FAILED; \
         return NULL; \
     }
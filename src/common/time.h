@@ -24,6 +24,21 @@ static inline uint64_t ffTimeGetTick() //In msec
     #endif
 }
 
+static inline uint64_t ffTimeGetTickNs() //In nsec
+{
+    #ifdef _WIN32
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        LARGE_INTEGER start;
+        QueryPerformanceCounter(&start);
+        return (uint64_t)(start.QuadPart / frequency.QuadPart * 1000000000 + start.QuadPart % frequency.QuadPart * 1000000000 / frequency.QuadPart);
+    #else
+        struct timespec timeNow;
+        clock_gettime(CLOCK_MONOTONIC, &timeNow);
+        return (uint64_t)timeNow.tv_sec * 1000000000 + (uint64_t)timeNow.tv_nsec;
+    #endif
+}
+
 static inline uint64_t ffTimeGetNow()
 {
     #ifdef _WIN32
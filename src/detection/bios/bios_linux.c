@@ -4,12 +4,43 @@
 
 #include <stdlib.h>
 
+static bool detectFromSmbios(FFBiosResult *bios)
+{
+    const FFSmbiosHeaderTable* smbiosTable = ffGetSmbiosHeaderTable();
+    if (!smbiosTable)
+        return false;
+
+    const FFSmbiosBios* data = (const FFSmbiosBios*) (*smbiosTable)[FF_SMBIOS_TYPE_BIOS];
+    if (!data)
+        return false;
+
+    const char* strings = (const char*) data + data->Header.Length;
+
+    ffStrbufSetStatic(&bios->version, ffSmbiosLocateString(strings, data->BiosVersion));
+    ffCleanUpSmbiosValue(&bios->version);
+    ffStrbufSetStatic(&bios->vendor, ffSmbiosLocateString(strings, data->Vendor));
+    ffCleanUpSmbiosValue(&bios->vendor);
+    ffStrbufSetStatic(&bios->date, ffSmbiosLocateString(strings, data->BiosReleaseDate));
+    ffCleanUpSmbiosValue(&bios->date);
+
+    // 0xFF means unsupported; the kernel doesn't export `bios_release` then
+    if (data->Header.Length > offsetof(FFSmbiosBios, SystemBiosMinorRelease) && data->SystemBiosMajorRelease != 0xFF)
+        ffStrbufSetF(&bios->release, "%u.%u", data->SystemBiosMajorRelease, data->SystemBiosMinorRelease);
+
+    return true;
+}
+
 const char *ffDetectBios(FFBiosResult *bios)
 {
-    ffGetSmbiosValue("/sys/devices/virtual/dmi/id/bios_date", "/sys/class/dmi/id/bios_date", &bios->date);
-    ffGetSmbiosValue("/sys/devices/virtual/dmi/id/bios_release", "/sys/class/dmi/id/bios_release", &bios->release);
-    ffGetSmbiosValue("/sys/devices/virtual/dmi/id/bios_vendor", "/sys/class/dmi/id/bios_vendor", &bios->vendor);
-    ffGetSmbiosValue("/sys/devices/virtual/dmi/id/bios_version", "/sys/class/dmi/id/bios_version", &bios->version);
+    // /sys/firmware/dmi/tables/DMI is only readable by root. Use the per-value files of the kernel otherwise
+    if (!detectFromSmbios(bios))
+    {
+        ffGetSmbiosValue("/sys/devices/virtual/dmi/id/bios_date", "/sys/class/dmi/id/bios_date", &bios->date);
+        ffGetSmbiosValue("/sys/devices/virtual/dmi/id/bios_release", "/sys/class/dmi/id/bios_release", &bios->release);
+        ffGetSmbiosValue("/sys/devices/virtual/dmi/id/bios_vendor", "/sys/class/dmi/id/bios_vendor", &bios->vendor);
+        ffGetSmbiosValue("/sys/devices/virtual/dmi/id/bios_version", "/sys/class/dmi/id/bios_version", &bios->version);
+    }
+
     if (ffPathExists("/sys/firmware/efi", FF_PATHTYPE_DIRECTORY) || ffPathExists("/sys/firmware/acpi/tables/UEFI", FF_PATHTYPE_FILE))
         ffStrbufSetStatic(&bios->type, "UEFI");
     else
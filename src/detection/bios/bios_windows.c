@@ -26,32 +26,6 @@ typedef struct _SYSTEM_BOOT_ENVIRONMENT_INFORMATION
     };
 } SYSTEM_BOOT_ENVIRONMENT_INFORMATION;
 
-
-typedef struct FFSmbiosBios
-{
-    FFSmbiosHeader Header;
-
-    uint8_t Vendor; // string
-    uint8_t BiosVersion; // string
-    uint16_t BiosStartingAddressSegment; // varies
-    uint8_t BiosReleaseDate; // string
-    uint8_t BiosRomSize; // string
-    uint64_t BiosCharacteristics; // bit field
-
-    // 2.4+
-    uint8_t BiosCharacteristicsExtensionBytes[2]; // bit field
-    uint8_t SystemBiosMajorRelease; // varies
-    uint8_t SystemBiosMinorRelease; // varies
-    uint8_t EmbeddedControllerFirmwareMajorRelease; // varies
-    uint8_t EmbeddedControllerFirmwareMinorRelease; // varies
-
-    // 3.1+
-    uint16_t ExtendedBiosRomSize; // bit field
-} __attribute__((__packed__)) FFSmbiosBios;
-
-static_assert(offsetof(FFSmbiosBios, ExtendedBiosRomSize) == 0x18,
-    "FFSmbiosBios: Wrong struct alignment");
-
 const char* ffDetectBios(FFBiosResult* bios)
 {
     const FFSmbiosHeaderTable* smbiosTable = ffGetSmbiosHeaderTable();
@@ -0,0 +1,384 @@
+#include "blockdev_linux.h"
+#include "common/io/io.h"
+#include "util/stringUtils.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#ifdef FF_HAVE_THREADS
+    #include <pthread.h>
+#endif
+
+static FFlist devices; // List of FFBlockDevInfo, sorted by dev
+
+// Basic\x20data\x20partition
+static void decodeString(FFstrbuf* str)
+{
+    for (uint32_t i = ffStrbufFirstIndexS(str, "\\x");
+        i != str->length;
+        i = ffStrbufNextIndexS(str, i + 1, "\\x"))
+    {
+        uint32_t len = (uint32_t) strlen("\\x20");
+        if (str->length >= i + len)
+        {
+            char bak = str->chars[i + len];
+            str->chars[i + len] = '\0';
+            str->chars[i] = (char) strtoul(&str->chars[i + 2], NULL, 16);
+            ffStrbufRemoveSubstr(str, i + 1, i + len);
+            str->chars[i + 1] = bak;
+        }
+    }
+}
+
+static FFBlockDevInfo* addDevice(dev_t dev)
+{
+    FF_LIST_FOR_EACH(FFBlockDevInfo, info, devices)
+    {
+        if (info->dev == dev)
+            return info;
+    }
+
+    FFBlockDevInfo* info = (FFBlockDevInfo*) ffListAdd(&devices);
+    info->dev = dev;
+    ffStrbufInit(&info->label);
+    ffStrbufInit(&info->partLabel);
+    ffStrbufInit(&info->uuid);
+    ffStrbufInit(&info->model);
+    return info;
+}
+
+static void setProperty(FFstrbuf* property, const char* value, uint32_t length)
+{
+    ffStrbufSetNS(property, length, value);
+    decodeString(property);
+}
+
+// /run/udev/data/b<major>:<minor>, lines of `E:KEY=value`
+static bool readUdevDatabase(void)
+{
+    FF_AUTO_CLOSE_DIR DIR* dir = opendir("/run/udev/data/");
+    if (dir == NULL)
+        return false;
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreateS("/run/udev/data/");
+    uint32_t baseLength = path.length;
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        unsigned major, minor;
+        if (entry->d_name[0] != 'b' || sscanf(entry->d_name, "b%u:%u", &major, &minor) != 2)
+            continue;
+
+        ffStrbufAppendS(&path, entry->d_name);
+        bool ok = ffReadFileBuffer(path.chars, &content);
+        ffStrbufSubstrBefore(&path, baseLength);
+        if (!ok) continue;
+
+        FFBlockDevInfo* info = addDevice(makedev(major, minor));
+
+        for (uint32_t start = 0; start < content.length; )
+        {
+            uint32_t end = ffStrbufNextIndexC(&content, start, '\n');
+            const char* line = content.chars + start;
+            uint32_t lineLength = end - start;
+            start = end + 1;
+
+            if (lineLength < 2 || line[0] != 'E' || line[1] != ':')
+                continue;
+            line += 2;
+            lineLength -= 2;
+
+            #define FF_UDEV_PROPERTY(key, property) \
+                if (lineLength > strlen(key "=") && memcmp(line, key "=", strlen(key "=")) == 0) \
+                { \
+                    setProperty(property, line + strlen(key "="), lineLength - (uint32_t) strlen(key "=")); \
+                    continue; \
+                }
+
+            FF_UDEV_PROPERTY("ID_FS_LABEL_ENC", &info->label)
+            FF_UDEV_PROPERTY("ID_PART_ENTRY_NAME", &info->partLabel)
+            FF_UDEV_PROPERTY("ID_FS_UUID_ENC", &info->uuid)
+            FF_UDEV_PROPERTY("ID_MODEL_ENC", &info->model)
+
+            #undef FF_UDEV_PROPERTY
+        }
+        ffStrbufTrimRightSpace(&info->model);
+    }
+
+    return true;
+}
+
+// One stat per link, instead of one per link and disk
+static void readDevDiskLinks(const char* basePath, size_t offset)
+{
+    FF_AUTO_CLOSE_DIR DIR* dir = opendir(basePath);
+    if (dir == NULL)
+        return;
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreateS(basePath);
+    uint32_t baseLength = path.length;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] == '.')
+            continue;
+
+        ffStrbufAppendS(&path, entry->d_name);
+        struct stat st;
+        bool ok = stat(path.chars, &st) == 0 && S_ISBLK(st.st_mode);
+        ffStrbufSubstrBefore(&path, baseLength);
+        if (!ok) continue;
+
+        FFstrbuf* property = (FFstrbuf*) ((uint8_t*) addDevice(st.st_rdev) + offset);
+        if (property->length == 0)
+            setProperty(property, entry->d_name, (uint32_t) strlen(entry->d_name));
+    }
+}
+
+static int compareDevices(const FFBlockDevInfo* a, const FFBlockDevInfo* b)
+{
+    return a->dev < b->dev ? -1 : a->dev > b->dev;
+}
+
+static void buildDevices(void)
+{
+    ffListInit(&devices, sizeof(FFBlockDevInfo));
+
+    if (!readUdevDatabase())
+    {
+        // No udev (containers, mdev, ...)
+        readDevDiskLinks("/dev/disk/by-label/", offsetof(FFBlockDevInfo, label));
+        readDevDiskLinks("/dev/disk/by-partlabel/", offsetof(FFBlockDevInfo, partLabel));
+        readDevDiskLinks("/dev/disk/by-uuid/", offsetof(FFBlockDevInfo, uuid));
+    }
+
+    ffListSort(&devices, (const void*) compareDevices);
+}
+
+const FFBlockDevInfo* ffBlockDevGetInfo(dev_t dev)
+{
+    #ifdef FF_HAVE_THREADS
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    pthread_once(&once, buildDevices);
+    #else
+    if (devices.elementSize == 0)
+        buildDevices();
+    #endif
+
+    FFBlockDevInfo key = { .dev = dev };
+    return (const FFBlockDevInfo*) bsearch(&key, devices.data, devices.length, devices.elementSize, (const void*) compareDevices);
+}
+
+static FFlist blockDevices; // List of FFBlockDevice
+
+static void detectDeviceName(FFBlockDevice* device)
+{
+    if (ffAppendFileBufferRelative(device->sysfd, "device/vendor", &device->name))
+    {
+        ffStrbufTrimRightSpace(&device->name);
+        if (device->name.length > 0)
+            ffStrbufAppendC(&device->name, ' ');
+    }
+
+    ffAppendFileBufferRelative(device->sysfd, "device/model", &device->name);
+    ffStrbufTrimRightSpace(&device->name);
+
+    if (device->name.length == 0)
+    {
+        // e.g. virtio disks; udev may still know a model from the device's identify data
+        const FFBlockDevInfo* info = ffBlockDevGetInfo(device->dev);
+        if (info && info->model.length)
+            ffStrbufSet(&device->name, &info->model);
+        else
+            ffStrbufSetS(&device->name, device->devName);
+    }
+    else if (ffStrStartsWith(device->devName, "nvme"))
+    {
+        int devid, nsid;
+        if (sscanf(device->devName, "nvme%dn%d", &devid, &nsid) == 2)
+        {
+            bool multiNs = nsid > 1;
+            if (!multiNs)
+            {
+                char path[64];
+                snprintf(path, sizeof(path), "device/nvme%dn2", devid);
+                struct stat st;
+                multiNs = fstatat(device->sysfd, path, &st, 0) == 0 && S_ISDIR(st.st_mode);
+            }
+            if (multiNs)
+            {
+                // In Asahi Linux, there are multiple namespaces for the same NVMe drive.
+                ffStrbufAppendF(&device->name, " - %d", nsid);
+            }
+        }
+    }
+}
+
+static int8_t readFlag(int sysfd, const char* fileName)
+{
+    char value;
+    if (ffReadFileDataRelative(sysfd, fileName, 1, &value) != 1)
+        return -1;
+    return value == '1';
+}
+
+// `major:minor`
+static bool readDevNumber(int sysfd, dev_t* dev)
+{
+    char buffer[32];
+    ssize_t length = ffReadFileDataRelative(sysfd, "dev", sizeof(buffer) - 1, buffer);
+    if (length <= 0)
+        return false;
+    buffer[length] = '\0';
+
+    unsigned major, minor;
+    if (sscanf(buffer, "%u:%u", &major, &minor) != 2)
+        return false;
+
+    *dev = makedev(major, minor);
+    return true;
+}
+
+// NVMe: device/hwmonN; drivetemp (SATA): device/hwmon/hwmonN
+static void detectHwmonPath(FFBlockDevice* device)
+{
+    static const char* subdirs[] = { "device/", "device/hwmon/" };
+
+    for (uint32_t i = 0; i < sizeof(subdirs) / sizeof(*subdirs); ++i)
+    {
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "/sys/block/%s/%s", device->devName, subdirs[i]);
+
+        FF_AUTO_CLOSE_DIR DIR* dir = opendir(path);
+        if (!dir) continue;
+
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL)
+        {
+            if (!ffStrStartsWith(entry->d_name, "hwmon") || entry->d_name[strlen("hwmon")] == '\0')
+                continue;
+
+            ffStrbufSetF(&device->hwmonPath, "%s%s/temp1_input", path, entry->d_name);
+            if (ffPathExists(device->hwmonPath.chars, FF_PATHTYPE_FILE))
+                return;
+            ffStrbufClear(&device->hwmonPath);
+        }
+    }
+}
+
+static void buildBlockDevices(void)
+{
+    ffListInit(&blockDevices, sizeof(FFBlockDevice));
+
+    FF_AUTO_CLOSE_DIR DIR* sysBlockDirp = opendir("/sys/block/");
+    if (sysBlockDirp == NULL)
+        return;
+
+    struct dirent* sysBlockEntry;
+    while ((sysBlockEntry = readdir(sysBlockDirp)) != NULL)
+    {
+        const char* const devName = sysBlockEntry->d_name;
+
+        if (devName[0] == '.' || strlen(devName) >= sizeof(((FFBlockDevice*) NULL)->devName))
+            continue;
+
+        char pathSysDeviceReal[PATH_MAX];
+        ssize_t pathLength = readlinkat(dirfd(sysBlockDirp), devName, pathSysDeviceReal, sizeof(pathSysDeviceReal) - 1);
+        if (pathLength < 0)
+            continue;
+        pathSysDeviceReal[pathLength] = '\0';
+
+        if (strstr(pathSysDeviceReal, "/virtual/")) // virtual device
+            continue;
+
+        int sysfd = openat(dirfd(sysBlockDirp), devName, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (sysfd < 0)
+            continue;
+
+        struct stat st;
+        dev_t dev;
+        if (fstatat(sysfd, "device", &st, 0) != 0 || !S_ISDIR(st.st_mode) || !readDevNumber(sysfd, &dev))
+        {
+            close(sysfd);
+            continue;
+        }
+
+        FFBlockDevice* device = (FFBlockDevice*) ffListAdd(&blockDevices);
+        strcpy(device->devName, devName);
+        device->dev = dev;
+        device->sysfd = sysfd;
+        ffStrbufInitNS(&device->sysPath, (uint32_t) pathLength, pathSysDeviceReal);
+        ffStrbufInit(&device->name);
+        ffStrbufInit(&device->hwmonPath);
+        detectDeviceName(device);
+        detectHwmonPath(device);
+
+        char size[32];
+        ssize_t sizeLength = ffReadFileDataRelative(sysfd, "size", sizeof(size) - 1, size);
+        if (sizeLength > 0)
+        {
+            size[sizeLength] = '\0';
+            device->size = strtoull(size, NULL, 10) * 512;
+        }
+        else
+            device->size = 0;
+
+        device->rotational = readFlag(sysfd, "queue/rotational");
+        device->removable = readFlag(sysfd, "removable");
+        device->readOnly = readFlag(sysfd, "ro");
+    }
+}
+
+const FFlist* ffBlockDevGetDevices(void)
+{
+    #ifdef FF_HAVE_THREADS
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    pthread_once(&once, buildBlockDevices);
+    #else
+    if (blockDevices.elementSize == 0)
+        buildBlockDevices();
+    #endif
+
+    return &blockDevices;
+}
+
+const FFBlockDevice* ffBlockDevFindDevice(dev_t dev)
+{
+    const FFlist* devices = ffBlockDevGetDevices();
+
+    FF_LIST_FOR_EACH(FFBlockDevice, device, *devices)
+    {
+        if (device->dev == dev)
+            return device;
+    }
+
+    // A partition: /sys/dev/block/8:1 -> ../../devices/.../block/sda/sda1
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/dev/block/%u:%u", major(dev), minor(dev));
+    char target[PATH_MAX];
+    ssize_t length = readlink(path, target, sizeof(target) - 1);
+    if (length <= 0)
+        return NULL;
+    target[length] = '\0';
+
+    char* slash = strrchr(target, '/');
+    if (!slash) return NULL;
+    *slash = '\0';
+    const char* parentName = strrchr(target, '/');
+    parentName = parentName ? parentName + 1 : target;
+
+    FF_LIST_FOR_EACH(FFBlockDevice, device, *devices)
+    {
+        if (ffStrEquals(device->devName, parentName))
+            return device;
+    }
+    return NULL;
+}
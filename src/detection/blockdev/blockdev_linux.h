@@ -0,0 +1,38 @@
+#pragma once
+
+#include "fastfetch.h"
+
+#include <sys/types.h>
+
+typedef struct FFBlockDevInfo
+{
+    dev_t dev;
+    FFstrbuf label;
+    FFstrbuf partLabel;
+    FFstrbuf uuid;
+    FFstrbuf model;
+} FFBlockDevInfo;
+
+// Label, partition label, UUID and model of a block device, looked up by device number (`st_rdev`).
+// All devices are read once, from udev's database or from the `/dev/disk/by-*` links. Thread safe
+const FFBlockDevInfo* ffBlockDevGetInfo(dev_t dev);
+
+typedef struct FFBlockDevice
+{
+    char devName[32]; // e.g. `sda`, `nvme0n1`
+    dev_t dev;
+    int sysfd; // Directory fd of /sys/block/<devName>/, kept open for further reads with ffReadFileDataRelative
+    FFstrbuf sysPath; // Target of the /sys/block/<devName> link, e.g. `../devices/pci0000:00/.../block/sda`
+    FFstrbuf name; // Vendor and model, udev model or devName
+    FFstrbuf hwmonPath; // temp1_input of the drive's hwmon device, or empty
+    uint64_t size; // In bytes
+    int8_t rotational; // -1 if unknown
+    int8_t removable; // -1 if unknown
+    int8_t readOnly; // -1 if unknown
+} FFBlockDevice;
+
+// Physical (non-virtual) whole disks from /sys/block. Built once and shared by Disk, PhysicalDisk and DiskIO. Thread safe
+const FFlist* /* List of FFBlockDevice */ ffBlockDevGetDevices(void);
+
+// The disk of a device number; partitions resolve to the disk containing them. NULL if not a physical disk
+const FFBlockDevice* ffBlockDevFindDevice(dev_t dev);
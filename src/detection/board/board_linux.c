@@ -4,8 +4,35 @@
 
 #include <stdlib.h>
 
+static bool detectFromSmbios(FFBoardResult* board)
+{
+    const FFSmbiosHeaderTable* smbiosTable = ffGetSmbiosHeaderTable();
+    if (!smbiosTable)
+        return false;
+
+    const FFSmbiosBaseboard* data = (const FFSmbiosBaseboard*) (*smbiosTable)[FF_SMBIOS_TYPE_BASEBOARD_INFO];
+    if (!data)
+        return false;
+
+    const char* strings = (const char*) data + data->Header.Length;
+
+    ffStrbufSetStatic(&board->name, ffSmbiosLocateString(strings, data->Product));
+    ffCleanUpSmbiosValue(&board->name);
+    ffStrbufSetStatic(&board->serial, ffSmbiosLocateString(strings, data->SerialNumber));
+    ffCleanUpSmbiosValue(&board->serial);
+    ffStrbufSetStatic(&board->vendor, ffSmbiosLocateString(strings, data->Manufacturer));
+    ffCleanUpSmbiosValue(&board->vendor);
+    ffStrbufSetStatic(&board->version, ffSmbiosLocateString(strings, data->Version));
+    ffCleanUpSmbiosValue(&board->version);
+
+    return true;
+}
+
 const char* ffDetectBoard(FFBoardResult* board)
 {
+    if (detectFromSmbios(board))
+        return NULL;
+
     ffGetSmbiosValue("/sys/devices/virtual/dmi/id/board_name", "/sys/class/dmi/id/board_name", &board->name);
     ffGetSmbiosValue("/sys/devices/virtual/dmi/id/board_serial", "/sys/class/dmi/id/board_serial", &board->serial);
     ffGetSmbiosValue("/sys/devices/virtual/dmi/id/board_vendor", "/sys/class/dmi/id/board_vendor", &board->vendor);
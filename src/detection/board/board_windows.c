@@ -1,26 +1,6 @@
 #include "board.h"
 #include "util/smbiosHelper.h"
 
-typedef struct FFSmbiosBaseboard
-{
-    FFSmbiosHeader Header;
-
-    uint8_t Manufacturer; // string
-    uint8_t Product; // string
-    uint8_t Version; // string
-    uint8_t SerialNumber; // string
-    uint8_t AssetTag; // string
-    uint8_t FeatureFlags; // bit field
-    uint8_t LocationInChassis; // string
-    uint16_t ChassisHandle; // varies
-    uint8_t BoardType; // enum
-    uint8_t NumberOfContainedObjectHandles; // varies
-    uint16_t ContainedObjectHandles[]; // varies
-} __attribute__((__packed__)) FFSmbiosBaseboard;
-
-static_assert(offsetof(FFSmbiosBaseboard, ContainedObjectHandles) == 0x0F,
-    "FFSmbiosBaseboard: Wrong struct alignment");
-
 const char* ffDetectBoard(FFBoardResult* board)
 {
     const FFSmbiosHeaderTable* smbiosTable = ffGetSmbiosHeaderTable();
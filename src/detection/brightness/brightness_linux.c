@@ -123,7 +123,6 @@ static const char* detectWithDdcci(FFBrightnessOptions* options, FFlist* result)
         if (ffddca_set_default_sleep_multiplier)
             ffddca_set_default_sleep_multiplier(options->ddcciSleep / 40.0);
 
-        libddcutil = NULL; // Don't dlclose libddcutil. See https://github.com/rockowitz/ddcutil/issues/330
     }
 
     FF_AUTO_FREE DDCA_Display_Info_List* infoList = NULL;
@@ -4,8 +4,39 @@
 
 #include <stdlib.h>
 
+static bool detectFromSmbios(FFChassisResult* result)
+{
+    const FFSmbiosHeaderTable* smbiosTable = ffGetSmbiosHeaderTable();
+    if (!smbiosTable)
+        return false;
+
+    const FFSmbiosSystemEnclosure* data = (const FFSmbiosSystemEnclosure*) (*smbiosTable)[FF_SMBIOS_TYPE_SYSTEM_ENCLOSURE];
+    if (!data)
+        return false;
+
+    const char* strings = (const char*) data + data->Header.Length;
+
+    ffStrbufSetStatic(&result->vendor, ffSmbiosLocateString(strings, data->Manufacturer));
+    ffCleanUpSmbiosValue(&result->vendor);
+    ffStrbufSetStatic(&result->serial, ffSmbiosLocateString(strings, data->SerialNumber));
+    ffCleanUpSmbiosValue(&result->serial);
+    ffStrbufSetStatic(&result->version, ffSmbiosLocateString(strings, data->Version));
+    ffCleanUpSmbiosValue(&result->version);
+
+    const char* typeStr = ffChassisTypeToString(data->Type);
+    if (typeStr)
+        ffStrbufSetStatic(&result->type, typeStr);
+    else
+        ffStrbufSetF(&result->type, "%u", data->Type & 0x7F);
+
+    return true;
+}
+
 const char* ffDetectChassis(FFChassisResult* result)
 {
+    if (detectFromSmbios(result))
+        return NULL;
+
     ffGetSmbiosValue("/sys/devices/virtual/dmi/id/chassis_type", "/sys/class/dmi/id/chassis_type", &result->type);
     ffGetSmbiosValue("/sys/devices/virtual/dmi/id/chassis_serial", "/sys/class/dmi/id/chassis_serial", &result->serial);
     ffGetSmbiosValue("/sys/devices/virtual/dmi/id/chassis_vendor", "/sys/class/dmi/id/chassis_vendor", &result->vendor);
@@ -1,61 +1,67 @@
 #include "fastfetch.h"
 #include "detection/cpuusage/cpuusage.h"
+#include "common/sampler.h"
 #include "common/time.h"
 
 #include <stdint.h>
 
-static FFlist cpuTimes1;
+static const char* snapshot(FFlist* result, FF_MAYBE_UNUSED void* options)
+{
+    return ffGetCpuUsageInfo(result);
+}
+
+static FFSamplerSource source = {
+    .snapshot = snapshot,
+    .elementSize = sizeof(FFCpuUsageInfo),
+};
 
 void ffPrepareCPUUsage(void)
 {
-    assert(cpuTimes1.elementSize == 0);
-    ffListInit(&cpuTimes1, sizeof(FFCpuUsageInfo));
-    ffGetCpuUsageInfo(&cpuTimes1);
+    // CPU usage is a ratio of counters, any time elapsed between prepare and print will do
+    source.window = 0;
+    ffSamplerStart(&source);
 }
 
 const char* ffGetCpuUsageResult(FFlist* result)
 {
-    const char* error = NULL;
-    if(cpuTimes1.elementSize == 0)
-    {
-        ffListInit(&cpuTimes1, sizeof(FFCpuUsageInfo));
-        error = ffGetCpuUsageInfo(&cpuTimes1);
-        if(error) return error;
-        ffTimeSleep(200);
-    }
+    if(!ffSamplerStarted(&source))
+        source.window = 200;
 
-    if(cpuTimes1.length == 0) return "No CPU cores found";
+    const char* error = ffSamplerSample(&source);
+    if(error) return error;
+
+    FFlist* cpuTimes1 = &source.snapshots[0];
+    FFlist* cpuTimes2 = &source.snapshots[1];
+
+    if(cpuTimes1->length == 0) return "No CPU cores found";
 
-    FF_LIST_AUTO_DESTROY cpuTimes2 = ffListCreate(sizeof(FFCpuUsageInfo));
     uint32_t retryCount = 0;
 
 retry:
-    error = ffGetCpuUsageInfo(&cpuTimes2);
-    if(error) return error;
-    if(cpuTimes1.length != cpuTimes2.length) return "Unexpected CPU usage result";
+    if(cpuTimes1->length != cpuTimes2->length) return "Unexpected CPU usage result";
 
-    for (uint32_t i = 0; i < cpuTimes1.length; ++i)
+    for (uint32_t i = 0; i < cpuTimes1->length; ++i)
     {
-        FFCpuUsageInfo* cpuTime1 = ffListGet(&cpuTimes1, i);
-        FFCpuUsageInfo* cpuTime2 = ffListGet(&cpuTimes2, i);
+        FFCpuUsageInfo* cpuTime1 = ffListGet(cpuTimes1, i);
+        FFCpuUsageInfo* cpuTime2 = ffListGet(cpuTimes2, i);
         if (cpuTime2->totalAll <= cpuTime1->totalAll)
         {
             if (++retryCount <= 3)
             {
-                ffListClear(&cpuTimes2);
+                ffListClear(cpuTimes2);
                 ffTimeSleep(200);
+                error = ffGetCpuUsageInfo(cpuTimes2);
+                if(error) return error;
                 goto retry;
             }
         }
     }
 
-    for (uint32_t i = 0; i < cpuTimes1.length; ++i)
+    for (uint32_t i = 0; i < cpuTimes1->length; ++i)
     {
-        FFCpuUsageInfo* cpuTime1 = ffListGet(&cpuTimes1, i);
-        FFCpuUsageInfo* cpuTime2 = ffListGet(&cpuTimes2, i);
+        FFCpuUsageInfo* cpuTime1 = ffListGet(cpuTimes1, i);
+        FFCpuUsageInfo* cpuTime2 = ffListGet(cpuTimes2, i);
         *(double*) ffListAdd(result) = (double)(cpuTime2->inUseAll - cpuTime1->inUseAll) / (double)(cpuTime2->totalAll - cpuTime1->totalAll) * 100;
-        cpuTime1->inUseAll = cpuTime2->inUseAll;
-        cpuTime1->totalAll = cpuTime2->totalAll;
     }
     return NULL;
 }
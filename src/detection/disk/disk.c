@@ -44,7 +44,9 @@ const char* ffDetectDisks(FFDiskOptions* options, FFlist* disks)
     ffListSort(disks, (void*) compareDisks);
     FF_LIST_FOR_EACH(FFDisk, disk, *disks)
     {
-        if(disk->bytesTotal == 0)
+        if(disk->type & FF_DISK_VOLUME_TYPE_UNRESPONSIVE_BIT)
+            continue;
+        else if(disk->bytesTotal == 0)
             disk->type |= FF_DISK_VOLUME_TYPE_UNKNOWN_BIT;
         else
         {
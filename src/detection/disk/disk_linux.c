@@ -1,6 +1,7 @@
 #include "disk.h"
 
 #include "common/io/io.h"
+#include "detection/blockdev/blockdev_linux.h"
 #include "util/stringUtils.h"
 
 #include <limits.h>
@@ -76,71 +77,21 @@ static bool isPhysicalDevice(const struct mntent* device)
     return true;
 }
 
-static void detectNameFromPath(FFDisk* disk, const struct stat* deviceStat, FFstrbuf* basePath)
-{
-    FF_AUTO_CLOSE_DIR DIR* dir = opendir(basePath->chars);
-    if(dir == NULL)
-        return;
-
-    uint32_t basePathLength = basePath->length;
-
-    struct dirent* entry;
-    while((entry = readdir(dir)) != NULL)
-    {
-        if(entry->d_name[0] == '.')
-            continue;
-
-        ffStrbufAppendS(basePath, entry->d_name);
-
-        struct stat entryStat;
-        bool ret = stat(basePath->chars, &entryStat) == 0;
-
-        ffStrbufSubstrBefore(basePath, basePathLength);
-
-        if(!ret || deviceStat->st_ino != entryStat.st_ino)
-            continue;
-
-        ffStrbufAppendS(&disk->name, entry->d_name);
-        break;
-    }
-}
-
 static void detectName(FFDisk* disk)
 {
     struct stat deviceStat;
-    if(stat(disk->mountFrom.chars, &deviceStat) != 0)
+    if(stat(disk->mountFrom.chars, &deviceStat) != 0 || !S_ISBLK(deviceStat.st_mode))
         return;
 
-    FF_STRBUF_AUTO_DESTROY basePath = ffStrbufCreate();
-
-    //Try label first
-    ffStrbufSetS(&basePath, "/dev/disk/by-label/");
-    detectNameFromPath(disk, &deviceStat, &basePath);
-
-    if(disk->name.length == 0)
-    {
-        //Try partlabel second
-        ffStrbufSetS(&basePath, "/dev/disk/by-partlabel/");
-        detectNameFromPath(disk, &deviceStat, &basePath);
-    }
-
-    if (disk->name.length == 0) return;
+    const FFBlockDevInfo* info = ffBlockDevGetInfo(deviceStat.st_rdev);
+    if(info == NULL)
+        return;
 
-    // Basic\x20data\x20partition
-    for (uint32_t i = ffStrbufFirstIndexS(&disk->name, "\\x");
-        i != disk->name.length;
-        i = ffStrbufNextIndexS(&disk->name, i + 1, "\\x"))
-    {
-        uint32_t len = (uint32_t) strlen("\\x20");
-        if (disk->name.length >= len)
-        {
-            char bak = disk->name.chars[i + len];
-            disk->name.chars[i + len] = '\0';
-            disk->name.chars[i] = (char) strtoul(&disk->name.chars[i + 2], NULL, 16);
-            ffStrbufRemoveSubstr(&disk->name, i + 1, i + len);
-            disk->name.chars[i + 1] = bak;
-        }
-    }
+    //Try label first, partlabel second
+    if(info->label.length)
+        ffStrbufSet(&disk->name, &info->label);
+    else
+        ffStrbufSet(&disk->name, &info->partLabel);
 }
 
 #ifdef __ANDROID__
@@ -199,16 +150,13 @@ static bool isRemovable(FFDisk* currentDisk)
     if (!ffStrbufStartsWithS(&currentDisk->mountFrom, "/dev/"))
         return false;
 
-    char sysBlockPartition[64];
-    snprintf(sysBlockPartition, sizeof(sysBlockPartition), "/sys/class/block/%s", currentDisk->mountFrom.chars + strlen("/dev/"));
-
-    char sysBlockVolume[PATH_MAX]; // /sys/devices/pci0000:00/0000:00:14.0/usb4/4-3/4-3:1.0/host0/target0:0:0/0:0:0:0/block/sda/sda1
-    if (realpath(sysBlockPartition, sysBlockVolume) == NULL)
+    struct stat deviceStat;
+    if (stat(currentDisk->mountFrom.chars, &deviceStat) != 0 || !S_ISBLK(deviceStat.st_mode))
         return false;
-    strcpy(strrchr(sysBlockVolume, '/') + 1, "removable");
 
-    char removableChar = '0';
-    return ffReadFileData(sysBlockVolume, 1, &removableChar) > 0 && removableChar == '1';
+    // The disk containing the partition, from the inventory shared with PhysicalDisk and DiskIO
+    const FFBlockDevice* device = ffBlockDevFindDevice(deviceStat.st_rdev);
+    return device && device->removable == 1;
 }
 
 static void detectType(const FFlist* disks, FFDisk* currentDisk)
@@ -250,6 +198,254 @@ static void detectStats(FFDisk* disk)
     #endif
 }
 
+#ifdef FF_HAVE_THREADS
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Name and stats of one mount, queried by a worker of the pool.
+// A query that misses its deadline is abandoned: it is removed from the pool and freed by its worker once the kernel returns
+typedef struct FFDiskQuery
+{
+    FFDisk disk;
+    struct timespec deadline; // Set when a worker starts the query
+    bool started;
+    bool done;
+    bool abandoned;
+} FFDiskQuery;
+
+// Workers take the queries in order. The pool is shared by the workers and detectNamesAndStats, and freed by whichever releases it last,
+// so that workers blocked on a dead mount don't keep fastfetch from returning.
+// Each worker stuck past a deadline is replaced, so that the queries queued behind it still get their own time budget
+#define FF_DISK_QUERY_WORKERS 4
+
+typedef struct FFDiskQueryPool
+{
+    FFDiskQuery** queries;
+    uint32_t count;
+    uint32_t next;
+    uint32_t refs;
+    uint32_t timeout;
+} FFDiskQueryPool;
+
+static pthread_mutex_t queryMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queryCond;
+static pthread_once_t queryCondOnce = PTHREAD_ONCE_INIT;
+
+static void initQueryCond(void)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&queryCond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+static void destroyQuery(FFDiskQuery* query)
+{
+    ffStrbufDestroy(&query->disk.mountFrom);
+    ffStrbufDestroy(&query->disk.mountpoint);
+    ffStrbufDestroy(&query->disk.name);
+    free(query);
+}
+
+// Must be called with queryMutex locked. Returns true if the caller has to free the pool
+static bool releasePool(FFDiskQueryPool* pool)
+{
+    return --pool->refs == 0;
+}
+
+static void freePool(FFDiskQueryPool* pool)
+{
+    // Queries that no worker got to before the last one left
+    for (; pool->next < pool->count; ++pool->next)
+    {
+        if (pool->queries[pool->next])
+            destroyQuery(pool->queries[pool->next]);
+    }
+    free(pool->queries);
+    free(pool);
+}
+
+static void* queryWorkerMain(void* data)
+{
+    FFDiskQueryPool* pool = (FFDiskQueryPool*) data;
+
+    pthread_mutex_lock(&queryMutex);
+    while (pool->next < pool->count)
+    {
+        FFDiskQuery* query = pool->queries[pool->next++];
+        if (!query)
+            continue;
+
+        query->started = true;
+        clock_gettime(CLOCK_MONOTONIC, &query->deadline);
+        query->deadline.tv_sec += pool->timeout / 1000;
+        query->deadline.tv_nsec += (long) (pool->timeout % 1000) * 1000000;
+        if (query->deadline.tv_nsec >= 1000000000)
+        {
+            ++query->deadline.tv_sec;
+            query->deadline.tv_nsec -= 1000000000;
+        }
+        pthread_cond_broadcast(&queryCond);
+        pthread_mutex_unlock(&queryMutex);
+
+        // Both may block forever on a dead network filesystem
+        detectName(&query->disk);
+        detectStats(&query->disk);
+
+        pthread_mutex_lock(&queryMutex);
+        query->done = true;
+        pthread_cond_broadcast(&queryCond);
+        if (query->abandoned)
+            destroyQuery(query);
+    }
+    bool last = releasePool(pool);
+    pthread_mutex_unlock(&queryMutex);
+
+    if (last)
+        freePool(pool);
+    return NULL;
+}
+
+// Must be called with queryMutex locked
+static bool startWorker(FFDiskQueryPool* pool)
+{
+    ++pool->refs;
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, queryWorkerMain, pool) != 0)
+    {
+        --pool->refs;
+        return false;
+    }
+    pthread_detach(thread);
+    return true;
+}
+
+static inline bool isBefore(const struct timespec* a, const struct timespec* b)
+{
+    return a->tv_sec < b->tv_sec || (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
+
+static void detectNamesAndStats(FFlist* disks, uint32_t timeout)
+{
+    pthread_once(&queryCondOnce, initQueryCond);
+
+    FFDiskQueryPool* pool = (FFDiskQueryPool*) calloc(1, sizeof(*pool));
+    pool->queries = (FFDiskQuery**) calloc(disks->length, sizeof(*pool->queries));
+    pool->count = disks->length;
+    pool->refs = 1;
+    pool->timeout = timeout;
+
+    for (uint32_t i = 0; i < disks->length; ++i)
+    {
+        FFDisk* disk = (FFDisk*) ffListGet(disks, i);
+
+        FFDiskQuery* query = (FFDiskQuery*) calloc(1, sizeof(*query));
+        query->disk.type = disk->type;
+        ffStrbufInitCopy(&query->disk.mountFrom, &disk->mountFrom);
+        ffStrbufInitCopy(&query->disk.mountpoint, &disk->mountpoint);
+        ffStrbufInit(&query->disk.name);
+        pool->queries[i] = query;
+    }
+
+    pthread_mutex_lock(&queryMutex);
+
+    uint32_t workers = pool->count < FF_DISK_QUERY_WORKERS ? pool->count : FF_DISK_QUERY_WORKERS;
+    uint32_t started = 0;
+    while (started < workers && startWorker(pool))
+        ++started;
+
+    if (started == 0)
+    {
+        // No worker at all. Do the work here, without a deadline
+        ++pool->refs;
+        pthread_mutex_unlock(&queryMutex);
+        queryWorkerMain(pool);
+        pthread_mutex_lock(&queryMutex);
+    }
+
+    // Wait until every query has finished or missed its deadline
+    while (true)
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        bool pending = false;
+        const struct timespec* wakeUp = NULL;
+        for (uint32_t i = 0; i < pool->count; ++i)
+        {
+            FFDiskQuery* query = pool->queries[i];
+            if (!query || query->done)
+                continue;
+
+            if (query->started && timeout > 0 && !isBefore(&now, &query->deadline))
+            {
+                // Its worker is stuck. Replace it, or give up on the queries still queued if that's not possible
+                query->abandoned = true;
+                pool->queries[i] = NULL;
+                if (!startWorker(pool))
+                {
+                    for (uint32_t j = pool->next; j < pool->count; ++j)
+                    {
+                        if (!pool->queries[j]) continue;
+                        destroyQuery(pool->queries[j]);
+                        pool->queries[j] = NULL;
+                    }
+                }
+                continue;
+            }
+
+            pending = true;
+            if (query->started && timeout > 0 && (!wakeUp || isBefore(&query->deadline, wakeUp)))
+                wakeUp = &query->deadline;
+        }
+        if (!pending)
+            break;
+
+        if (wakeUp)
+        {
+            struct timespec deadline = *wakeUp;
+            pthread_cond_timedwait(&queryCond, &queryMutex, &deadline);
+        }
+        else
+            pthread_cond_wait(&queryCond, &queryMutex);
+    }
+
+    for (uint32_t i = 0; i < disks->length; ++i)
+    {
+        FFDiskQuery* query = pool->queries[i];
+        FFDisk* disk = (FFDisk*) ffListGet(disks, i);
+        if (!query)
+        {
+            disk->type |= FF_DISK_VOLUME_TYPE_UNRESPONSIVE_BIT;
+            continue;
+        }
+        pool->queries[i] = NULL;
+
+        ffStrbufDestroy(&disk->name);
+        ffStrbufInitMove(&disk->name, &query->disk.name);
+        disk->type |= query->disk.type;
+        disk->bytesTotal = query->disk.bytesTotal;
+        disk->bytesFree = query->disk.bytesFree;
+        disk->bytesAvailable = query->disk.bytesAvailable;
+        disk->bytesUsed = 0; // To be filled in ./disk.c
+        disk->filesTotal = query->disk.filesTotal;
+        disk->filesUsed = query->disk.filesUsed;
+        disk->createTime = query->disk.createTime;
+        destroyQuery(query);
+    }
+
+    bool last = releasePool(pool);
+    pthread_mutex_unlock(&queryMutex);
+
+    if (last)
+        freePool(pool);
+}
+
+#endif
+
 const char* ffDetectDisksImpl(FFDiskOptions* options, FFlist* disks)
 {
     FILE* mountsFile = setmntent("/proc/mounts", "r");
@@ -270,6 +466,7 @@ const char* ffDetectDisksImpl(FFDiskOptions* options, FFlist* disks)
 
         //We have a valid device, add it to the list
         FFDisk* disk = ffListAdd(disks);
+        memset(disk, 0, sizeof(*disk));
         disk->type = FF_DISK_VOLUME_TYPE_NONE;
 
         //detect mountFrom
@@ -281,18 +478,27 @@ const char* ffDetectDisksImpl(FFDiskOptions* options, FFlist* disks)
         //detect filesystem
         ffStrbufInitS(&disk->filesystem, device->mnt_type);
 
-        //detect name
         ffStrbufInit(&disk->name);
-        detectName(disk); // Also detects external devices
 
         //detect type
         detectType(disks, disk);
-
-        //Detects stats
-        detectStats(disk);
     }
 
     endmntent(mountsFile);
 
+    #ifdef FF_HAVE_THREADS
+    //Detect names and stats of all mounts concurrently, so that an unresponsive one can't block the others
+    if (instance.config.general.multithreading)
+        detectNamesAndStats(disks, options->timeout);
+    else
+    #endif
+    {
+        FF_LIST_FOR_EACH(FFDisk, disk, *disks)
+        {
+            detectName(disk);
+            detectStats(disk);
+        }
+    }
+
     return NULL;
 }
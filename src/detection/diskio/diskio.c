@@ -1,19 +1,33 @@
 #include "diskio.h"
 
-#include "common/time.h"
+#include "common/sampler.h"
 
 const char* ffDiskIOGetIoCounters(FFlist* result, FFDiskIOOptions* options);
 
-static FFlist ioCounters1;
-static uint64_t time1;
+static const char* snapshot(FFlist* result, void* options)
+{
+    return ffDiskIOGetIoCounters(result, (FFDiskIOOptions*) options);
+}
+
+static void destroyResult(void* item)
+{
+    ffStrbufDestroy(&((FFDiskIOResult*) item)->name);
+    ffStrbufDestroy(&((FFDiskIOResult*) item)->devPath);
+}
+
+static FFSamplerSource source = {
+    .snapshot = snapshot,
+    .destroy = destroyResult,
+    .elementSize = sizeof(FFDiskIOResult),
+};
 
 void ffPrepareDiskIO(FFDiskIOOptions* options)
 {
     if (options->detectTotal) return;
 
-    ffListInit(&ioCounters1, sizeof(FFDiskIOResult));
-    ffDiskIOGetIoCounters(&ioCounters1, options);
-    time1 = ffTimeGetNow();
+    source.options = options;
+    source.window = instance.config.general.samplingWindow;
+    ffSamplerStart(&source);
 }
 
 const char* ffDetectDiskIO(FFlist* result, FFDiskIOOptions* options)
@@ -28,51 +42,44 @@ const char* ffDetectDiskIO(FFlist* result, FFDiskIOOptions* options)
         return NULL;
     }
 
-    if (time1 == 0)
-    {
-        ffListInit(&ioCounters1, sizeof(FFDiskIOResult));
-        error = ffDiskIOGetIoCounters(&ioCounters1, options);
-        if (error)
-            return error;
-        time1 = ffTimeGetNow();
-    }
-
-    if (ioCounters1.length == 0)
-        return "No physical disk found";
-
-    uint64_t time2 = ffTimeGetNow();
-    while (time2 - time1 < 1000)
-    {
-        ffTimeSleep((uint32_t) (1000 - (time2 - time1)));
-        time2 = ffTimeGetNow();
-    }
-
-    error = ffDiskIOGetIoCounters(result, options);
+    source.options = options;
+    source.window = instance.config.general.samplingWindow;
+    error = ffSamplerSample(&source);
     if (error)
         return error;
 
-    if (result->length != ioCounters1.length)
+    const FFlist* ioCounters1 = &source.snapshots[0];
+    const FFlist* ioCounters2 = &source.snapshots[1];
+
+    if (ioCounters1->length == 0)
+        return "No physical disk found";
+
+    if (ioCounters2->length != ioCounters1->length)
         return "Different number of physical disks. Hardware change?";
 
-    for (uint32_t i = 0; i < result->length; ++i)
+    double elapsed = (double) (source.times[1] - source.times[0]) / 1e9; // seconds
+    if (elapsed <= 0) elapsed = 1e-9;
+
+    for (uint32_t i = 0; i < ioCounters2->length; ++i)
     {
-        FFDiskIOResult* icPrev = (FFDiskIOResult*)ffListGet(&ioCounters1, i);
-        FFDiskIOResult* icCurr = (FFDiskIOResult*)ffListGet(result, i);
+        const FFDiskIOResult* icPrev = (const FFDiskIOResult*)ffListGet(ioCounters1, i);
+        const FFDiskIOResult* icCurr = (const FFDiskIOResult*)ffListGet(ioCounters2, i);
         if (!ffStrbufEqual(&icPrev->devPath, &icCurr->devPath))
             return "Physical disk device path changed";
 
+        FFDiskIOResult* icResult = (FFDiskIOResult*)ffListAdd(result);
+        *icResult = *icCurr;
+        ffStrbufInitCopy(&icResult->name, &icCurr->name);
+        ffStrbufInitCopy(&icResult->devPath, &icCurr->devPath);
+
         static_assert(sizeof(FFDiskIOResult) - offsetof(FFDiskIOResult, bytesRead) == sizeof(uint64_t) * 4, "Unexpected struct FFDiskIOResult layout");
         for (size_t off = offsetof(FFDiskIOResult, bytesRead); off < sizeof(FFDiskIOResult); off += sizeof(uint64_t))
         {
-            uint64_t* prevValue = (uint64_t*) ((uint8_t*) icPrev + off);
-            uint64_t* currValue = (uint64_t*) ((uint8_t*) icCurr + off);
-            uint64_t temp = *currValue;
-            *currValue -= *prevValue;
-            *currValue /= (time2 - time1) / 1000 /* seconds */;
-            *prevValue = temp;
+            const uint64_t* prevValue = (const uint64_t*) ((const uint8_t*) icPrev + off);
+            uint64_t* resultValue = (uint64_t*) ((uint8_t*) icResult + off);
+            *resultValue = (uint64_t) ((double) (*resultValue - *prevValue) / elapsed);
         }
     }
-    time1 = time2;
 
     return NULL;
 }
@@ -14,6 +14,7 @@
     #include <sys/user.h>
 #else
     #include "common/io/io.h"
+    #include "detection/proctable/proctable_linux.h"
 #endif
 
 static const char* parseEnv(void)
@@ -304,53 +305,22 @@ static const char* getFromProcesses(FFDisplayServerResult* result)
             break;
     }
 #else
-    FF_AUTO_CLOSE_DIR DIR* procdir = opendir("/proc");
-    if(procdir == NULL)
-        return "opendir(\"/proc\") failed";
+    // Read once and shared with Terminal / Shell and Processes detection
+    const FFlist* processes = ffProcTableGetSnapshot();
+    if(processes->length == 0)
+        return "ffProcTableGetSnapshot() failed";
 
-    FF_STRBUF_AUTO_DESTROY procPath = ffStrbufCreateA(64);
-    ffStrbufAppendS(&procPath, "/proc/");
-
-    uint32_t procPathLength = procPath.length;
-
-    FF_STRBUF_AUTO_DESTROY loginuid = ffStrbufCreate();
-    FF_STRBUF_AUTO_DESTROY processName = ffStrbufCreateA(256); //Some processes have large command lines (looking at you chrome)
-
-    struct dirent* dirent;
-    while((dirent = readdir(procdir)) != NULL)
+    FF_LIST_FOR_EACH(FFProcInfo, proc, *processes)
     {
-        //Match only folders starting with a number (the pid folders)
-        if(dirent->d_type != DT_DIR || !isdigit(dirent->d_name[0]))
-            continue;
-
-        ffStrbufAppendS(&procPath, dirent->d_name);
-        uint32_t procFolderPathLength = procPath.length;
-
         //Don't check for processes not owend by the current user.
-        ffStrbufAppendS(&procPath, "/loginuid");
-        ffReadFileBuffer(procPath.chars, &loginuid);
-        if(ffStrbufToUInt(&loginuid, (uint64_t) -1) != userId)
-        {
-            ffStrbufSubstrBefore(&procPath, procPathLength);
+        if(proc->loginuid != userId || !proc->exeName[0])
             continue;
-        }
-
-        ffStrbufSubstrBefore(&procPath, procFolderPathLength);
-
-        //We check the cmdline for the process name, because it is not trimmed.
-        ffStrbufAppendS(&procPath, "/cmdline");
-        ffReadFileBuffer(procPath.chars, &processName);
-        ffStrbufTrimRightSpace(&processName);
-        ffStrbufSubstrBeforeFirstC(&processName, '\0'); //Trim the arguments
-        ffStrbufSubstrAfterLastC(&processName, '/');
-
-        ffStrbufSubstrBefore(&procPath, procPathLength);
 
         if(result->dePrettyName.length == 0)
-            applyPrettyNameIfDE(result, processName.chars);
+            applyPrettyNameIfDE(result, proc->exeName);
 
         if(result->wmPrettyName.length == 0)
-            applyNameIfWM(result, processName.chars);
+            applyNameIfWM(result, proc->exeName);
 
         if(result->dePrettyName.length > 0 && result->wmPrettyName.length > 0)
             break;
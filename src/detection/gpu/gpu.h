@@ -6,6 +6,7 @@
 #define FF_GPU_CORE_COUNT_UNSET -1
 #define FF_GPU_VMEM_SIZE_UNSET ((uint64_t)-1)
 #define FF_GPU_FREQUENCY_UNSET (0/0.0)
+#define FF_GPU_USAGE_UNSET (0/0.0)
 
 extern const char* FF_GPU_VENDOR_NAME_APPLE;
 extern const char* FF_GPU_VENDOR_NAME_AMD;
@@ -35,6 +36,8 @@ typedef struct FFGPUResult
     double frequency; // Real time clock frequency in GHz
     FFGPUMemory dedicated;
     FFGPUMemory shared;
+    double usage; // Busy percentage of the GPU engines
+    double memoryBandwidthUsage; // Busy percentage of the memory controller
     uint64_t deviceId; // Used internally, may be uninitialized
 } FFGPUResult;
 
@@ -57,6 +57,7 @@ const char* ffDetectGPUImpl(const FFGPUOptions* options, FFlist* gpus)
         gpu->dedicated.total = gpu->dedicated.used = gpu->shared.total = gpu->shared.used = FF_GPU_VMEM_SIZE_UNSET;
         gpu->type = FF_GPU_TYPE_UNKNOWN;
         gpu->frequency = FF_GPU_FREQUENCY_UNSET;
+        gpu->usage = gpu->memoryBandwidthUsage = FF_GPU_USAGE_UNSET;
         IORegistryEntryGetRegistryEntryID(registryEntry, &gpu->deviceId);
         ffStrbufInitStatic(&gpu->platformApi, "Metal");
 
@@ -66,6 +67,16 @@ const char* ffDetectGPUImpl(const FFGPUOptions* options, FFlist* gpus)
         if(ffCfDictGetInt(properties, CFSTR("gpu-core-count"), &gpu->coreCount)) // For Apple
             gpu->coreCount = FF_GPU_CORE_COUNT_UNSET;
 
+        if (options->usage)
+        {
+            // Maintained by the driver, no need to sample it twice
+            CFDictionaryRef perfStats;
+            int utilization;
+            if (!ffCfDictGetDict(properties, CFSTR("PerformanceStatistics"), &perfStats) &&
+                !ffCfDictGetInt(perfStats, CFSTR("Device Utilization %"), &utilization))
+                gpu->usage = utilization;
+        }
+
         ffStrbufInit(&gpu->name);
         //IOAccelerator returns model / vendor-id properties for Apple Silicon, but not for Intel Iris GPUs.
         //Still needs testing for AMD's
@@ -105,3 +116,9 @@ const char* ffDetectGPUImpl(const FFGPUOptions* options, FFlist* gpus)
     ffGpuDetectMetal(gpus);
     return NULL;
 }
+
+void ffPrepareGPUUsage(FFGPUOptions* options)
+{
+    // Usage is reported by the driver directly, if supported. Nothing to sample
+    FF_UNUSED(options);
+}
@@ -62,6 +62,7 @@ const char* ffDetectGPUImpl(const FFGPUOptions* options, FFlist* gpus)
         gpu->dedicated.total = gpu->dedicated.used = gpu->shared.total = gpu->shared.used = FF_GPU_VMEM_SIZE_UNSET;
         gpu->deviceId = ((uint64_t) pc->pc_sel.pc_domain << 6) | ((uint64_t) pc->pc_sel.pc_bus << 4) | ((uint64_t) pc->pc_sel.pc_dev << 2) | pc->pc_sel.pc_func;
         gpu->frequency = FF_GPU_FREQUENCY_UNSET;
+        gpu->usage = gpu->memoryBandwidthUsage = FF_GPU_USAGE_UNSET;
 
         if (gpu->vendor.chars == FF_GPU_VENDOR_NAME_AMD)
         {
@@ -78,7 +79,7 @@ const char* ffDetectGPUImpl(const FFGPUOptions* options, FFlist* gpus)
         }
 
         #ifdef FF_USE_PROPRIETARY_GPU_DRIVER_API
-        if (gpu->vendor.chars == FF_GPU_VENDOR_NAME_NVIDIA && (options->temp || options->driverSpecific))
+        if (gpu->vendor.chars == FF_GPU_VENDOR_NAME_NVIDIA && (options->temp || options->driverSpecific || options->usage))
         {
             ffDetectNvidiaGpuInfo(&(FFGpuDriverCondition) {
                 .type = FF_GPU_DRIVER_CONDITION_TYPE_BUS_ID,
@@ -94,6 +95,8 @@ const char* ffDetectGPUImpl(const FFGPUOptions* options, FFlist* gpus)
                 .coreCount = options->driverSpecific ? (uint32_t*) &gpu->coreCount : NULL,
                 .type = &gpu->type,
                 .frequency = &gpu->frequency,
+                .usage = options->usage ? &gpu->usage : NULL,
+                .memoryBandwidthUsage = options->usage ? &gpu->memoryBandwidthUsage : NULL,
             }, "libnvidia-ml.so");
 
             if (gpu->dedicated.total != FF_GPU_VMEM_SIZE_UNSET)
@@ -104,3 +107,9 @@ const char* ffDetectGPUImpl(const FFGPUOptions* options, FFlist* gpus)
 
     return NULL;
 }
+
+void ffPrepareGPUUsage(FFGPUOptions* options)
+{
+    // Usage is reported by the driver directly, if supported. Nothing to sample
+    FF_UNUSED(options);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "fastfetch.h"
+
+// Persistent cache of graphics API probe results (Vulkan, OpenGL), which are expensive to obtain.
+// An entry is valid as long as the installed driver stack is unchanged, that is the ICD / vendor manifests,
+// the driver libraries they refer to, the glvnd GLX vendor libraries and the kernel DRM driver versions.
+// `params` identifies the caller specific inputs of the probe, e.g. the configured library paths.
+
+bool ffGPUDriverCacheRead(const char* name, const FFstrbuf* params, FFstrbuf* content);
+void ffGPUDriverCacheWrite(const char* name, const FFstrbuf* params, const FFstrbuf* content);
+
+// Reads the next line of cached content, starting at `*index`
+static inline bool ffGPUDriverCacheReadLine(const FFstrbuf* content, uint32_t* index, FFstrbuf* line)
+{
+    if (*index >= content->length)
+        return false;
+
+    uint32_t end = ffStrbufNextIndexC(content, *index, '\n');
+    ffStrbufSetNS(line, end - *index, content->chars + *index);
+    *index = end + 1;
+    return true;
+}
@@ -0,0 +1,370 @@
+#include "gpu_driver_cache.h"
+#include "common/io/io.h"
+#include "util/hash.h"
+#include "util/stringUtils.h"
+
+#include <dlfcn.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <sys/utsname.h>
+
+#if __has_include(<drm/drm.h>)
+    #include <drm/drm.h>
+    #define FF_HAVE_DRM_H 1
+#elif __has_include(<libdrm/drm.h>)
+    #include <libdrm/drm.h>
+    #define FF_HAVE_DRM_H 1
+#endif
+
+#if FF_HAVE_DRM_H
+    #include <fcntl.h>
+    #include <sys/ioctl.h>
+#endif
+
+// Environment variables that select or override the driver used by the loaders
+static const char* envNames[] = {
+    "LD_LIBRARY_PATH",
+    "DISPLAY",
+    "WAYLAND_DISPLAY",
+    "DRI_PRIME",
+    "LIBGL_ALWAYS_SOFTWARE",
+    "GALLIUM_DRIVER",
+    "MESA_LOADER_DRIVER_OVERRIDE",
+    "MESA_GL_VERSION_OVERRIDE",
+    "MESA_VK_DEVICE_SELECT",
+    "__GLX_VENDOR_LIBRARY_NAME",
+    "__EGL_VENDOR_LIBRARY_FILENAMES",
+    "__EGL_VENDOR_LIBRARY_DIRS",
+    "__NV_PRIME_RENDER_OFFLOAD",
+    "VK_ICD_FILENAMES",
+    "VK_DRIVER_FILES",
+    "VK_ADD_DRIVER_FILES",
+    "VK_LOADER_DRIVERS_SELECT",
+    "VK_LOADER_DRIVERS_DISABLE",
+};
+
+// Directories containing Vulkan ICD and glvnd EGL vendor manifests, relative to the XDG config / data dirs
+static const char* manifestSubdirs[] = {
+    "vulkan/icd.d/",
+    "glvnd/egl_vendor.d/",
+};
+
+static void appendFileIdentity(FFstrbuf* key, const char* path)
+{
+    ffStrbufAppendS(key, path);
+
+    struct stat st;
+    if (stat(path, &st) == 0)
+    {
+        ffStrbufAppendF(key, ":%" PRIu64 ":%" PRIu64 ":%lld.%09ld\n",
+            (uint64_t) st.st_ino, (uint64_t) st.st_size, (long long) st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+    }
+    else
+        ffStrbufAppendS(key, ":-\n");
+}
+
+// glvnd GLX vendor libraries. They have no manifests; libGLX picks them by name
+static const char* glxVendorLibraries[] = {
+    "libGLX_mesa.so.0",
+    "libGLX_nvidia.so.0",
+};
+
+// Directories searched for bare library names: LD_LIBRARY_PATH, then the system library dir, i.e. that of libc
+static void getLibrarySearchDirs(FFstrbuf* dirs)
+{
+    const char* ldLibraryPath = getenv("LD_LIBRARY_PATH");
+    if (ffStrSet(ldLibraryPath))
+    {
+        ffStrbufAppendS(dirs, ldLibraryPath);
+        ffStrbufAppendC(dirs, ':');
+    }
+
+    Dl_info info;
+    if (dladdr((void*) &getenv, &info) && info.dli_fname && info.dli_fname[0] == '/')
+    {
+        const char* slash = strrchr(info.dli_fname, '/');
+        uint32_t length = (uint32_t) (slash - info.dli_fname);
+        if (!ffStrStartsWith(info.dli_fname, "/usr/"))
+            ffStrbufAppendS(dirs, "/usr"); // merged /usr
+        ffStrbufAppendNS(dirs, length, info.dli_fname);
+        ffStrbufAppendC(dirs, ':');
+        ffStrbufAppendNS(dirs, length, info.dli_fname);
+        ffStrbufAppendC(dirs, ':');
+    }
+
+    ffStrbufAppendS(dirs, "/usr/lib64:/usr/lib:/lib64:/lib");
+}
+
+// Identity of the driver a manifest or vendor name refers to. Bare names are resolved like the dynamic loader would, roughly
+static void appendLibraryIdentity(FFstrbuf* key, const char* library, const char* manifestPath, const FFstrbuf* searchDirs)
+{
+    if (library[0] == '/')
+    {
+        appendFileIdentity(key, library);
+        return;
+    }
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+
+    if (strchr(library, '/'))
+    {
+        // Relative to the manifest
+        ffStrbufSetS(&path, manifestPath);
+        ffStrbufSubstrBeforeLastC(&path, '/');
+        ffStrbufAppendC(&path, '/');
+        ffStrbufAppendS(&path, library);
+        appendFileIdentity(key, path.chars);
+        return;
+    }
+
+    for (const char* start = searchDirs->chars; *start; )
+    {
+        const char* end = strchr(start, ':');
+        if (!end) end = start + strlen(start);
+
+        if (end > start)
+        {
+            ffStrbufSetNS(&path, (uint32_t) (end - start), start);
+            ffStrbufEnsureEndsWithC(&path, '/');
+            ffStrbufAppendS(&path, library);
+            if (access(path.chars, F_OK) == 0)
+            {
+                appendFileIdentity(key, path.chars);
+                return;
+            }
+        }
+
+        start = *end ? end + 1 : end;
+    }
+
+    ffStrbufAppendS(key, library);
+    ffStrbufAppendS(key, ":-\n");
+}
+
+// Both Vulkan ICD and glvnd EGL vendor manifests have `{ "ICD": { "library_path": "..." } }`
+static void appendManifestLibrary(FFstrbuf* key, const char* manifestPath, const FFstrbuf* searchDirs)
+{
+    yyjson_doc* doc = yyjson_read_file(manifestPath, YYJSON_READ_NOFLAG, NULL, NULL);
+    if (!doc) return;
+
+    const char* library = yyjson_get_str(yyjson_obj_get(yyjson_obj_get(yyjson_doc_get_root(doc), "ICD"), "library_path"));
+    if (ffStrSet(library))
+        appendLibraryIdentity(key, library, manifestPath, searchDirs);
+
+    yyjson_doc_free(doc);
+}
+
+static void appendManifestDir(FFstrbuf* key, FFstrbuf* path, const FFstrbuf* searchDirs)
+{
+    uint32_t baseLength = path->length;
+
+    FF_LIST_AUTO_DESTROY files = ffListCreate(sizeof(FFstrbuf));
+
+    for (uint32_t i = 0; i < sizeof(manifestSubdirs) / sizeof(*manifestSubdirs); ++i)
+    {
+        ffStrbufAppendS(path, manifestSubdirs[i]);
+
+        FF_AUTO_CLOSE_DIR DIR* dir = opendir(path->chars);
+        if (dir)
+        {
+            struct dirent* entry;
+            while ((entry = readdir(dir)) != NULL)
+            {
+                if (!ffStrEndsWith(entry->d_name, ".json"))
+                    continue;
+                FFstrbuf* file = (FFstrbuf*) ffListAdd(&files);
+                ffStrbufInitCopy(file, path);
+                ffStrbufAppendS(file, entry->d_name);
+            }
+        }
+
+        ffStrbufSubstrBefore(path, baseLength);
+    }
+
+    // readdir order is unspecified
+    ffListSort(&files, (const void*) ffStrbufComp);
+
+    FF_LIST_FOR_EACH(FFstrbuf, file, files)
+    {
+        appendFileIdentity(key, file->chars);
+        appendManifestLibrary(key, file->chars, searchDirs);
+        ffStrbufDestroy(file);
+    }
+}
+
+static void appendManifestDirs(FFstrbuf* key, const char* dirs, const FFstrbuf* searchDirs)
+{
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+
+    for (const char* start = dirs; *start; )
+    {
+        const char* end = strchr(start, ':');
+        if (!end) end = start + strlen(start);
+
+        if (end > start)
+        {
+            ffStrbufSetNS(&path, (uint32_t) (end - start), start);
+            ffStrbufEnsureEndsWithC(&path, '/');
+            appendManifestDir(key, &path, searchDirs);
+        }
+
+        start = *end ? end + 1 : end;
+    }
+}
+
+static void appendEnvDirs(FFstrbuf* dirs, const char* envName, const char* defaultValue)
+{
+    const char* value = getenv(envName);
+    if (ffStrSet(value))
+        ffStrbufAppendS(dirs, value);
+    else if (defaultValue[0] == '/')
+        ffStrbufAppendS(dirs, defaultValue);
+    else
+    {
+        ffStrbufAppend(dirs, &instance.state.platform.homeDir);
+        ffStrbufAppendS(dirs, defaultValue);
+    }
+    ffStrbufAppendC(dirs, ':');
+}
+
+static void appendDrmDriverVersions(FFstrbuf* key)
+{
+    struct utsname uts;
+    if (uname(&uts) == 0)
+        ffStrbufAppendF(key, "%s %s\n", uts.release, uts.version);
+
+    FF_AUTO_CLOSE_DIR DIR* dir = opendir("/sys/class/drm/");
+    if (!dir) return;
+
+    FF_LIST_AUTO_DESTROY versions = ffListCreate(sizeof(FFstrbuf));
+    FF_STRBUF_AUTO_DESTROY buffer = ffStrbufCreate();
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        // Only `cardN` / `renderDN`, not connectors such as `card0-DP-1`
+        if (!(ffStrStartsWith(entry->d_name, "card") || ffStrStartsWith(entry->d_name, "renderD")) || strchr(entry->d_name, '-'))
+            continue;
+
+        FFstrbuf* version = (FFstrbuf*) ffListAdd(&versions);
+        ffStrbufInitF(version, "%s", entry->d_name);
+
+        #if FF_HAVE_DRM_H
+        char path[sizeof("/dev/dri/") + sizeof(entry->d_name)];
+        snprintf(path, sizeof(path), "/dev/dri/%s", entry->d_name);
+        FF_AUTO_CLOSE_FD int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd >= 0)
+        {
+            char name[64] = "", date[64] = "";
+            drm_version_t drmVersion = {
+                .name = name,
+                .name_len = sizeof(name) - 1,
+                .date = date,
+                .date_len = sizeof(date) - 1,
+            };
+            if (ioctl(fd, DRM_IOCTL_VERSION, &drmVersion) == 0)
+            {
+                ffStrbufAppendF(version, " %.*s %d.%d.%d %.*s",
+                    (int) drmVersion.name_len, name,
+                    drmVersion.version_major, drmVersion.version_minor, drmVersion.version_patchlevel,
+                    (int) drmVersion.date_len, date);
+                continue;
+            }
+        }
+        #endif
+
+        // Out of tree drivers (nvidia) export their version as a module parameter
+        char path2[sizeof("/sys/class/drm//device/driver/module/version") + sizeof(entry->d_name)];
+        snprintf(path2, sizeof(path2), "/sys/class/drm/%s/device/driver/module/version", entry->d_name);
+        if (ffReadFileBuffer(path2, &buffer))
+        {
+            ffStrbufTrimRightSpace(&buffer);
+            ffStrbufAppendC(version, ' ');
+            ffStrbufAppend(version, &buffer);
+        }
+    }
+
+    ffListSort(&versions, (const void*) ffStrbufComp);
+
+    FF_LIST_FOR_EACH(FFstrbuf, version, versions)
+    {
+        ffStrbufAppend(key, version);
+        ffStrbufAppendC(key, '\n');
+        ffStrbufDestroy(version);
+    }
+}
+
+static void buildKey(FFstrbuf* key, const char* name, const FFstrbuf* params)
+{
+    ffStrbufSetF(key, "%s %s\n", FASTFETCH_PROJECT_VERSION, name);
+    ffStrbufAppend(key, params);
+    ffStrbufAppendC(key, '\n');
+
+    for (uint32_t i = 0; i < sizeof(envNames) / sizeof(*envNames); ++i)
+    {
+        const char* value = getenv(envNames[i]);
+        if (value)
+            ffStrbufAppendF(key, "%s=%s\n", envNames[i], value);
+    }
+
+    // Same search order as the Vulkan loader and glvnd
+    FF_STRBUF_AUTO_DESTROY dirs = ffStrbufCreate();
+    appendEnvDirs(&dirs, "XDG_CONFIG_HOME", ".config");
+    appendEnvDirs(&dirs, "XDG_CONFIG_DIRS", "/etc/xdg");
+    ffStrbufAppendS(&dirs, "/etc:");
+    appendEnvDirs(&dirs, "XDG_DATA_HOME", ".local/share");
+    appendEnvDirs(&dirs, "XDG_DATA_DIRS", "/usr/local/share:/usr/share");
+    FF_STRBUF_AUTO_DESTROY searchDirs = ffStrbufCreate();
+    getLibrarySearchDirs(&searchDirs);
+    appendManifestDirs(key, dirs.chars, &searchDirs);
+
+    for (uint32_t i = 0; i < sizeof(glxVendorLibraries) / sizeof(*glxVendorLibraries); ++i)
+        appendLibraryIdentity(key, glxVendorLibraries[i], NULL, &searchDirs);
+
+    appendDrmDriverVersions(key);
+}
+
+static void getCachePath(FFstrbuf* path, const char* name)
+{
+    ffStrbufSet(path, &instance.state.platform.cacheDir);
+    ffStrbufAppendS(path, "fastfetch/drivers/");
+    ffStrbufAppendS(path, name);
+}
+
+// Format: <hash>\n<content>
+bool ffGPUDriverCacheRead(const char* name, const FFstrbuf* params, FFstrbuf* content)
+{
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getCachePath(&path, name);
+
+    FF_STRBUF_AUTO_DESTROY cache = ffStrbufCreate();
+    if (!ffReadFileBuffer(path.chars, &cache))
+        return false;
+
+    FF_STRBUF_AUTO_DESTROY line = ffStrbufCreate();
+    uint32_t index = 0;
+    if (!ffGPUDriverCacheReadLine(&cache, &index, &line) || index > cache.length)
+        return false;
+    uint64_t hash = ffStrbufToUInt(&line, 0);
+
+    FF_STRBUF_AUTO_DESTROY key = ffStrbufCreateA(4096);
+    buildKey(&key, name, params);
+    if (hash == 0 || hash != ffHashFnv1aStrbuf(&key))
+        return false;
+
+    ffStrbufSetNS(content, cache.length - index, cache.chars + index);
+    return true;
+}
+
+void ffGPUDriverCacheWrite(const char* name, const FFstrbuf* params, const FFstrbuf* content)
+{
+    FF_STRBUF_AUTO_DESTROY key = ffStrbufCreateA(4096);
+    buildKey(&key, name, params);
+
+    FF_STRBUF_AUTO_DESTROY cache = ffStrbufCreateF("%" PRIu64 "\n", ffHashFnv1aStrbuf(&key));
+    ffStrbufAppend(&cache, content);
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    getCachePath(&path, name);
+    ffWriteFileBufferAtomic(path.chars, &cache);
+}
@@ -0,0 +1,12 @@
+#include "gpu_driver_cache.h"
+
+bool ffGPUDriverCacheRead(const char* name, const FFstrbuf* params, FFstrbuf* content)
+{
+    FF_UNUSED(name, params, content);
+    return false;
+}
+
+void ffGPUDriverCacheWrite(const char* name, const FFstrbuf* params, const FFstrbuf* content)
+{
+    FF_UNUSED(name, params, content);
+}
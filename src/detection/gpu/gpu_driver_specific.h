@@ -42,6 +42,8 @@ typedef struct FFGpuDriverResult
     uint32_t* coreCount;
     FFGPUType* type;
     double* frequency;
+    double* usage;
+    double* memoryBandwidthUsage;
 } FFGpuDriverResult;
 
 const char* ffDetectNvidiaGpuInfo(const FFGpuDriverCondition* cond, FFGpuDriverResult result, const char* soName);
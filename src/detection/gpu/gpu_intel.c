@@ -54,7 +54,6 @@ const char* ffDetectIntelGpuInfo(const FFGpuDriverCondition* cond, FFGpuDriverRe
         }, &igclData.apiHandle) != CTL_RESULT_SUCCESS)
             return "loading igcl library failed";
         atexit(shutdownIgcl);
-        libigcl = NULL; // don't close igcl
     }
 
     if (!igclData.apiHandle)
@@ -4,6 +4,9 @@
 #include "detection/cpu/cpu.h"
 #include "common/io/io.h"
 #include "common/properties.h"
+#include "common/thread.h"
+#include "common/time.h"
+#include "util/mallocHelper.h"
 #include "util/stringUtils.h"
 
 #ifdef FF_USE_PROPRIETARY_GPU_DRIVER_API
@@ -208,12 +211,46 @@ static bool loadPciIds(FFstrbuf* pciids)
     return false;
 }
 
-static const char* detectPci(const FFGPUOptions* options, FFlist* gpus, FFstrbuf* buffer, FFstrbuf* deviceDir, const char* drmKey)
+
+static const FFstrbuf* getPciIds(void)
+{
+    static FFThreadMutex mutex = FF_THREAD_MUTEX_INITIALIZER;
+    static FFstrbuf pciids;
+
+    ffThreadMutexLock(&mutex);
+    if (pciids.chars == NULL)
+    {
+        ffStrbufInit(&pciids);
+        loadPciIds(&pciids);
+    }
+    ffThreadMutexUnlock(&mutex);
+    return &pciids;
+}
+
+typedef enum FFGPUDeviceKind
+{
+    FF_GPU_DEVICE_KIND_PCI,
+    FF_GPU_DEVICE_KIND_ASAHI,
+} FFGPUDeviceKind;
+
+// A GPU found in the discovery phase, waiting to be probed
+typedef struct FFGPUDevice
+{
+    FFGPUDeviceKind kind;
+    const FFGPUOptions* options;
+    FFstrbuf deviceDir;
+    char drmKey[32]; // Empty if not detected via DRM
+    uint32_t vendorId, deviceId;
+    uint8_t subclassId;
+    uint32_t pciDomain, pciBus, pciDevice, pciFunc;
+    FFGPUResult gpu;
+} FFGPUDevice;
+
+static const char* discoverPci(const FFGPUOptions* options, FFlist* devices, FFstrbuf* modalias, FFstrbuf* deviceDir, const char* drmKey)
 {
-    const uint32_t drmDirPathLength = deviceDir->length;
     uint32_t vendorId, deviceId, subVendorId, subDeviceId;
     uint8_t classId, subclassId;
-    if (sscanf(buffer->chars + strlen("pci:"), "v%8" SCNx32 "d%8" SCNx32 "sv%8" SCNx32 "sd%8" SCNx32 "bc%2" SCNx8 "sc%2" SCNx8, &vendorId, &deviceId, &subVendorId, &subDeviceId, &classId, &subclassId) != 6)
+    if (sscanf(modalias->chars + strlen("pci:"), "v%8" SCNx32 "d%8" SCNx32 "sv%8" SCNx32 "sd%8" SCNx32 "bc%2" SCNx8 "sc%2" SCNx8, &vendorId, &deviceId, &subVendorId, &subDeviceId, &classId, &subclassId) != 6)
         return "Invalid modalias string";
 
     if (classId != 0x03 /*PCI_BASE_CLASS_DISPLAY*/)
@@ -242,8 +279,31 @@ static const char* detectPci(const FFGPUOptions* options, FFlist* gpus, FFstrbuf
     if (sscanf(pPciPath, "%" SCNx32 ":%" SCNx32 ":%" SCNx32 ".%" SCNx32, &pciDomain, &pciBus, &pciDevice, &pciFunc) != 4)
         return "Invalid PCI device path";
 
-    FFGPUResult* gpu = (FFGPUResult*)ffListAdd(gpus);
-    ffStrbufInitStatic(&gpu->vendor, ffGetGPUVendorString((uint16_t) vendorId));
+    FFGPUDevice* device = (FFGPUDevice*) ffListAdd(devices);
+    device->kind = FF_GPU_DEVICE_KIND_PCI;
+    device->options = options;
+    ffStrbufInitCopy(&device->deviceDir, deviceDir);
+    snprintf(device->drmKey, sizeof(device->drmKey), "%s", drmKey ? drmKey : "");
+    device->vendorId = vendorId;
+    device->deviceId = deviceId;
+    device->subclassId = subclassId;
+    device->pciDomain = pciDomain;
+    device->pciBus = pciBus;
+    device->pciDevice = pciDevice;
+    device->pciFunc = pciFunc;
+    return NULL;
+}
+
+static void probePci(FFGPUDevice* device)
+{
+    const FFGPUOptions* options = device->options;
+    FFGPUResult* gpu = &device->gpu;
+    FFstrbuf* deviceDir = &device->deviceDir;
+    const char* drmKey = device->drmKey[0] ? device->drmKey : NULL;
+    const uint32_t drmDirPathLength = deviceDir->length;
+    FF_STRBUF_AUTO_DESTROY buffer = ffStrbufCreate();
+
+    ffStrbufInitStatic(&gpu->vendor, ffGetGPUVendorString((uint16_t) device->vendorId));
     ffStrbufInit(&gpu->name);
     ffStrbufInit(&gpu->driver);
     ffStrbufInit(&gpu->platformApi);
@@ -251,22 +311,23 @@ static const char* detectPci(const FFGPUOptions* options, FFlist* gpus, FFstrbuf
     gpu->coreCount = FF_GPU_CORE_COUNT_UNSET;
     gpu->type = FF_GPU_TYPE_UNKNOWN;
     gpu->dedicated.total = gpu->dedicated.used = gpu->shared.total = gpu->shared.used = FF_GPU_VMEM_SIZE_UNSET;
-    gpu->deviceId = ((uint64_t) pciDomain << 6) | ((uint64_t) pciBus << 4) | (deviceId << 2) | pciFunc;
+    gpu->deviceId = ((uint64_t) device->pciDomain << 6) | ((uint64_t) device->pciBus << 4) | (device->deviceId << 2) | device->pciFunc;
     gpu->frequency = FF_GPU_FREQUENCY_UNSET;
+    gpu->usage = gpu->memoryBandwidthUsage = FF_GPU_USAGE_UNSET;
 
     if (drmKey) ffStrbufSetF(&gpu->platformApi, "DRM (%s)", drmKey);
 
     if (gpu->vendor.chars == FF_GPU_VENDOR_NAME_AMD)
     {
         ffStrbufAppendS(deviceDir, "/revision");
-        if (ffReadFileBuffer(deviceDir->chars, buffer))
+        if (ffReadFileBuffer(deviceDir->chars, &buffer))
         {
             char* pend;
-            uint64_t revision = strtoul(buffer->chars, &pend, 16);
-            if (pend != buffer->chars)
+            uint64_t revision = strtoul(buffer.chars, &pend, 16);
+            if (pend != buffer.chars)
             {
                 char query[32];
-                snprintf(query, sizeof(query), "%X,\t%X,", (unsigned) deviceId, (unsigned) revision);
+                snprintf(query, sizeof(query), "%X,\t%X,", (unsigned) device->deviceId, (unsigned) revision);
                 #ifdef FF_CUSTOM_AMDGPU_IDS_PATH
                 ffParsePropFile(FF_STR(FF_CUSTOM_AMDGPU_IDS_PATH), query, &gpu->name);
                 #else
@@ -278,41 +339,47 @@ static const char* detectPci(const FFGPUOptions* options, FFlist* gpus, FFstrbuf
     }
 
     if (gpu->name.length == 0)
-    {
-        static FFstrbuf pciids;
-        if (pciids.chars == NULL)
-        {
-            ffStrbufInit(&pciids);
-            loadPciIds(&pciids);
-        }
-        ffGPUParsePciIds(&pciids, subclassId, (uint16_t) vendorId, (uint16_t) deviceId, gpu);
-    }
+        ffGPUParsePciIds((FFstrbuf*) getPciIds(), device->subclassId, (uint16_t) device->vendorId, (uint16_t) device->deviceId, gpu);
 
-    pciDetectDriver(gpu, deviceDir, buffer, drmKey);
+    pciDetectDriver(gpu, deviceDir, &buffer, drmKey);
     ffStrbufSubstrBefore(deviceDir, drmDirPathLength);
 
+    if (options->usage)
+    {
+        // amdgpu only. Averaged by the driver, so a single read is enough
+        ffStrbufAppendS(deviceDir, "/gpu_busy_percent");
+        if (ffReadFileBuffer(deviceDir->chars, &buffer))
+            gpu->usage = ffStrbufToDouble(&buffer);
+        ffStrbufSubstrBefore(deviceDir, drmDirPathLength);
+
+        ffStrbufAppendS(deviceDir, "/mem_busy_percent");
+        if (ffReadFileBuffer(deviceDir->chars, &buffer))
+            gpu->memoryBandwidthUsage = ffStrbufToDouble(&buffer);
+        ffStrbufSubstrBefore(deviceDir, drmDirPathLength);
+    }
+
     if (gpu->vendor.chars == FF_GPU_VENDOR_NAME_AMD)
     {
-        pciDetectAmdSpecific(options, gpu, deviceDir, buffer);
+        pciDetectAmdSpecific(options, gpu, deviceDir, &buffer);
         ffStrbufSubstrBefore(deviceDir, drmDirPathLength);
     }
     else if (gpu->vendor.chars == FF_GPU_VENDOR_NAME_INTEL)
     {
-        pciDetectIntelSpecific(gpu, deviceDir, buffer);
+        pciDetectIntelSpecific(gpu, deviceDir, &buffer);
         ffStrbufSubstrBefore(deviceDir, drmDirPathLength);
     }
     else if (gpu->vendor.chars == FF_GPU_VENDOR_NAME_NVIDIA)
     {
         #ifdef FF_USE_PROPRIETARY_GPU_DRIVER_API
-        if (options->temp || options->driverSpecific)
+        if (options->temp || options->driverSpecific || options->usage)
         {
             ffDetectNvidiaGpuInfo(&(FFGpuDriverCondition) {
                 .type = FF_GPU_DRIVER_CONDITION_TYPE_BUS_ID,
                 .pciBusId = {
-                    .domain = pciDomain,
-                    .bus = pciBus,
-                    .device = pciDevice,
-                    .func = pciFunc,
+                    .domain = device->pciDomain,
+                    .bus = device->pciBus,
+                    .device = device->pciDevice,
+                    .func = device->pciFunc,
                 },
             }, (FFGpuDriverResult) {
                 .temp = options->temp ? &gpu->temperature : NULL,
@@ -320,6 +387,8 @@ static const char* detectPci(const FFGPUOptions* options, FFlist* gpus, FFstrbuf
                 .coreCount = options->driverSpecific ? (uint32_t*) &gpu->coreCount : NULL,
                 .type = &gpu->type,
                 .frequency = &gpu->frequency,
+                .usage = options->usage ? &gpu->usage : NULL,
+                .memoryBandwidthUsage = options->usage ? &gpu->memoryBandwidthUsage : NULL,
             }, "libnvidia-ml.so");
         }
         #endif // FF_USE_PROPRIETARY_GPU_DRIVER_API
@@ -332,34 +401,47 @@ static const char* detectPci(const FFGPUOptions* options, FFlist* gpus, FFstrbuf
                 gpu->type = FF_GPU_TYPE_DISCRETE;
         }
     }
+}
 
+FF_MAYBE_UNUSED static const char* discoverAsahi(const FFGPUOptions* options, FFlist* devices, FFstrbuf* modalias, FFstrbuf* drmDir, const char* drmKey)
+{
+    uint32_t index = ffStrbufFirstIndexS(modalias, "apple,agx-t");
+    if (index == modalias->length) return "display-subsystem?";
+    index += (uint32_t) strlen("apple,agx-t");
+
+    FFGPUDevice* device = (FFGPUDevice*) ffListAdd(devices);
+    memset(device, 0, sizeof(*device));
+    device->kind = FF_GPU_DEVICE_KIND_ASAHI;
+    device->options = options;
+    ffStrbufInitCopy(&device->deviceDir, drmDir);
+    snprintf(device->drmKey, sizeof(device->drmKey), "%s", drmKey);
+    device->deviceId = (uint32_t) strtoul(modalias->chars + index, NULL, 10);
     return NULL;
 }
 
-FF_MAYBE_UNUSED static const char* detectAsahi(FFlist* gpus, FFstrbuf* buffer, FFstrbuf* drmDir, const char* drmKey)
+FF_MAYBE_UNUSED static void probeAsahi(FFGPUDevice* device)
 {
-    uint32_t index = ffStrbufFirstIndexS(buffer, "apple,agx-t");
-    if (index == buffer->length) return "display-subsystem?";
-    index += (uint32_t) strlen("apple,agx-t");
+    FFGPUResult* gpu = &device->gpu;
+    FF_STRBUF_AUTO_DESTROY buffer = ffStrbufCreate();
 
-    FFGPUResult* gpu = (FFGPUResult*)ffListAdd(gpus);
-    gpu->deviceId = strtoul(buffer->chars + index, NULL, 10);
+    gpu->deviceId = device->deviceId;
     ffStrbufInitStatic(&gpu->name, ffCPUAppleCodeToName((uint32_t) gpu->deviceId));
     ffStrbufInitStatic(&gpu->vendor, FF_GPU_VENDOR_NAME_APPLE);
     ffStrbufInit(&gpu->driver);
-    ffStrbufInitF(&gpu->platformApi, "DRM (%s)", drmKey);
+    ffStrbufInitF(&gpu->platformApi, "DRM (%s)", device->drmKey);
     gpu->temperature = FF_GPU_TEMP_UNSET;
     gpu->coreCount = FF_GPU_CORE_COUNT_UNSET;
     gpu->type = FF_GPU_TYPE_INTEGRATED;
     gpu->dedicated.total = gpu->dedicated.used = gpu->shared.total = gpu->shared.used = FF_GPU_VMEM_SIZE_UNSET;
     gpu->frequency = FF_GPU_FREQUENCY_UNSET;
+    gpu->usage = gpu->memoryBandwidthUsage = FF_GPU_USAGE_UNSET;
 
-    pciDetectDriver(gpu, drmDir, buffer, drmKey);
+    pciDetectDriver(gpu, &device->deviceDir, &buffer, device->drmKey);
 
     #if FF_HAVE_ASAHI_DRM_H
-    ffStrbufSetS(buffer, "/dev/dri/");
-    ffStrbufAppendS(buffer, drmKey);
-    FF_AUTO_CLOSE_FD int fd = open(buffer->chars, O_RDONLY);
+    ffStrbufSetS(&buffer, "/dev/dri/");
+    ffStrbufAppendS(&buffer, device->drmKey);
+    FF_AUTO_CLOSE_FD int fd = open(buffer.chars, O_RDONLY);
     if (fd >= 0)
     {
         struct drm_asahi_params_global paramsGlobal = {};
@@ -375,8 +457,297 @@ FF_MAYBE_UNUSED static const char* detectAsahi(FFlist* gpus, FFstrbuf* buffer, F
         }
     }
     #endif
+}
 
-    return NULL;
+// https://docs.kernel.org/gpu/drm-usage-stats.html
+typedef struct FFGPUEngineSample
+{
+    char pdev[16]; // PCI slot name, e.g. "0000:03:00.0"
+    char engine[32];
+    uint64_t clientId;
+    uint64_t busyNs;
+    uint32_t capacity;
+} FFGPUEngineSample;
+
+static FFlist engineSamples1;
+static uint64_t engineTime1;
+
+static void drmParseFdinfo(FFstrbuf* content, FFlist* samples)
+{
+    char pdev[16] = "";
+    uint64_t clientId = 0;
+    uint32_t firstIndex = samples->length;
+
+    char* next;
+    for (char* line = content->chars; line && *line; line = next)
+    {
+        next = strchr(line, '\n');
+        if (next) *next++ = '\0';
+
+        char* value = strchr(line, ':');
+        if (!value) continue;
+        *value++ = '\0';
+        while (*value == ' ' || *value == '\t') ++value;
+
+        if (ffStrEquals(line, "drm-pdev"))
+            snprintf(pdev, sizeof(pdev), "%s", value);
+        else if (ffStrEquals(line, "drm-client-id"))
+            clientId = strtoull(value, NULL, 10);
+        else if (ffStrStartsWith(line, "drm-engine-capacity-"))
+        {
+            const char* engine = line + strlen("drm-engine-capacity-");
+            for (uint32_t i = firstIndex; i < samples->length; ++i)
+            {
+                FFGPUEngineSample* sample = ffListGet(samples, i);
+                if (ffStrEquals(sample->engine, engine))
+                    sample->capacity = (uint32_t) strtoul(value, NULL, 10) ?: 1;
+            }
+        }
+        else if (ffStrStartsWith(line, "drm-engine-") && ffStrEndsWith(value, " ns"))
+        {
+            FFGPUEngineSample* sample = ffListAdd(samples);
+            snprintf(sample->engine, sizeof(sample->engine), "%s", line + strlen("drm-engine-"));
+            sample->busyNs = strtoull(value, NULL, 10);
+            sample->capacity = 1;
+        }
+    }
+
+    if (pdev[0] == '\0')
+    {
+        // Not a PCI device
+        samples->length = firstIndex;
+        return;
+    }
+
+    for (uint32_t i = firstIndex; i < samples->length; ++i)
+    {
+        FFGPUEngineSample* sample = ffListGet(samples, i);
+
+        // A client may be shared by several fds (dup, fork). Count it only once
+        bool duplicated = false;
+        for (uint32_t j = 0; j < firstIndex; ++j)
+        {
+            FFGPUEngineSample* other = ffListGet(samples, j);
+            if (other->clientId == clientId && ffStrEquals(other->pdev, pdev) && ffStrEquals(other->engine, sample->engine))
+            {
+                duplicated = true;
+                break;
+            }
+        }
+        if (duplicated)
+        {
+            samples->length = firstIndex;
+            return;
+        }
+
+        memcpy(sample->pdev, pdev, sizeof(pdev));
+        sample->clientId = clientId;
+    }
+}
+
+// Collect per-client engine busy time from fdinfo of every DRM fd we are allowed to inspect
+static void drmSampleEngines(FFlist* samples)
+{
+    FF_AUTO_CLOSE_DIR DIR* procDir = opendir("/proc");
+    if (!procDir) return;
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreateA(64);
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+
+    struct dirent* procEntry;
+    while ((procEntry = readdir(procDir)) != NULL)
+    {
+        if (procEntry->d_name[0] < '0' || procEntry->d_name[0] > '9')
+            continue;
+
+        ffStrbufSetF(&path, "/proc/%s/fd", procEntry->d_name);
+        FF_AUTO_CLOSE_DIR DIR* fdDir = opendir(path.chars);
+        if (!fdDir) continue; // EACCES for processes of other users
+
+        struct dirent* fdEntry;
+        while ((fdEntry = readdir(fdDir)) != NULL)
+        {
+            if (fdEntry->d_name[0] == '.')
+                continue;
+
+            char target[32];
+            ssize_t length = readlinkat(dirfd(fdDir), fdEntry->d_name, target, sizeof(target) - 1);
+            if (length <= 0) continue;
+            target[length] = '\0';
+            if (!ffStrStartsWith(target, "/dev/dri/"))
+                continue;
+
+            ffStrbufSetF(&path, "/proc/%s/fdinfo/%s", procEntry->d_name, fdEntry->d_name);
+            if (ffReadFileBuffer(path.chars, &content))
+                drmParseFdinfo(&content, samples);
+        }
+    }
+}
+
+static void drmPrepareEngineSamples(void)
+{
+    ffListInit(&engineSamples1, sizeof(FFGPUEngineSample));
+    drmSampleEngines(&engineSamples1);
+    engineTime1 = ffTimeGetTick();
+}
+
+void ffPrepareGPUUsage(FFGPUOptions* options)
+{
+    // Scanning the fds of every process is costly. The samples are only used by the DRM detection, which runs with the auto method
+    if (options->usage && options->detectionMethod == FF_GPU_DETECTION_METHOD_AUTO && engineTime1 == 0)
+        drmPrepareEngineSamples();
+}
+
+// Usage of the busiest engine class of the given device, between the two samples
+static double drmCalcUsage(const char* pdev, const FFlist* samples2, uint64_t elapsedNs)
+{
+    FF_LIST_AUTO_DESTROY engines = ffListCreate(sizeof(FFGPUEngineSample));
+
+    FF_LIST_FOR_EACH(FFGPUEngineSample, sample2, *samples2)
+    {
+        if (!ffStrEquals(sample2->pdev, pdev)) continue;
+
+        uint64_t busyNs = sample2->busyNs; // New client
+        FF_LIST_FOR_EACH(FFGPUEngineSample, sample1, engineSamples1)
+        {
+            if (sample1->clientId == sample2->clientId && ffStrEquals(sample1->pdev, pdev) && ffStrEquals(sample1->engine, sample2->engine))
+            {
+                busyNs = sample2->busyNs > sample1->busyNs ? sample2->busyNs - sample1->busyNs : 0;
+                break;
+            }
+        }
+
+        FFGPUEngineSample* engine = NULL;
+        FF_LIST_FOR_EACH(FFGPUEngineSample, x, engines)
+        {
+            if (ffStrEquals(x->engine, sample2->engine))
+            {
+                engine = x;
+                break;
+            }
+        }
+        if (!engine)
+        {
+            engine = ffListAdd(&engines);
+            *engine = *sample2;
+            engine->busyNs = 0;
+        }
+        engine->busyNs += busyNs;
+    }
+
+    if (engines.length == 0) return FF_GPU_USAGE_UNSET;
+
+    double result = 0;
+    FF_LIST_FOR_EACH(FFGPUEngineSample, engine, engines)
+    {
+        double usage = (double) engine->busyNs / (double) (elapsedNs * engine->capacity) * 100;
+        if (usage > result) result = usage;
+    }
+    return result > 100 ? 100 : result;
+}
+
+// Fallback for drivers that don't report usage directly (i915, xe, nouveau, etc)
+static void drmDetectUsage(FFlist* devices)
+{
+    bool needed = false;
+    FF_LIST_FOR_EACH(FFGPUDevice, device, *devices)
+    {
+        if (device->options->usage && device->kind == FF_GPU_DEVICE_KIND_PCI && device->gpu.usage != device->gpu.usage)
+        {
+            needed = true;
+            break;
+        }
+    }
+    if (!needed) return;
+
+    if (engineTime1 == 0)
+        drmPrepareEngineSamples();
+
+    uint64_t elapsed = ffTimeGetTick() - engineTime1;
+    if (elapsed < 200)
+        ffTimeSleep((uint32_t) (200 - elapsed));
+
+    FF_LIST_AUTO_DESTROY engineSamples2 = ffListCreate(sizeof(FFGPUEngineSample));
+    drmSampleEngines(&engineSamples2);
+    uint64_t engineTime2 = ffTimeGetTick();
+
+    FF_LIST_FOR_EACH(FFGPUDevice, device, *devices)
+    {
+        if (device->kind != FF_GPU_DEVICE_KIND_PCI || device->gpu.usage == device->gpu.usage)
+            continue;
+
+        char pdev[16];
+        snprintf(pdev, sizeof(pdev), "%04x:%02x:%02x.%x", device->pciDomain, device->pciBus, device->pciDevice, device->pciFunc);
+        device->gpu.usage = drmCalcUsage(pdev, &engineSamples2, (engineTime2 - engineTime1) * 1000000);
+    }
+
+    // Another GPU module starts over with a new first sample
+    ffListDestroy(&engineSamples1);
+    engineTime1 = 0;
+}
+
+static void probeDevice(FFGPUDevice* device)
+{
+    #ifdef __aarch64__
+    if (device->kind == FF_GPU_DEVICE_KIND_ASAHI)
+    {
+        probeAsahi(device);
+        return;
+    }
+    #endif
+    probePci(device);
+}
+
+#ifdef FF_HAVE_THREADS
+FF_THREAD_ENTRY_DECL_WRAPPER(probeDevice, FFGPUDevice*)
+#endif
+
+static int compareDevices(const FFGPUDevice* a, const FFGPUDevice* b)
+{
+    if (a->pciDomain != b->pciDomain) return a->pciDomain < b->pciDomain ? -1 : 1;
+    if (a->pciBus != b->pciBus) return a->pciBus < b->pciBus ? -1 : 1;
+    if (a->pciDevice != b->pciDevice) return a->pciDevice < b->pciDevice ? -1 : 1;
+    if (a->pciFunc != b->pciFunc) return a->pciFunc < b->pciFunc ? -1 : 1;
+    return strcmp(a->drmKey, b->drmKey);
+}
+
+// Probe every discovered device (concurrently if allowed), then append the results to `gpus` in PCI order
+static void probeDevices(FFlist* devices, FFlist* gpus)
+{
+    ffListSort(devices, (const void*) compareDevices);
+
+    #ifdef FF_HAVE_THREADS
+    if (instance.config.general.multithreading && devices->length > 1)
+    {
+        FF_AUTO_FREE FFThreadType* threads = calloc(devices->length, sizeof(*threads));
+        for (uint32_t i = 1; i < devices->length; ++i)
+            threads[i] = ffThreadCreate(probeDeviceThreadMain, ffListGet(devices, i));
+
+        probeDevice(ffListGet(devices, 0));
+
+        for (uint32_t i = 1; i < devices->length; ++i)
+        {
+            if (threads[i])
+                ffThreadJoin(threads[i], 0);
+            else
+                probeDevice(ffListGet(devices, i));
+        }
+    }
+    else
+    #endif
+    {
+        FF_LIST_FOR_EACH(FFGPUDevice, device, *devices)
+            probeDevice(device);
+    }
+
+    if (devices->length > 0)
+        drmDetectUsage(devices);
+
+    FF_LIST_FOR_EACH(FFGPUDevice, device, *devices)
+    {
+        *(FFGPUResult*) ffListAdd(gpus) = device->gpu;
+        ffStrbufDestroy(&device->deviceDir);
+    }
 }
 
 static const char* drmDetectGPUs(const FFGPUOptions* options, FFlist* gpus)
@@ -390,6 +761,7 @@ static const char* drmDetectGPUs(const FFGPUOptions* options, FFlist* gpus)
         return "Failed to open `/sys/class/drm/`";
 
     FF_STRBUF_AUTO_DESTROY buffer = ffStrbufCreate();
+    FF_LIST_AUTO_DESTROY devices = ffListCreate(sizeof(FFGPUDevice));
 
     struct dirent* entry;
     while ((entry = readdir(dir)) != NULL)
@@ -402,19 +774,23 @@ static const char* drmDetectGPUs(const FFGPUOptions* options, FFlist* gpus)
 
         ffStrbufAppendS(&drmDir, "/device/modalias");
         if (!ffReadFileBuffer(drmDir.chars, &buffer))
+        {
+            ffStrbufSubstrBefore(&drmDir, drmDirLength);
             continue;
+        }
         ffStrbufSubstrBefore(&drmDir, drmDir.length - (uint32_t) strlen("/modalias"));
 
         if (ffStrbufStartsWithS(&buffer, "pci:"))
-            detectPci(options, gpus, &buffer, &drmDir, entry->d_name);
+            discoverPci(options, &devices, &buffer, &drmDir, entry->d_name);
         #ifdef __aarch64__
         else if (ffStrbufStartsWithS(&buffer, "of:"))
-            detectAsahi(gpus, &buffer, &drmDir, entry->d_name);
+            discoverAsahi(options, &devices, &buffer, &drmDir, entry->d_name);
         #endif
 
         ffStrbufSubstrBefore(&drmDir, drmDirLength);
     }
 
+    probeDevices(&devices, gpus);
     return NULL;
 }
 
@@ -434,6 +810,7 @@ static const char* pciDetectGPUs(const FFGPUOptions* options, FFlist* gpus)
     const uint32_t pciBaseDirLength = pciDir.length;
 
     FF_STRBUF_AUTO_DESTROY buffer = ffStrbufCreate();
+    FF_LIST_AUTO_DESTROY devices = ffListCreate(sizeof(FFGPUDevice));
 
     struct dirent* entry;
     while((entry = readdir(dirp)) != NULL)
@@ -451,10 +828,11 @@ static const char* pciDetectGPUs(const FFGPUOptions* options, FFlist* gpus)
         ffStrbufSubstrBefore(&pciDir, pciDevDirLength);
         assert(ffStrbufStartsWithS(&buffer, "pci:"));
 
-        detectPci(options, gpus, &buffer, &pciDir, NULL);
+        discoverPci(options, &devices, &buffer, &pciDir, NULL);
         ffStrbufSubstrBefore(&pciDir, pciBaseDirLength);
     }
 
+    probeDevices(&devices, gpus);
     return NULL;
 }
 
@@ -5,3 +5,8 @@ const char* ffDetectGPUImpl(const FFGPUOptions* options, FFlist* gpus)
     FF_UNUSED(options, gpus);
     return "Not supported on this platform";
 }
+
+void ffPrepareGPUUsage(FFGPUOptions* options)
+{
+    FF_UNUSED(options);
+}
@@ -2,6 +2,7 @@
 
 #include "3rdparty/nvml/nvml.h"
 #include "common/library.h"
+#include "common/thread.h"
 
 struct FFNvmlData {
     FF_LIBRARY_SYMBOL(nvmlDeviceGetCount_v2)
@@ -13,36 +14,51 @@ struct FFNvmlData {
     FF_LIBRARY_SYMBOL(nvmlDeviceGetNumGpuCores)
     FF_LIBRARY_SYMBOL(nvmlDeviceGetMaxClockInfo)
     FF_LIBRARY_SYMBOL(nvmlDeviceGetBrand)
+    FF_LIBRARY_SYMBOL(nvmlDeviceGetUtilizationRates)
 
     bool inited;
-} nvmlData;
+    FFThreadMutex mutex; // GPUs may be probed concurrently; nvml is initialized only once
+} nvmlData = { .mutex = FF_THREAD_MUTEX_INITIALIZER };
+
+static const char* loadNvml(const char* soName)
+{
+    FF_LIBRARY_LOAD(libnvml, NULL, "dlopen nvml failed", soName , 1);
+    FF_LIBRARY_LOAD_SYMBOL_MESSAGE(libnvml, nvmlInit_v2)
+    FF_LIBRARY_LOAD_SYMBOL_MESSAGE(libnvml, nvmlShutdown)
+    FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetCount_v2)
+    FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetHandleByIndex_v2)
+    FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetHandleByPciBusId_v2)
+    FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetPciInfo_v3)
+    FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetTemperature)
+    FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetMemoryInfo_v2)
+    FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetNumGpuCores)
+    FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetMaxClockInfo)
+    FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetBrand)
+    FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetUtilizationRates)
+
+    if (ffnvmlInit_v2() != NVML_SUCCESS)
+    {
+        nvmlData.ffnvmlDeviceGetNumGpuCores = NULL;
+        return "nvmlInit_v2() failed";
+    }
+    atexit((void*) ffnvmlShutdown);
+    return NULL;
+}
 
 const char* ffDetectNvidiaGpuInfo(const FFGpuDriverCondition* cond, FFGpuDriverResult result, const char* soName)
 {
+    ffThreadMutexLock(&nvmlData.mutex);
     if (!nvmlData.inited)
     {
         nvmlData.inited = true;
-        FF_LIBRARY_LOAD(libnvml, NULL, "dlopen nvml failed", soName , 1);
-        FF_LIBRARY_LOAD_SYMBOL_MESSAGE(libnvml, nvmlInit_v2)
-        FF_LIBRARY_LOAD_SYMBOL_MESSAGE(libnvml, nvmlShutdown)
-        FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetCount_v2)
-        FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetHandleByIndex_v2)
-        FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetHandleByPciBusId_v2)
-        FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetPciInfo_v3)
-        FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetTemperature)
-        FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetMemoryInfo_v2)
-        FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetNumGpuCores)
-        FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetMaxClockInfo)
-        FF_LIBRARY_LOAD_SYMBOL_VAR_MESSAGE(libnvml, nvmlData, nvmlDeviceGetBrand)
-
-        if (ffnvmlInit_v2() != NVML_SUCCESS)
+        const char* error = loadNvml(soName);
+        if (error)
         {
-            nvmlData.ffnvmlDeviceGetNumGpuCores = NULL;
-            return "nvmlInit_v2() failed";
+            ffThreadMutexUnlock(&nvmlData.mutex);
+            return error;
         }
-        atexit((void*) ffnvmlShutdown);
-        libnvml = NULL; // don't close nvml
     }
+    ffThreadMutexUnlock(&nvmlData.mutex);
 
     if (nvmlData.ffnvmlDeviceGetNumGpuCores == NULL)
         return "loading nvml library failed";
@@ -126,5 +142,18 @@ const char* ffDetectNvidiaGpuInfo(const FFGpuDriverCondition* cond, FFGpuDriverR
             *result.frequency = clockMHz / 1000.;
     }
 
+    if (result.usage || result.memoryBandwidthUsage)
+    {
+        // Averaged by the driver over its own sample period (1/6 s to 1 s)
+        nvmlUtilization_t utilization;
+        if (nvmlData.ffnvmlDeviceGetUtilizationRates(device, &utilization) == NVML_SUCCESS)
+        {
+            if (result.usage)
+                *result.usage = utilization.gpu;
+            if (result.memoryBandwidthUsage)
+                *result.memoryBandwidthUsage = utilization.memory;
+        }
+    }
+
     return NULL;
 }
@@ -91,6 +91,7 @@ const char* ffDetectGPUImpl(FF_MAYBE_UNUSED const FFGPUOptions* options, FFlist*
         gpu->dedicated.total = gpu->dedicated.used = gpu->shared.total = gpu->shared.used = FF_GPU_VMEM_SIZE_UNSET;
         gpu->deviceId = 0;
         gpu->frequency = FF_GPU_FREQUENCY_UNSET;
+        gpu->usage = gpu->memoryBandwidthUsage = FF_GPU_USAGE_UNSET;
 
         if (deviceKeyLength == 100 && displayDevice.DeviceKey[deviceKeyPrefixLength - 1] == '{')
         {
@@ -148,7 +149,7 @@ const char* ffDetectGPUImpl(FF_MAYBE_UNUSED const FFGPUOptions* options, FFlist*
         __typeof__(&ffDetectNvidiaGpuInfo) detectFn;
         const char* dllName;
 
-        if (getDriverSpecificDetectionFn(gpu->vendor.chars, &detectFn, &dllName) && (options->temp || options->driverSpecific))
+        if (getDriverSpecificDetectionFn(gpu->vendor.chars, &detectFn, &dllName) && (options->temp || options->driverSpecific || options->usage))
         {
             if (vendorId && deviceId && subSystemId && revId)
             {
@@ -169,6 +170,8 @@ const char* ffDetectGPUImpl(FF_MAYBE_UNUSED const FFGPUOptions* options, FFlist*
                         .coreCount = options->driverSpecific ? (uint32_t*) &gpu->coreCount : NULL,
                         .type = &gpu->type,
                         .frequency = &gpu->frequency,
+                        .usage = options->usage ? &gpu->usage : NULL,
+                        .memoryBandwidthUsage = options->usage ? &gpu->memoryBandwidthUsage : NULL,
                     },
                     dllName
                 );
@@ -179,3 +182,9 @@ const char* ffDetectGPUImpl(FF_MAYBE_UNUSED const FFGPUOptions* options, FFlist*
 
     return NULL;
 }
+
+void ffPrepareGPUUsage(FFGPUOptions* options)
+{
+    // Usage is reported by the driver directly, if supported. Nothing to sample
+    FF_UNUSED(options);
+}
@@ -68,6 +68,7 @@ const char* ffGPUDetectByDirectX(FF_MAYBE_UNUSED const FFGPUOptions* options, FF
         gpu->coreCount = FF_GPU_CORE_COUNT_UNSET;
         gpu->temperature = FF_GPU_TEMP_UNSET;
         gpu->frequency = FF_GPU_FREQUENCY_UNSET;
+        gpu->usage = gpu->memoryBandwidthUsage = FF_GPU_USAGE_UNSET;
         ffStrbufInitStatic(&gpu->platformApi, "DXCore");
 
         ffStrbufInit(&gpu->driver);
@@ -100,7 +101,7 @@ const char* ffGPUDetectByDirectX(FF_MAYBE_UNUSED const FFGPUOptions* options, FF
             ffStrbufSetStatic(&gpu->vendor, vendorStr);
 
             #ifdef FF_USE_PROPRIETARY_GPU_DRIVER_API
-            if (vendorStr == FF_GPU_VENDOR_NAME_NVIDIA && (options->driverSpecific || options->temp))
+            if (vendorStr == FF_GPU_VENDOR_NAME_NVIDIA && (options->driverSpecific || options->temp || options->usage))
             {
                 FFGpuDriverCondition cond = {
                     .type = FF_GPU_DRIVER_CONDITION_TYPE_DEVICE_ID,
@@ -117,6 +118,8 @@ const char* ffGPUDetectByDirectX(FF_MAYBE_UNUSED const FFGPUOptions* options, FF
                     .coreCount = options->driverSpecific ? (uint32_t*) &gpu->coreCount : NULL,
                     .type = &gpu->type,
                     .frequency = &gpu->frequency,
+                    .usage = options->usage ? &gpu->usage : NULL,
+                    .memoryBandwidthUsage = options->usage ? &gpu->memoryBandwidthUsage : NULL,
                 }, "/usr/lib/wsl/lib/libnvidia-ml.so");
             }
             #endif
@@ -47,17 +47,99 @@ static void getHostSerialNumber(FFstrbuf* serial)
     ffStrbufClear(serial);
 }
 
+static bool detectFromSmbios(FFHostResult* host)
+{
+    const FFSmbiosHeaderTable* smbiosTable = ffGetSmbiosHeaderTable();
+    if (!smbiosTable)
+        return false;
+
+    const FFSmbiosSystemInfo* data = (const FFSmbiosSystemInfo*) (*smbiosTable)[FF_SMBIOS_TYPE_SYSTEM_INFO];
+    if (!data)
+        return false;
+
+    const char* strings = (const char*) data + data->Header.Length;
+
+    ffStrbufSetStatic(&host->vendor, ffSmbiosLocateString(strings, data->Manufacturer));
+    ffCleanUpSmbiosValue(&host->vendor);
+    ffStrbufSetStatic(&host->name, ffSmbiosLocateString(strings, data->ProductName));
+    ffCleanUpSmbiosValue(&host->name);
+    ffStrbufSetStatic(&host->version, ffSmbiosLocateString(strings, data->Version));
+    ffCleanUpSmbiosValue(&host->version);
+    ffStrbufSetStatic(&host->serial, ffSmbiosLocateString(strings, data->SerialNumber));
+    ffCleanUpSmbiosValue(&host->serial);
+
+    if (data->Header.Length >= offsetof(FFSmbiosSystemInfo, WakeUpType))
+    {
+        // All 0x00 or all 0xFF means unset; the kernel doesn't export `product_uuid` then
+        const uint8_t* uuid = (const uint8_t*) &data->UUID;
+        bool allFF = true, all00 = true;
+        for (uint32_t i = 0; i < sizeof(data->UUID); ++i)
+        {
+            allFF = allFF && uuid[i] == 0xFF;
+            all00 = all00 && uuid[i] == 0x00;
+        }
+
+        if (!allFF && !all00)
+        {
+            uint16_t version = ffGetSmbiosVersion();
+            if (version == 0)
+            {
+                // The byte order depends on the version. The kernel knows it
+                ffGetSmbiosValue("/sys/devices/virtual/dmi/id/product_uuid", "/sys/class/dmi/id/product_uuid", &host->uuid);
+            }
+            else
+            {
+                // Same format as `product_uuid`. Since SMBIOS 2.6 the first three fields are little-endian; before, all bytes are in network order.
+                // Formatted byte by byte, so the result doesn't depend on our own byte order
+                static const uint8_t littleEndian[16] = { 3, 2, 1, 0, 5, 4, 7, 6, 8, 9, 10, 11, 12, 13, 14, 15 };
+                static const uint8_t bigEndian[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+                const uint8_t* order = version >= 0x0206 ? littleEndian : bigEndian;
+
+                ffStrbufEnsureFree(&host->uuid, 36);
+                for (uint32_t i = 0; i < 16; ++i)
+                {
+                    if (i == 4 || i == 6 || i == 8 || i == 10)
+                        ffStrbufAppendC(&host->uuid, '-');
+                    ffStrbufAppendF(&host->uuid, "%02x", uuid[order[i]]);
+                }
+            }
+        }
+    }
+
+    if (data->Header.Length > offsetof(FFSmbiosSystemInfo, SKUNumber))
+    {
+        ffStrbufSetStatic(&host->sku, ffSmbiosLocateString(strings, data->SKUNumber));
+        ffCleanUpSmbiosValue(&host->sku);
+    }
+
+    if (data->Header.Length > offsetof(FFSmbiosSystemInfo, Family))
+    {
+        ffStrbufSetStatic(&host->family, ffSmbiosLocateString(strings, data->Family));
+        ffCleanUpSmbiosValue(&host->family);
+    }
+
+    return true;
+}
+
 const char* ffDetectHost(FFHostResult* host)
 {
-    ffGetSmbiosValue("/sys/devices/virtual/dmi/id/product_family", "/sys/class/dmi/id/product_family", &host->family);
-    if (!ffGetSmbiosValue("/sys/devices/virtual/dmi/id/product_name", "/sys/class/dmi/id/product_name", &host->name))
+    // /sys/firmware/dmi/tables/DMI is only readable by root. Use the per-value files of the kernel otherwise
+    if (!detectFromSmbios(host))
+    {
+        ffGetSmbiosValue("/sys/devices/virtual/dmi/id/product_family", "/sys/class/dmi/id/product_family", &host->family);
+        ffGetSmbiosValue("/sys/devices/virtual/dmi/id/product_name", "/sys/class/dmi/id/product_name", &host->name);
+        ffGetSmbiosValue("/sys/devices/virtual/dmi/id/product_version", "/sys/class/dmi/id/product_version", &host->version);
+        ffGetSmbiosValue("/sys/devices/virtual/dmi/id/product_sku", "/sys/class/dmi/id/product_sku", &host->sku);
+        ffGetSmbiosValue("/sys/devices/virtual/dmi/id/product_serial", "/sys/class/dmi/id/product_serial", &host->serial);
+        ffGetSmbiosValue("/sys/devices/virtual/dmi/id/product_uuid", "/sys/class/dmi/id/product_uuid", &host->uuid);
+        ffGetSmbiosValue("/sys/devices/virtual/dmi/id/sys_vendor", "/sys/class/dmi/id/sys_vendor", &host->vendor);
+    }
+
+    if (host->name.length == 0)
         getHostProductName(&host->name);
-    ffGetSmbiosValue("/sys/devices/virtual/dmi/id/product_version", "/sys/class/dmi/id/product_version", &host->version);
-    ffGetSmbiosValue("/sys/devices/virtual/dmi/id/product_sku", "/sys/class/dmi/id/product_sku", &host->sku);
-    if (!ffGetSmbiosValue("/sys/devices/virtual/dmi/id/product_serial", "/sys/class/dmi/id/product_serial", &host->serial))
+    if (host->serial.length == 0)
         getHostSerialNumber(&host->serial);
-    ffGetSmbiosValue("/sys/devices/virtual/dmi/id/product_uuid", "/sys/class/dmi/id/product_uuid", &host->uuid);
-    if (!ffGetSmbiosValue("/sys/devices/virtual/dmi/id/sys_vendor", "/sys/class/dmi/id/sys_vendor", &host->vendor))
+    if (host->vendor.length == 0)
     {
         if (ffStrbufStartsWithS(&host->name, "Apple "))
             ffStrbufSetStatic(&host->vendor, "Apple Inc.");
@@ -1,34 +1,6 @@
 #include "host.h"
 #include "util/smbiosHelper.h"
 
-typedef struct FFSmbiosSystemInfo
-{
-    FFSmbiosHeader Header;
-
-    uint8_t Manufacturer; // string
-    uint8_t ProductName; // string
-    uint8_t Version; // string
-    uint8_t SerialNumber; // string
-
-    // 2.1+
-    struct {
-        uint32_t TimeLow;
-        uint16_t TimeMid;
-        uint16_t TimeHighAndVersion;
-        uint8_t ClockSeqHiAndReserved;
-        uint8_t ClockSeqLow;
-        uint8_t Node[6];
-    } __attribute__((__packed__)) UUID; // varies
-    uint8_t WakeUpType; // enum
-
-    // 2.4+
-    uint8_t SKUNumber; // string
-    uint8_t Family; // string
-} __attribute__((__packed__)) FFSmbiosSystemInfo;
-
-static_assert(offsetof(FFSmbiosSystemInfo, Family) == 0x1A,
-    "FFSmbiosSystemInfo: Wrong struct alignment");
-
 const char* ffDetectHost(FFHostResult* host)
 {
     const FFSmbiosHeaderTable* smbiosTable = ffGetSmbiosHeaderTable();
@@ -1,4 +1,5 @@
 #include "lm.h"
+#include "common/binary.h"
 #include "common/properties.h"
 #include "common/dbus.h"
 #include "common/processing.h"
@@ -11,28 +12,34 @@
 
 static const char* getGdmVersion(FFstrbuf* version)
 {
-    const char* error = ffProcessAppendStdOut(version, (char* const[]) {
-        "gdm",
-        "--version",
-        NULL
-    });
-    if (error || version->length == 0)
+    // Distros name the binary either gdm or gdm3; ask both at once
+    FF_STRBUF_AUTO_DESTROY gdm3 = ffStrbufCreate();
+    FFProcessRequest requests[] = {
+        { .argv = (char* const[]) { "gdm", "--version", NULL }, .buffer = version },
+        { .argv = (char* const[]) { "gdm3", "--version", NULL }, .buffer = &gdm3 },
+    };
+    ffProcessAppendOutputs(requests, 2);
+
+    if (requests[0].error || version->length == 0)
     {
-        error = ffProcessAppendStdOut(version, (char* const[]) {
-            "gdm3",
-            "--version",
-            NULL
-        });
-        if (error || version->length == 0) return "Failed to get GDM version";
+        if (requests[1].error || gdm3.length == 0) return "Failed to get GDM version";
+        ffStrbufSet(version, &gdm3);
     }
 
     // GDM 44.1
+    ffStrbufTrimRightSpace(version);
     ffStrbufSubstrAfterFirstC(version, ' ');
     return NULL;
 }
 
 static const char* getSshdVersion(FFstrbuf* version)
 {
+    // OpenSSH_9.2p1 Debian-2+deb12u3
+    const FFBinaryVersionPattern pattern = { "OpenSSH_", NULL, "," };
+    if (ffBinaryFindVersion(FASTFETCH_TARGET_DIR_USR "/sbin/sshd", &pattern, version) ||
+        ffBinaryFindVersion(FASTFETCH_TARGET_DIR_USR "/bin/sshd", &pattern, version))
+        return NULL;
+
     const char* error = ffProcessAppendStdErr(version, (char* const[]) {
         "sshd",
         "-qv",
@@ -61,8 +61,66 @@ static void addNewIp(FFlist* list, const char* name, const char* addr, int type,
     }
 }
 
+#ifdef __linux__
+static const char* detectWithNetif(const FFLocalIpOptions* options, FFlist* results, const FFlist* interfaces)
+{
+    const char* defaultRouteIfName = ffNetifGetDefaultRouteIfName();
+    bool firstOnly = !(options->showType & FF_LOCALIP_TYPE_ALL_IPS_BIT);
+
+    FF_LIST_FOR_EACH(FFNetifInterface, inf, *interfaces)
+    {
+        if (!(inf->flags & IFF_RUNNING))
+            continue;
+
+        bool isDefaultRoute = ffStrEquals(defaultRouteIfName, inf->name);
+        if ((options->showType & FF_LOCALIP_TYPE_DEFAULT_ROUTE_ONLY_BIT) && !isDefaultRoute)
+            continue;
+
+        if ((inf->flags & IFF_LOOPBACK) && !(options->showType & FF_LOCALIP_TYPE_LOOP_BIT))
+            continue;
+
+        if (options->namePrefix.length && strncmp(inf->name, options->namePrefix.chars, options->namePrefix.length) != 0)
+            continue;
+
+        if ((options->showType & FF_LOCALIP_TYPE_MAC_BIT) && inf->macLength == 6)
+        {
+            char addressBuffer[32];
+            snprintf(addressBuffer, sizeof(addressBuffer), "%02x:%02x:%02x:%02x:%02x:%02x",
+                        inf->mac[0], inf->mac[1], inf->mac[2], inf->mac[3], inf->mac[4], inf->mac[5]);
+            addNewIp(results, inf->name, addressBuffer, -1, isDefaultRoute, false);
+        }
+
+        FF_LIST_FOR_EACH(FFNetifAddress, addr, inf->addresses)
+        {
+            if (addr->family == AF_INET ? !(options->showType & FF_LOCALIP_TYPE_IPV4_BIT) : !(options->showType & FF_LOCALIP_TYPE_IPV6_BIT))
+                continue;
+
+            char addressBuffer[INET6_ADDRSTRLEN + 4];
+            inet_ntop(addr->family, addr->addr, addressBuffer, INET6_ADDRSTRLEN);
+
+            if ((options->showType & FF_LOCALIP_TYPE_PREFIX_LEN_BIT) && addr->prefixLength != 0)
+            {
+                size_t len = strlen(addressBuffer);
+                snprintf(addressBuffer + len, 5, "/%u", (unsigned) addr->prefixLength);
+            }
+
+            addNewIp(results, inf->name, addressBuffer, addr->family, isDefaultRoute, firstOnly);
+        }
+    }
+
+    return NULL;
+}
+#endif
+
 const char* ffDetectLocalIps(const FFLocalIpOptions* options, FFlist* results)
 {
+    #ifdef __linux__
+    // Links and addresses from netlink, shared with the other network modules
+    const FFlist* interfaces = ffNetifGetInterfaces();
+    if (interfaces)
+        return detectWithNetif(options, results, interfaces);
+    #endif
+
     struct ifaddrs* ifAddrStruct = NULL;
     if(getifaddrs(&ifAddrStruct) < 0)
         return "getifaddrs(&ifAddrStruct) failed";
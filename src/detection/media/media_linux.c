@@ -11,32 +11,31 @@
 #include "common/dbus.h"
 #include "common/library.h"
 
-static bool getBusProperties(FFDBusData* data, const char* busName, FFMediaResult* result)
+#define FF_DBUS_MPRIS_PATH "/org/mpris/MediaPlayer2"
+
+static inline FFDBusCall getMetadataCall(const char* busName)
 {
-    DBusMessage* reply = ffDBusGetProperty(data, busName, "/org/mpris/MediaPlayer2", "org.mpris.MediaPlayer2.Player", "Metadata");
-    if(reply == NULL)
-        return false;
+    return (FFDBusCall) {
+        .busName = busName,
+        .objectPath = FF_DBUS_MPRIS_PATH,
+        .interface = "org.mpris.MediaPlayer2.Player",
+        .property = "Metadata",
+    };
+}
 
+static void parseMetadata(FFDBusData* data, DBusMessage* reply, FFMediaResult* result)
+{
     DBusMessageIter rootIterator;
     if(!data->lib->ffdbus_message_iter_init(reply, &rootIterator))
-    {
-        data->lib->ffdbus_message_unref(reply);
-        return false;
-    }
+        return;
 
     if(data->lib->ffdbus_message_iter_get_arg_type(&rootIterator) != DBUS_TYPE_VARIANT)
-    {
-        data->lib->ffdbus_message_unref(reply);
-        return false;
-    }
+        return;
 
     DBusMessageIter variantIterator;
     data->lib->ffdbus_message_iter_recurse(&rootIterator, &variantIterator);
     if(data->lib->ffdbus_message_iter_get_arg_type(&variantIterator) != DBUS_TYPE_ARRAY)
-    {
-        data->lib->ffdbus_message_unref(reply);
-        return false;
-    }
+        return;
 
     DBusMessageIter arrayIterator;
     data->lib->ffdbus_message_iter_recurse(&variantIterator, &arrayIterator);
@@ -74,8 +73,15 @@ static bool getBusProperties(FFDBusData* data, const char* busName, FFMediaResul
 
         FF_DBUS_ITER_CONTINUE(data, &arrayIterator)
     }
+}
 
-    data->lib->ffdbus_message_unref(reply);
+// `metadata` is the reply of the Metadata call of `busName`, or NULL
+static bool getBusProperties(FFDBusData* data, const char* busName, DBusMessage* metadata, FFMediaResult* result)
+{
+    if(metadata == NULL)
+        return false;
+
+    parseMetadata(data, metadata, result);
 
     if(result->song.length == 0)
     {
@@ -88,10 +94,22 @@ static bool getBusProperties(FFDBusData* data, const char* busName, FFMediaResul
     //Set short bus name
     ffStrbufAppendS(&result->playerId, busName + sizeof(FF_DBUS_MPRIS_PREFIX) - 1);
 
-    //We found a song, get the player name
-    ffDBusGetPropertyString(data, busName, "/org/mpris/MediaPlayer2", "org.mpris.MediaPlayer2", "Identity", &result->player);
-    if(result->player.length == 0)
-        ffDBusGetPropertyString(data, busName, "/org/mpris/MediaPlayer2", "org.mpris.MediaPlayer2", "DesktopEntry", &result->player);
+    //We found a song, get the player name. Ask for both candidates at once
+    FFDBusCall calls[] = {
+        { .busName = busName, .objectPath = FF_DBUS_MPRIS_PATH, .interface = "org.mpris.MediaPlayer2", .property = "Identity" },
+        { .busName = busName, .objectPath = FF_DBUS_MPRIS_PATH, .interface = "org.mpris.MediaPlayer2", .property = "DesktopEntry" },
+    };
+    ffDBusCallAll(data, calls, sizeof(calls) / sizeof(*calls));
+
+    for(uint32_t i = 0; i < sizeof(calls) / sizeof(*calls); ++i)
+    {
+        if(calls[i].reply == NULL)
+            continue;
+        if(result->player.length == 0)
+            ffDBusGetReplyString(data, calls[i].reply, &result->player);
+        data->lib->ffdbus_message_unref(calls[i].reply);
+    }
+
     if(result->player.length == 0)
         ffStrbufAppend(&result->player, &result->playerId);
 
@@ -100,36 +118,83 @@ static bool getBusProperties(FFDBusData* data, const char* busName, FFMediaResul
 
 static void getCustomBus(FFDBusData* data, const FFstrbuf* playerName, FFMediaResult* result)
 {
-    if(ffStrbufStartsWithS(playerName, FF_DBUS_MPRIS_PREFIX))
+    FF_STRBUF_AUTO_DESTROY busName = ffStrbufCreate();
+    if(!ffStrbufStartsWithS(playerName, FF_DBUS_MPRIS_PREFIX))
+        ffStrbufAppendS(&busName, FF_DBUS_MPRIS_PREFIX);
+    ffStrbufAppend(&busName, playerName);
+
+    FFDBusCall call = getMetadataCall(busName.chars);
+    ffDBusCallAll(data, &call, 1);
+    getBusProperties(data, busName.chars, call.reply, result);
+    if(call.reply)
+        data->lib->ffdbus_message_unref(call.reply);
+}
+
+static const char* const preferredBuses[] = {
+    FF_DBUS_MPRIS_PREFIX"spotify",
+    FF_DBUS_MPRIS_PREFIX"vlc",
+    FF_DBUS_MPRIS_PREFIX"plasma-browser-integration",
+};
+
+static bool isPreferredBus(const char* busName)
+{
+    for(uint32_t i = 0; i < sizeof(preferredBuses) / sizeof(*preferredBuses); ++i)
     {
-        getBusProperties(data, playerName->chars, result);
-        return;
+        if(ffStrEquals(busName, preferredBuses[i]))
+            return true;
     }
+    return false;
+}
 
-    FF_STRBUF_AUTO_DESTROY busName = ffStrbufCreateS(FF_DBUS_MPRIS_PREFIX);
-    ffStrbufAppend(&busName, playerName);
-    getBusProperties(data, busName.chars, result);
+// Takes the first player (in call order) that is playing something, and releases all replies
+static bool takeFirstBus(FFDBusData* data, FFDBusCall* calls, uint32_t count, FFMediaResult* result)
+{
+    bool found = false;
+    for(uint32_t i = 0; i < count; ++i)
+    {
+        if(!found)
+            found = getBusProperties(data, calls[i].busName, calls[i].reply, result);
+        if(calls[i].reply)
+            data->lib->ffdbus_message_unref(calls[i].reply);
+    }
+    return found;
 }
 
 static void getBestBus(FFDBusData* data, FFMediaResult* result)
 {
-    if(
-        getBusProperties(data, FF_DBUS_MPRIS_PREFIX"spotify", result) ||
-        getBusProperties(data, FF_DBUS_MPRIS_PREFIX"vlc", result) ||
-        getBusProperties(data, FF_DBUS_MPRIS_PREFIX"plasma-browser-integration", result)
-    ) return;
-
-    DBusMessage* reply = ffDBusGetMethodReply(data, "org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus", "ListNames");
-    if(reply == NULL)
+    // The preferred players and the list of all names are requested in one batch
+    enum { preferredCount = sizeof(preferredBuses) / sizeof(*preferredBuses) };
+    FFDBusCall calls[preferredCount + 1];
+    for(uint32_t i = 0; i < preferredCount; ++i)
+        calls[i] = getMetadataCall(preferredBuses[i]);
+    calls[preferredCount] = (FFDBusCall) {
+        .busName = "org.freedesktop.DBus",
+        .objectPath = "/org/freedesktop/DBus",
+        .interface = "org.freedesktop.DBus",
+        .method = "ListNames",
+    };
+    ffDBusCallAll(data, calls, preferredCount + 1);
+
+    DBusMessage* reply = calls[preferredCount].reply;
+    if(takeFirstBus(data, calls, preferredCount, result) || reply == NULL)
+    {
+        if(reply)
+            data->lib->ffdbus_message_unref(reply);
         return;
+    }
 
     DBusMessageIter rootIterator;
     if(!data->lib->ffdbus_message_iter_init(reply, &rootIterator) || data->lib->ffdbus_message_iter_get_arg_type(&rootIterator) != DBUS_TYPE_ARRAY)
+    {
+        data->lib->ffdbus_message_unref(reply);
         return;
+    }
 
     DBusMessageIter arrayIterator;
     data->lib->ffdbus_message_iter_recurse(&rootIterator, &arrayIterator);
 
+    // Then all other players, again in one batch. The names point into `reply`
+    FF_LIST_AUTO_DESTROY players = ffListCreate(sizeof(FFDBusCall));
     while(true)
     {
         if(data->lib->ffdbus_message_iter_get_arg_type(&arrayIterator) != DBUS_TYPE_STRING)
@@ -138,15 +203,20 @@ static void getBestBus(FFDBusData* data, FFMediaResult* result)
         const char* busName;
         data->lib->ffdbus_message_iter_get_basic(&arrayIterator, &busName);
 
-        if(!ffStrStartsWith(busName, FF_DBUS_MPRIS_PREFIX))
+        if(!ffStrStartsWith(busName, FF_DBUS_MPRIS_PREFIX) || isPreferredBus(busName))
             FF_DBUS_ITER_CONTINUE(data, &arrayIterator)
 
-        if(getBusProperties(data, busName, result))
-            break;
+        *(FFDBusCall*) ffListAdd(&players) = getMetadataCall(busName);
 
         FF_DBUS_ITER_CONTINUE(data, &arrayIterator)
     }
 
+    if(players.length > 0)
+    {
+        ffDBusCallAll(data, (FFDBusCall*) players.data, players.length);
+        takeFirstBus(data, (FFDBusCall*) players.data, players.length, result);
+    }
+
     data->lib->ffdbus_message_unref(reply);
 }
 
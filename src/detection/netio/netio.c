@@ -1,19 +1,97 @@
 #include "netio.h"
 
-#include "common/time.h"
+#include "common/sampler.h"
+
+#include <math.h>
 
 const char* ffNetIOGetIoCounters(FFlist* result, FFNetIOOptions* options);
 
-static FFlist ioCounters1;
-static uint64_t time1;
+static const char* snapshot(FFlist* result, void* options)
+{
+    return ffNetIOGetIoCounters(result, (FFNetIOOptions*) options);
+}
+
+static void destroyResult(void* item)
+{
+    ffStrbufDestroy(&((FFNetIOResult*) item)->name);
+}
+
+#define FF_NETIO_RATES_COUNT (sizeof(FFNetIORates) / sizeof(double))
+static_assert(sizeof(FFNetIORates) == sizeof(double) * 8, "Unexpected struct FFNetIORates layout");
+static_assert(offsetof(FFNetIOResult, txDrops) - offsetof(FFNetIOResult, txBytes) == sizeof(uint64_t) * 7, "Unexpected struct FFNetIOResult layout");
+
+static void computeRates(const FFNetIOResult* icPrev, const FFNetIOResult* icCurr, double elapsed /* seconds */, FFNetIORates* rates)
+{
+    const uint64_t* prevValues = &icPrev->txBytes;
+    const uint64_t* currValues = &icCurr->txBytes;
+    double* rateValues = &rates->txBytes;
+    for (uint32_t i = 0; i < FF_NETIO_RATES_COUNT; ++i)
+        rateValues[i] = currValues[i] >= prevValues[i] ? (double) (currValues[i] - prevValues[i]) / elapsed : 0;
+}
+
+// EWMA and peak rates of the sub intervals, index aligned with the snapshots
+static FFlist smoothedRates; // FFNetIORates[2]: average, peak
+
+static void onInterval(FFSamplerSource* source, const FFlist* previous, const FFlist* current, uint64_t elapsedNs)
+{
+    FFNetIOOptions* options = (FFNetIOOptions*) source->options;
+
+    if (previous == &source->snapshots[0])
+        ffListClear(&smoothedRates);
+    bool first = smoothedRates.length == 0;
+
+    if (previous->length != current->length || (!first && smoothedRates.length != current->length) || elapsedNs == 0)
+        return;
+
+    // Span based smoothing factor, as in the EWMA of `samples` periods
+    double alpha = 2.0 / (options->samples + 1);
+
+    for (uint32_t i = 0; i < current->length; ++i)
+    {
+        FFNetIORates rates;
+        computeRates(ffListGet(previous, i), ffListGet(current, i), (double) elapsedNs / 1e9, &rates);
+
+        FFNetIORates* smoothed = first ? ffListAdd(&smoothedRates) : ffListGet(&smoothedRates, i);
+        if (first)
+        {
+            smoothed[0] = smoothed[1] = rates;
+            continue;
+        }
+
+        const double* rateValues = &rates.txBytes;
+        double* averageValues = &smoothed[0].txBytes;
+        double* peakValues = &smoothed[1].txBytes;
+        for (uint32_t j = 0; j < FF_NETIO_RATES_COUNT; ++j)
+        {
+            averageValues[j] = alpha * rateValues[j] + (1 - alpha) * averageValues[j];
+            if (rateValues[j] > peakValues[j]) peakValues[j] = rateValues[j];
+        }
+    }
+}
+
+static FFSamplerSource source = {
+    .snapshot = snapshot,
+    .destroy = destroyResult,
+    .interval = onInterval,
+    .elementSize = sizeof(FFNetIOResult),
+};
+
+static void setupSource(FFNetIOOptions* options)
+{
+    if (smoothedRates.elementSize == 0)
+        ffListInit(&smoothedRates, sizeof(FFNetIORates) * 2);
+
+    source.options = options;
+    source.window = instance.config.general.samplingWindow;
+    source.intervals = options->samples;
+}
 
 void ffPrepareNetIO(FFNetIOOptions* options)
 {
     if (options->detectTotal) return;
 
-    ffListInit(&ioCounters1, sizeof(FFNetIOResult));
-    ffNetIOGetIoCounters(&ioCounters1, options);
-    time1 = ffTimeGetNow();
+    setupSource(options);
+    ffSamplerStart(&source);
 }
 
 const char* ffDetectNetIO(FFlist* result, FFNetIOOptions* options)
@@ -28,51 +106,54 @@ const char* ffDetectNetIO(FFlist* result, FFNetIOOptions* options)
         return NULL;
     }
 
-    if (time1 == 0)
-    {
-        ffListInit(&ioCounters1, sizeof(FFNetIOResult));
-        error = ffNetIOGetIoCounters(&ioCounters1, options);
-        if (error)
-            return error;
-        time1 = ffTimeGetNow();
-    }
+    setupSource(options);
+    error = ffSamplerSample(&source);
+    if (error)
+        return error;
+
+    const FFlist* ioCounters1 = &source.snapshots[0];
+    const FFlist* ioCounters2 = &source.snapshots[1];
 
-    if (ioCounters1.length == 0)
+    if (ioCounters1->length == 0)
         return "No network interfaces found";
 
-    uint64_t time2 = ffTimeGetNow();
-    while (time2 - time1 < 1000)
-    {
-        ffTimeSleep((uint32_t) (1000 - (time2 - time1)));
-        time2 = ffTimeGetNow();
-    }
+    if (ioCounters2->length != ioCounters1->length)
+        return "Different number of network interfaces. Network change?";
 
-    error = ffNetIOGetIoCounters(result, options);
-    if (error)
-        return error;
+    double elapsed = (double) (source.times[1] - source.times[0]) / 1e9; // seconds
+    if (elapsed <= 0) elapsed = 1e-9;
 
-    if (result->length != ioCounters1.length)
-        return "Different number of network interfaces. Network change?";
+    bool smoothed = source.intervals > 1 && smoothedRates.length == ioCounters2->length;
 
-    for (uint32_t i = 0; i < result->length; ++i)
+    for (uint32_t i = 0; i < ioCounters2->length; ++i)
     {
-        FFNetIOResult* icPrev = (FFNetIOResult*)ffListGet(&ioCounters1, i);
-        FFNetIOResult* icCurr = (FFNetIOResult*)ffListGet(result, i);
+        const FFNetIOResult* icPrev = (const FFNetIOResult*)ffListGet(ioCounters1, i);
+        const FFNetIOResult* icCurr = (const FFNetIOResult*)ffListGet(ioCounters2, i);
         if (!ffStrbufEqual(&icPrev->name, &icCurr->name))
             return "Network interface name changed";
 
-        static_assert(sizeof(FFNetIOResult) - offsetof(FFNetIOResult, txBytes) == sizeof(uint64_t) * 8, "Unexpected struct FFNetIOResult layout");
-        for (size_t off = offsetof(FFNetIOResult, txBytes); off < sizeof(FFNetIOResult); off += sizeof(uint64_t))
+        FFNetIOResult* icResult = (FFNetIOResult*)ffListAdd(result);
+        *icResult = *icCurr;
+        ffStrbufInitCopy(&icResult->name, &icCurr->name);
+
+        if (smoothed)
         {
-            uint64_t* prevValue = (uint64_t*) ((uint8_t*) icPrev + off);
-            uint64_t* currValue = (uint64_t*) ((uint8_t*) icCurr + off);
-            uint64_t temp = *currValue;
-            *currValue -= *prevValue;
-            *currValue /= (time2 - time1) / 1000 /* seconds */;
-            *prevValue = temp;
+            const FFNetIORates* rates = ffListGet(&smoothedRates, i);
+            icResult->average = rates[0];
+            icResult->peak = rates[1];
         }
+        else
+        {
+            computeRates(icPrev, icCurr, elapsed, &icResult->average);
+            icResult->peak = icResult->average;
+        }
+
+        // Integer fields keep holding the rates, rounded
+        const double* averageValues = &icResult->average.txBytes;
+        uint64_t* counterValues = &icResult->txBytes;
+        for (uint32_t j = 0; j < FF_NETIO_RATES_COUNT; ++j)
+            counterValues[j] = (uint64_t) llround(averageValues[j]);
     }
-    time1 = time2;
 
     return NULL;
 }
@@ -2,6 +2,18 @@
 
 #include "fastfetch.h"
 
+typedef struct FFNetIORates
+{
+    double txBytes;
+    double rxBytes;
+    double txPackets;
+    double rxPackets;
+    double rxErrors;
+    double txErrors;
+    double rxDrops;
+    double txDrops;
+} FFNetIORates;
+
 typedef struct FFNetIOResult
 {
     FFstrbuf name;
@@ -14,6 +26,10 @@ typedef struct FFNetIOResult
     uint64_t txErrors;
     uint64_t rxDrops;
     uint64_t txDrops;
+
+    // Per second, unused if `detectTotal` is set
+    FFNetIORates average; // Over the sampling window, EWMA smoothed if `samples > 1`
+    FFNetIORates peak; // Highest rate of all sub intervals
 } FFNetIOResult;
 
 const char* ffDetectNetIO(FFlist* result, FFNetIOOptions* options);
@@ -5,93 +5,155 @@
 #include "util/stringUtils.h"
 
 #include <net/if.h>
-
-static void getData(FFstrbuf* buffer, const char* ifName, bool isDefaultRoute, FFstrbuf* path, FFlist* result)
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
+// From <linux/if.h>, which conflicts with <net/if.h>
+#ifndef IF_OPER_UP
+    #define IF_OPER_UNKNOWN 0
+    #define IF_OPER_UP 6
+#endif
+
+// RTA_NEXT mixes signed and unsigned arithmetic
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+
+static bool acceptInterface(const char* ifName, FFNetIOOptions* options, const char* defaultRouteIfName)
 {
-    ffStrbufSetF(path, "/sys/class/net/%s/operstate", ifName);
-    if(!ffReadFileBuffer(path->chars, buffer) || !ffStrbufEqualS(buffer, "up\n"))
-        return;
+    if (options->defaultRouteOnly && !ffStrEquals(ifName, defaultRouteIfName))
+        return false;
 
-    FFNetIOResult* counters = (FFNetIOResult*) ffListAdd(result);
-    ffStrbufInitS(&counters->name, ifName);
-    counters->defaultRoute = isDefaultRoute;
-
-    ffStrbufSetF(path, "/sys/class/net/%s/statistics/", ifName);
-    uint32_t statLen = path->length;
-
-    ffStrbufAppendS(path, "rx_bytes");
-    if (ffReadFileBuffer(path->chars, buffer))
-        counters->rxBytes = ffStrbufToUInt(buffer, 0);
-    ffStrbufSubstrBefore(path, statLen);
-
-    ffStrbufAppendS(path, "tx_bytes");
-    if (ffReadFileBuffer(path->chars, buffer))
-        counters->txBytes = ffStrbufToUInt(buffer, 0);
-    ffStrbufSubstrBefore(path, statLen);
-
-    ffStrbufAppendS(path, "rx_packets");
-    if (ffReadFileBuffer(path->chars, buffer))
-        counters->rxPackets = ffStrbufToUInt(buffer, 0);
-    ffStrbufSubstrBefore(path, statLen);
-
-    ffStrbufAppendS(path, "tx_packets");
-    if (ffReadFileBuffer(path->chars, buffer))
-        counters->txPackets = ffStrbufToUInt(buffer, 0);
-    ffStrbufSubstrBefore(path, statLen);
-
-    ffStrbufAppendS(path, "rx_errors");
-    if (ffReadFileBuffer(path->chars, buffer))
-        counters->rxErrors = ffStrbufToUInt(buffer, 0);
-    ffStrbufSubstrBefore(path, statLen);
-
-    ffStrbufAppendS(path, "tx_errors");
-    if (ffReadFileBuffer(path->chars, buffer))
-        counters->txErrors = ffStrbufToUInt(buffer, 0);
-    ffStrbufSubstrBefore(path, statLen);
-
-    ffStrbufAppendS(path, "rx_dropped");
-    if (ffReadFileBuffer(path->chars, buffer))
-        counters->rxDrops = ffStrbufToUInt(buffer, 0);
-    ffStrbufSubstrBefore(path, statLen);
-
-    ffStrbufAppendS(path, "tx_dropped");
-    if (ffReadFileBuffer(path->chars, buffer))
-        counters->txDrops = ffStrbufToUInt(buffer, 0);
-    ffStrbufSubstrBefore(path, statLen);
+    if (options->namePrefix.length && strncmp(ifName, options->namePrefix.chars, options->namePrefix.length) != 0)
+        return false;
+
+    return true;
 }
 
-const char* ffNetIOGetIoCounters(FFlist* result, FFNetIOOptions* options)
+typedef struct FFNetIOLinkContext
 {
-    FF_AUTO_CLOSE_DIR DIR* dirp = opendir("/sys/class/net");
-    if (!dirp) return "opendir(\"/sys/class/net\") == NULL";
+    FFlist* result;
+    FFNetIOOptions* options;
+    const char* defaultRouteIfName;
+} FFNetIOLinkContext;
 
-    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreateA(64);
-    FF_STRBUF_AUTO_DESTROY buffer = ffStrbufCreate();
-
-    const char* defaultRouteIfName = ffNetifGetDefaultRouteIfName();
+static bool parseLink(struct nlmsghdr* nlh, void* data)
+{
+    if (nlh->nlmsg_type != RTM_NEWLINK)
+        return true;
 
-    if (options->defaultRouteOnly)
-    {
-        if (options->namePrefix.length && strncmp(defaultRouteIfName, options->namePrefix.chars, options->namePrefix.length) != 0)
-            return NULL;
+    FFNetIOLinkContext* context = (FFNetIOLinkContext*) data;
+    struct ifinfomsg* ifi = (struct ifinfomsg*) NLMSG_DATA(nlh);
+    const char* ifName = NULL;
+    const struct rtnl_link_stats64* stats = NULL;
+    uint8_t operState = IF_OPER_UNKNOWN;
 
-       getData(&buffer, defaultRouteIfName, true, &path, result);
-    }
-    else
+    int len = (int) IFLA_PAYLOAD(nlh);
+    for (struct rtattr* rta = IFLA_RTA(ifi); RTA_OK(rta, len); rta = RTA_NEXT(rta, len))
     {
-        struct dirent* entry;
-        while((entry = readdir(dirp)) != NULL)
+        switch (rta->rta_type)
         {
-            const char* ifName = entry->d_name;
-            if(ifName[0] == '.')
-                continue;
+            case IFLA_IFNAME:
+                ifName = (const char*) RTA_DATA(rta);
+                break;
+            case IFLA_OPERSTATE:
+                operState = *(const uint8_t*) RTA_DATA(rta);
+                break;
+            case IFLA_STATS64:
+                if (RTA_PAYLOAD(rta) >= sizeof(*stats))
+                    stats = (const struct rtnl_link_stats64*) RTA_DATA(rta);
+                break;
+        }
+    }
 
-            if (options->namePrefix.length && strncmp(ifName, options->namePrefix.chars, options->namePrefix.length) != 0)
-                continue;
+    if (!ifName || !stats || operState != IF_OPER_UP || !acceptInterface(ifName, context->options, context->defaultRouteIfName))
+        return true;
 
-            getData(&buffer, ifName, ffStrEquals(ifName, defaultRouteIfName), &path, result);
-        }
+    FFNetIOResult* counters = (FFNetIOResult*) ffListAdd(context->result);
+    ffStrbufInitS(&counters->name, ifName);
+    counters->defaultRoute = ffStrEquals(ifName, context->defaultRouteIfName);
+    counters->rxBytes = stats->rx_bytes;
+    counters->txBytes = stats->tx_bytes;
+    counters->rxPackets = stats->rx_packets;
+    counters->txPackets = stats->tx_packets;
+    counters->rxErrors = stats->rx_errors;
+    counters->txErrors = stats->tx_errors;
+    counters->rxDrops = stats->rx_dropped;
+    counters->txDrops = stats->tx_dropped;
+    return true;
+}
+
+// Reads the counters of all interfaces at once. Used if netlink is not available.
+// The file is read whole: it has one line per interface, which can be a lot on hosts with many containers
+static const char* getIoCountersProcNetDev(FFlist* result, FFNetIOOptions* options, const char* defaultRouteIfName)
+{
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreateA(PROC_FILE_BUFFSIZ);
+    if (!ffReadFileBuffer("/proc/net/dev", &content))
+        return "ffReadFileBuffer(\"/proc/net/dev\") failed";
+
+    FF_AUTO_CLOSE_FD int sock = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+    // Skip the two header lines
+    char* line = strchr(content.chars, '\n');
+    if (line) line = strchr(line + 1, '\n');
+
+    while (line && *++line)
+    {
+        char* colon = strchr(line, ':');
+        char* eol = strchr(line, '\n');
+        if (!colon || (eol && colon > eol))
+            break;
+
+        *colon = '\0';
+        const char* ifName = line;
+        while (*ifName == ' ') ++ifName;
+        line = eol;
+
+        if (!acceptInterface(ifName, options, defaultRouteIfName))
+            continue;
+
+        // The closest thing to operstate == up, without reading sysfs
+        struct ifreq ifr = {};
+        strncpy(ifr.ifr_name, ifName, IFNAMSIZ - 1);
+        if (sock < 0 || ioctl(sock, SIOCGIFFLAGS, &ifr) < 0 ||
+            (ifr.ifr_flags & (IFF_UP | IFF_RUNNING | IFF_LOOPBACK)) != (IFF_UP | IFF_RUNNING))
+            continue;
+
+        // rx: bytes packets errs drop fifo frame compressed multicast; tx: bytes packets errs drop fifo colls carrier compressed
+        uint64_t values[16] = {};
+        char* p = colon + 1;
+        for (uint32_t i = 0; i < 16; ++i)
+            values[i] = strtoull(p, &p, 10);
+
+        FFNetIOResult* counters = (FFNetIOResult*) ffListAdd(result);
+        ffStrbufInitS(&counters->name, ifName);
+        counters->defaultRoute = ffStrEquals(ifName, defaultRouteIfName);
+        counters->rxBytes = values[0];
+        counters->rxPackets = values[1];
+        counters->rxErrors = values[2];
+        counters->rxDrops = values[3];
+        counters->txBytes = values[8];
+        counters->txPackets = values[9];
+        counters->txErrors = values[10];
+        counters->txDrops = values[11];
     }
 
     return NULL;
 }
+
+const char* ffNetIOGetIoCounters(FFlist* result, FFNetIOOptions* options)
+{
+    const char* defaultRouteIfName = ffNetifGetDefaultRouteIfName();
+
+    // Dumps all links with their statistics in a single RTM_GETLINK request
+    FFNetIOLinkContext context = { result, options, defaultRouteIfName };
+    if (ffNetifNetlinkDump(RTM_GETLINK, AF_UNSPEC, parseLink, &context) == NULL)
+        return NULL;
+
+    FF_LIST_FOR_EACH(FFNetIOResult, counters, *result)
+        ffStrbufDestroy(&counters->name);
+    ffListClear(result);
+
+    return getIoCountersProcNetDev(result, options, defaultRouteIfName);
+}
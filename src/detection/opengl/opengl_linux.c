@@ -7,6 +7,7 @@
 #define FF_HAVE_GL 1
 
 #include "common/library.h"
+#include "detection/gpu/gpu_driver_cache.h"
 
 #include <GL/gl.h>
 
@@ -314,10 +315,10 @@ static const char* osMesaPrint(FFOpenGLResult* result)
 
 #endif //FF_HAVE_OSMESA
 
-const char* ffDetectOpenGL(FFOpenGLOptions* options, FFOpenGLResult* result)
-{
-    #if FF_HAVE_GL
+#if FF_HAVE_GL
 
+static const char* detectOpenGL(FFOpenGLOptions* options, FFOpenGLResult* result)
+{
     if(options->library == FF_OPENGL_LIBRARY_GLX)
     {
         #ifdef FF_HAVE_GLX
@@ -360,6 +361,60 @@ const char* ffDetectOpenGL(FFOpenGLOptions* options, FFOpenGLResult* result)
     //that doesn't reflect the opengl supported by the hardware
 
     return error;
+}
+
+static void buildCacheParams(FFOpenGLOptions* options, FFstrbuf* params)
+{
+    ffStrbufSetF(params, "%d\n%s\n%s\n%s", (int) options->library,
+        instance.config.library.libEGL.chars,
+        instance.config.library.libGLX.chars,
+        instance.config.library.libOSMesa.chars);
+}
+
+static bool readCache(const FFstrbuf* params, FFOpenGLResult* result)
+{
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+    if(!ffGPUDriverCacheRead("opengl", params, &content))
+        return false;
+
+    uint32_t index = 0;
+    return
+        ffGPUDriverCacheReadLine(&content, &index, &result->version) &&
+        ffGPUDriverCacheReadLine(&content, &index, &result->renderer) &&
+        ffGPUDriverCacheReadLine(&content, &index, &result->vendor) &&
+        ffGPUDriverCacheReadLine(&content, &index, &result->slv);
+}
+
+static void writeCache(const FFstrbuf* params, const FFOpenGLResult* result)
+{
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreateF("%s\n%s\n%s\n%s\n",
+        result->version.chars, result->renderer.chars, result->vendor.chars, result->slv.chars);
+
+    // Every value must fit into a single line
+    if(ffStrbufCountC(&content, '\n') == 4)
+        ffGPUDriverCacheWrite("opengl", params, &content);
+}
+
+#endif //FF_HAVE_GL
+
+const char* ffDetectOpenGL(FFOpenGLOptions* options, FFOpenGLResult* result)
+{
+    #if FF_HAVE_GL
+
+    FF_STRBUF_AUTO_DESTROY params = ffStrbufCreate();
+    buildCacheParams(options, &params);
+    if(readCache(&params, result))
+        return NULL;
+
+    ffStrbufClear(&result->version);
+    ffStrbufClear(&result->renderer);
+    ffStrbufClear(&result->vendor);
+    ffStrbufClear(&result->slv);
+
+    const char* error = detectOpenGL(options, result);
+    if(error == NULL)
+        writeCache(&params, result);
+    return error;
 
     #else
 
@@ -1,170 +1,86 @@
 #include "physicaldisk.h"
 #include "common/io/io.h"
-#include "common/properties.h"
+#include "detection/blockdev/blockdev_linux.h"
 #include "detection/temps/temps_linux.h"
 #include "util/stringUtils.h"
 
-#include <ctype.h>
-#include <limits.h>
-
-const char* ffDetectPhysicalDisk(FFlist* result, FFPhysicalDiskOptions* options)
+static double detectTemperature(const FFBlockDevice* device)
 {
-    FF_AUTO_CLOSE_DIR DIR* sysBlockDirp = opendir("/sys/block/");
-    if(sysBlockDirp == NULL)
-        return "opendir(\"/sys/block/\") == NULL";
-
-    struct dirent* sysBlockEntry;
-    while ((sysBlockEntry = readdir(sysBlockDirp)) != NULL)
+    if (device->hwmonPath.length)
     {
-        const char* const devName = sysBlockEntry->d_name;
+        char buffer[32];
+        ssize_t length = ffReadFileData(device->hwmonPath.chars, sizeof(buffer) - 1, buffer);
+        if (length > 0)
+        {
+            buffer[length] = '\0';
+            return strtod(buffer, NULL) / 1000; // millidegree Celsius
+        }
+    }
 
-        if (devName[0] == '.')
-            continue;
+    const FFlist* tempsResult = ffDetectTemps();
 
-        char pathSysBlock[PATH_MAX];
-        snprintf(pathSysBlock, PATH_MAX, "/sys/block/%s", devName);
+    FF_LIST_FOR_EACH(FFTempValue, value, *tempsResult)
+    {
+        if (ffStrStartsWith(device->devName, value->deviceName.chars)) // nvme0 - nvme0n1
+            return value->value;
+    }
 
-        char pathSysDeviceReal[PATH_MAX];
-        ssize_t pathLength = readlink(pathSysBlock, pathSysDeviceReal, sizeof(pathSysDeviceReal) - 1);
-        if (pathLength < 0)
-            continue;
-        pathSysDeviceReal[pathLength] = '\0';
+    return FF_PHYSICALDISK_TEMP_UNSET;
+}
 
-        if (strstr(pathSysDeviceReal, "/virtual/")) // virtual device
-            continue;
+const char* ffDetectPhysicalDisk(FFlist* result, FFPhysicalDiskOptions* options)
+{
+    // Shared with the other disk modules
+    const FFlist* devices = ffBlockDevGetDevices();
 
-        snprintf(pathSysBlock, PATH_MAX, "/sys/block/%s/device", devName);
-        if (!ffPathExists(pathSysBlock, FF_PATHTYPE_DIRECTORY))
+    FF_LIST_FOR_EACH(FFBlockDevice, blockDevice, *devices)
+    {
+        if (options->namePrefix.length && !ffStrbufStartsWith(&blockDevice->name, &options->namePrefix))
             continue;
 
         FFPhysicalDiskResult* device = (FFPhysicalDiskResult*) ffListAdd(result);
         device->type = FF_PHYSICALDISK_TYPE_NONE;
-        ffStrbufInit(&device->name);
-
-        {
-            snprintf(pathSysBlock, PATH_MAX, "/sys/block/%s/device/vendor", devName);
-            if (ffAppendFileBuffer(pathSysBlock, &device->name))
-            {
-                ffStrbufTrimRightSpace(&device->name);
-                if (device->name.length > 0)
-                    ffStrbufAppendC(&device->name, ' ');
-            }
-
-            snprintf(pathSysBlock, PATH_MAX, "/sys/block/%s/device/model", devName);
-            ffAppendFileBuffer(pathSysBlock, &device->name);
-            ffStrbufTrimRightSpace(&device->name);
-
-            if (device->name.length == 0)
-                ffStrbufSetS(&device->name, devName);
-            else if (ffStrStartsWith(devName, "nvme"))
-            {
-                int devid, nsid;
-                if (sscanf(devName, "nvme%dn%d", &devid, &nsid) == 2)
-                {
-                    bool multiNs = nsid > 1;
-                    if (!multiNs)
-                    {
-                        snprintf(pathSysBlock, PATH_MAX, "/sys/block/%s/device/nvme%dn2", devName, devid);
-                        multiNs = ffPathExists(pathSysBlock, FF_PATHTYPE_DIRECTORY);
-                    }
-                    if (multiNs)
-                    {
-                        // In Asahi Linux, there are multiple namespaces for the same NVMe drive.
-                        ffStrbufAppendF(&device->name, " - %d", nsid);
-                    }
-                }
-            }
-
-            if (options->namePrefix.length && !ffStrbufStartsWith(&device->name, &options->namePrefix))
-            {
-                ffStrbufDestroy(&device->name);
-                result->length--;
-                continue;
-            }
-        }
-
-        ffStrbufInitF(&device->devPath, "/dev/%s", devName);
+        ffStrbufInitCopy(&device->name, &blockDevice->name);
+        ffStrbufInitF(&device->devPath, "/dev/%s", blockDevice->devName);
 
         {
+            const char* sysPath = blockDevice->sysPath.chars;
             ffStrbufInit(&device->interconnect);
-            if (strstr(pathSysDeviceReal, "/usb") != NULL)
+            if (strstr(sysPath, "/usb") != NULL)
                 ffStrbufSetS(&device->interconnect, "USB");
-            else if (strstr(pathSysDeviceReal, "/nvme") != NULL)
+            else if (strstr(sysPath, "/nvme") != NULL)
                 ffStrbufSetS(&device->interconnect, "NVMe");
-            else if (strstr(pathSysDeviceReal, "/ata") != NULL)
+            else if (strstr(sysPath, "/ata") != NULL)
                 ffStrbufSetS(&device->interconnect, "ATA");
-            else if (strstr(pathSysDeviceReal, "/scsi") != NULL)
+            else if (strstr(sysPath, "/scsi") != NULL)
                 ffStrbufSetS(&device->interconnect, "SCSI");
             else
             {
-                snprintf(pathSysBlock, PATH_MAX, "/sys/block/%s/device/transport", devName);
-                if (ffAppendFileBuffer(pathSysBlock, &device->interconnect))
+                if (ffAppendFileBufferRelative(blockDevice->sysfd, "device/transport", &device->interconnect))
                     ffStrbufTrimRightSpace(&device->interconnect);
             }
         }
 
-        {
-            snprintf(pathSysBlock, PATH_MAX, "/sys/block/%s/queue/rotational", devName);
-            char isRotationalChar = '1';
-            if (ffReadFileData(pathSysBlock, 1, &isRotationalChar) > 0)
-                device->type |= isRotationalChar == '1' ? FF_PHYSICALDISK_TYPE_HDD : FF_PHYSICALDISK_TYPE_SSD;
-        }
-
-        {
-            snprintf(pathSysBlock, PATH_MAX, "/sys/block/%s/size", devName);
-            char blkSize[32];
-            ssize_t fileSize = ffReadFileData(pathSysBlock, sizeof(blkSize) - 1, blkSize);
-            if (fileSize > 0)
-            {
-                blkSize[fileSize] = 0;
-                device->size = (uint64_t) strtoul(blkSize, NULL, 10) * 512;
-            }
-            else
-                device->size = 0;
-        }
+        if (blockDevice->rotational >= 0)
+            device->type |= blockDevice->rotational ? FF_PHYSICALDISK_TYPE_HDD : FF_PHYSICALDISK_TYPE_SSD;
 
-        {
-            char removableChar = '0';
-            snprintf(pathSysBlock, PATH_MAX, "/sys/block/%s/removable", devName);
-            if (ffReadFileData(pathSysBlock, 1, &removableChar) > 0)
-                device->type |= removableChar == '1' ? FF_PHYSICALDISK_TYPE_REMOVABLE : FF_PHYSICALDISK_TYPE_FIXED;
-        }
+        device->size = blockDevice->size;
 
-        {
-            char roChar = '0';
-            snprintf(pathSysBlock, PATH_MAX, "/sys/block/%s/ro", devName);
-            if (ffReadFileData(pathSysBlock, 1, &roChar) > 0)
-                device->type |= roChar == '1' ? FF_PHYSICALDISK_TYPE_READONLY : FF_PHYSICALDISK_TYPE_READWRITE;
-        }
+        if (blockDevice->removable >= 0)
+            device->type |= blockDevice->removable ? FF_PHYSICALDISK_TYPE_REMOVABLE : FF_PHYSICALDISK_TYPE_FIXED;
 
-        {
-            ffStrbufInit(&device->serial);
-            snprintf(pathSysBlock, PATH_MAX, "/sys/block/%s/device/serial", devName);
-            if (ffReadFileBuffer(pathSysBlock, &device->serial))
-                ffStrbufTrimRightSpace(&device->serial);
-        }
+        if (blockDevice->readOnly >= 0)
+            device->type |= blockDevice->readOnly ? FF_PHYSICALDISK_TYPE_READONLY : FF_PHYSICALDISK_TYPE_READWRITE;
 
-        {
-            ffStrbufInit(&device->revision);
-            snprintf(pathSysBlock, PATH_MAX, "/sys/block/%s/device/firmware_rev", devName);
-            if (ffReadFileBuffer(pathSysBlock, &device->revision))
-                ffStrbufTrimRightSpace(&device->revision);
-        }
+        ffStrbufInit(&device->serial);
+        if (ffReadFileBufferRelative(blockDevice->sysfd, "device/serial", &device->serial))
+            ffStrbufTrimRightSpace(&device->serial);
 
-        device->temperature = FF_PHYSICALDISK_TEMP_UNSET;
-        if (options->temp)
-        {
-            const FFlist* tempsResult = ffDetectTemps();
+        ffStrbufInit(&device->revision);
+        if (ffReadFileBufferRelative(blockDevice->sysfd, "device/firmware_rev", &device->revision))
+            ffStrbufTrimRightSpace(&device->revision);
 
-            FF_LIST_FOR_EACH(FFTempValue, value, *tempsResult)
-            {
-                if (ffStrStartsWith(devName, value->deviceName.chars)) // nvme0 - nvme0n1
-                {
-                    device->temperature = value->value;
-                    break;
-                }
-            }
-        }
+        device->temperature = options->temp ? detectTemperature(blockDevice) : FF_PHYSICALDISK_TEMP_UNSET;
     }
 
     return NULL;
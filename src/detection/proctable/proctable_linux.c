@@ -0,0 +1,253 @@
+#include "proctable_linux.h"
+#include "common/io/io.h"
+#include "common/thread.h"
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+
+static FFlist pids; // List of pid_t, sorted
+static FFlist snapshot; // List of FFProcInfo, sorted by pid
+static FFlist singles; // List of FFProcInfo, read before the snapshot was taken
+
+static int comparePids(const pid_t* a, const pid_t* b)
+{
+    return *a < *b ? -1 : *a > *b;
+}
+
+static const char* readPids(void)
+{
+    if (pids.elementSize > 0)
+        return NULL;
+
+    ffListInitA(&pids, sizeof(pid_t), 512);
+
+    FF_AUTO_CLOSE_DIR DIR* dir = opendir("/proc");
+    if (dir == NULL)
+        return "opendir(\"/proc\") failed";
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        //Match only folders starting with a number (the pid folders)
+        if (entry->d_type == DT_DIR && isdigit(entry->d_name[0]))
+            *(pid_t*) ffListAdd(&pids) = (pid_t) strtol(entry->d_name, NULL, 10);
+    }
+
+    ffListSort(&pids, (const void*) comparePids);
+    return NULL;
+}
+
+static bool readProcess(pid_t pid, FFProcInfo* info)
+{
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%d", (int) pid);
+
+    FF_AUTO_CLOSE_FD int dfd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(dfd, &st) != 0)
+        return false;
+
+    char buf[PROC_FILE_BUFFSIZ];
+    ssize_t nRead = ffReadFileDataRelative(dfd, "stat", sizeof(buf) - 1, buf);
+    if (nRead <= 0)
+        return false;
+    buf[nRead] = '\0';
+
+    // pid (comm) state ppid pgrp session tty_nr ...; comm may contain spaces and parentheses
+    char* commStart = strchr(buf, '(');
+    char* commEnd = strrchr(buf, ')');
+    if (!commStart || !commEnd || commEnd < commStart)
+        return false;
+
+    int ppid, tty;
+    if (sscanf(commEnd + 1, " %c %d %*d %*d %d", &info->state, &ppid, &tty) != 3)
+        return false;
+
+    info->pid = pid;
+    info->ppid = (pid_t) ppid;
+    info->tty = tty;
+    info->uid = (uint32_t) st.st_uid;
+
+    ++commStart;
+    size_t commLength = (size_t) (commEnd - commStart);
+    if (commLength >= sizeof(info->comm))
+        commLength = sizeof(info->comm) - 1;
+    memcpy(info->comm, commStart, commLength);
+    info->comm[commLength] = '\0';
+
+    nRead = ffReadFileDataRelative(dfd, "loginuid", sizeof(buf) - 1, buf);
+    if (nRead > 0)
+    {
+        buf[nRead] = '\0';
+        info->loginuid = (uint32_t) strtoul(buf, NULL, 10);
+    }
+    else
+        info->loginuid = (uint32_t) -1;
+
+    // We check the cmdline for the process name, because it is not trimmed.
+    // argv[0] always comes first, so the rest of long command lines (looking at you chrome) is not needed
+    info->exeName[0] = '\0';
+    nRead = ffReadFileDataRelative(dfd, "cmdline", sizeof(buf) - 1, buf);
+    if (nRead > 0)
+    {
+        buf[nRead] = '\0';
+        size_t length = strlen(buf); //Trim the arguments
+        while (length > 0 && isspace((unsigned char) buf[length - 1]))
+            --length;
+        buf[length] = '\0';
+
+        const char* exeName = memrchr(buf, '/', length);
+        exeName = exeName ? exeName + 1 : buf;
+        size_t exeNameLength = length - (size_t) (exeName - buf);
+        if (exeNameLength >= sizeof(info->exeName))
+            exeNameLength = sizeof(info->exeName) - 1;
+        memcpy(info->exeName, exeName, exeNameLength);
+        info->exeName[exeNameLength] = '\0';
+    }
+
+    return true;
+}
+
+typedef struct FFProcChunk
+{
+    const pid_t* pids;
+    FFProcInfo* infos;
+    uint32_t count;
+} FFProcChunk;
+
+static void readChunk(FFProcChunk* chunk)
+{
+    for (uint32_t i = 0; i < chunk->count; ++i)
+    {
+        if (!readProcess(chunk->pids[i], &chunk->infos[i]))
+            chunk->infos[i].pid = 0; // Exited in the meantime, or not accessible
+    }
+}
+
+#ifdef FF_HAVE_THREADS
+FF_THREAD_ENTRY_DECL_WRAPPER(readChunk, FFProcChunk*)
+#endif
+
+const char* ffProcTableGetCount(uint32_t* count)
+{
+    if (snapshot.elementSize > 0)
+    {
+        *count = snapshot.length;
+        return NULL;
+    }
+
+    const char* error = readPids();
+    if (error) return error;
+
+    *count = pids.length;
+    return NULL;
+}
+
+const FFlist* ffProcTableGetSnapshot(void)
+{
+    if (snapshot.elementSize > 0)
+        return &snapshot;
+
+    readPids();
+
+    ffListInitA(&snapshot, sizeof(FFProcInfo), pids.length);
+    snapshot.length = pids.length;
+
+    // A few hundred processes per thread; most of the time is spent in syscalls
+    enum { FF_PROC_CHUNK_MIN = 256, FF_PROC_CHUNK_MAX_COUNT = 4 };
+    uint32_t chunkCount = pids.length / FF_PROC_CHUNK_MIN + 1;
+    if (chunkCount > FF_PROC_CHUNK_MAX_COUNT)
+        chunkCount = FF_PROC_CHUNK_MAX_COUNT;
+
+    #ifndef FF_HAVE_THREADS
+    chunkCount = 1;
+    #endif
+
+    FFProcChunk chunks[FF_PROC_CHUNK_MAX_COUNT];
+    uint32_t chunkSize = (pids.length + chunkCount - 1) / chunkCount;
+    for (uint32_t i = 0; i < chunkCount; ++i)
+    {
+        uint32_t start = i * chunkSize;
+        uint32_t end = start + chunkSize < pids.length ? start + chunkSize : pids.length;
+        chunks[i] = (FFProcChunk) {
+            .pids = (const pid_t*) pids.data + start,
+            .infos = (FFProcInfo*) snapshot.data + start,
+            .count = end > start ? end - start : 0,
+        };
+    }
+
+    #ifdef FF_HAVE_THREADS
+    FFThreadType threads[FF_PROC_CHUNK_MAX_COUNT] = {};
+    for (uint32_t i = 1; i < chunkCount; ++i)
+    {
+        threads[i] = ffThreadCreate(readChunkThreadMain, &chunks[i]);
+        if (!threads[i])
+            readChunk(&chunks[i]);
+    }
+    #endif
+
+    readChunk(&chunks[0]);
+
+    #ifdef FF_HAVE_THREADS
+    for (uint32_t i = 1; i < chunkCount; ++i)
+    {
+        if (threads[i])
+            ffThreadJoin(threads[i], 0);
+    }
+    #endif
+
+    // Drop processes that couldn't be read
+    uint32_t length = 0;
+    for (uint32_t i = 0; i < snapshot.length; ++i)
+    {
+        FFProcInfo* info = (FFProcInfo*) ffListGet(&snapshot, i);
+        if (info->pid == 0) continue;
+        if (length != i)
+            *(FFProcInfo*) ffListGet(&snapshot, length) = *info;
+        ++length;
+    }
+    snapshot.length = length;
+
+    return &snapshot;
+}
+
+static int compareProcInfo(const FFProcInfo* a, const FFProcInfo* b)
+{
+    return a->pid < b->pid ? -1 : a->pid > b->pid;
+}
+
+bool ffProcTableFind(pid_t pid, FFProcInfo* info)
+{
+    if (pid <= 0)
+        return false;
+
+    if (snapshot.elementSize > 0)
+    {
+        FFProcInfo key = { .pid = pid };
+        const FFProcInfo* found = bsearch(&key, snapshot.data, snapshot.length, snapshot.elementSize, (const void*) compareProcInfo);
+        if (!found) return false;
+        *info = *found;
+        return true;
+    }
+
+    if (singles.elementSize == 0)
+        ffListInit(&singles, sizeof(FFProcInfo));
+
+    FF_LIST_FOR_EACH(FFProcInfo, single, singles)
+    {
+        if (single->pid != pid) continue;
+        *info = *single;
+        return true;
+    }
+
+    if (!readProcess(pid, info))
+        return false;
+
+    *(FFProcInfo*) ffListAdd(&singles) = *info;
+    return true;
+}
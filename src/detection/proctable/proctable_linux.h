@@ -0,0 +1,26 @@
+#pragma once
+
+#include "fastfetch.h"
+
+#include <sys/types.h>
+
+typedef struct FFProcInfo
+{
+    pid_t pid;
+    pid_t ppid;
+    uint32_t uid; // Owner of /proc/<pid>
+    uint32_t loginuid; // (uint32_t) -1 if not set
+    int32_t tty; // tty_nr of /proc/<pid>/stat
+    char state; // R, S, D, Z, ...
+    char comm[16]; // Truncated to 15 chars by the kernel
+    char exeName[64]; // Basename of argv[0], not truncated like comm. Empty for kernel threads
+} FFProcInfo;
+
+// Number of processes, from a single readdir of /proc that is shared with the snapshot below
+const char* ffProcTableGetCount(uint32_t* count);
+
+// All processes, read once (in parallel chunks if there are many), sorted by pid
+const FFlist* /* List of FFProcInfo */ ffProcTableGetSnapshot(void);
+
+// A single process, copied into `info`. Uses the snapshot if it has been taken, otherwise reads and caches the process alone
+bool ffProcTableFind(pid_t pid, FFProcInfo* info);
@@ -1,28 +1,45 @@
 #include "publicip.h"
 #include "common/networking.h"
 
-#define FF_UNITIALIZED ((const char*)(uintptr_t) -1)
-static FFNetworkingState states[2];
-static const char* statuses[2] = { FF_UNITIALIZED, FF_UNITIALIZED };
+// One request per PublicIp module instance, started in the prepare pass and consumed in order when printed
+typedef struct FFPublicIpRequest
+{
+    FFstrbuf url;
+    bool ipv6;
+    bool consumed;
+    bool sent; // False if the response is served from the cache
+    const char* status;
+    FFstrbuf cachePath; // Empty if caching is disabled
+    FFstrbuf cached; // Cached response body; also the fallback if the request fails
+    FFNetworkingState state;
+} FFPublicIpRequest;
 
-void ffPreparePublicIp(FFPublicIpOptions* options)
+static FFlist requests = { .elementSize = sizeof(FFPublicIpRequest*) };
+
+static FFPublicIpRequest* startRequest(FFPublicIpOptions* options)
 {
-    FFNetworkingState* state = &states[options->ipv6];
-    const char** status = &statuses[options->ipv6];
-    if (*status != FF_UNITIALIZED)
-    {
-        fputs("Error: PublicIp module can only be used once due to internal limitations\n", stderr);
-        exit(1);
-    }
+    // Allocated separately; the networking code keeps a pointer to the state while the request is active
+    FFPublicIpRequest* request = calloc(1, sizeof(*request));
+    *(FFPublicIpRequest**) ffListAdd(&requests) = request;
+    ffStrbufInitCopy(&request->url, &options->url);
+    ffStrbufInit(&request->cachePath);
+    ffStrbufInit(&request->cached);
+    request->ipv6 = options->ipv6;
 
+    FFNetworkingState* state = &request->state;
     state->timeout = options->timeout;
     state->ipv6 = options->ipv6;
 
+    FF_STRBUF_AUTO_DESTROY host = ffStrbufCreate();
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
     if (options->url.length == 0)
-        *status = ffNetworkingSendHttpRequest(state, options->ipv6 ? "v6.ipinfo.io" : "ipinfo.io", "/json", NULL);
+    {
+        ffStrbufSetS(&host, options->ipv6 ? "v6.ipinfo.io" : "ipinfo.io");
+        ffStrbufSetS(&path, "/json");
+    }
     else
     {
-        FF_STRBUF_AUTO_DESTROY host = ffStrbufCreateCopy(&options->url);
+        ffStrbufSet(&host, &options->url);
         uint32_t hostStartIndex = ffStrbufFirstIndexS(&host, "://");
         if (hostStartIndex < host.length)
         {
@@ -35,16 +52,49 @@ void ffPreparePublicIp(FFPublicIpOptions* options)
         }
         uint32_t pathStartIndex = ffStrbufFirstIndexC(&host, '/');
 
-        FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
         if(pathStartIndex != host.length)
         {
-            ffStrbufAppendNS(&path, pathStartIndex, host.chars + (host.length - pathStartIndex));
+            ffStrbufAppendNS(&path, host.length - pathStartIndex, host.chars + pathStartIndex);
             host.length = pathStartIndex;
             host.chars[pathStartIndex] = '\0';
         }
+        if (path.length == 0)
+            ffStrbufSetS(&path, "/");
+    }
+
+    if (options->cacheTtl > 0)
+    {
+        ffNetworkingGetCachePath(&request->cachePath, "publicip", &options->url, options->ipv6);
+
+        bool stale;
+        if (ffNetworkingReadCache(&request->cachePath, options->cacheTtl, &request->cached, &stale) &&
+            (!stale || (options->cacheRefresh && ffNetworkingRefreshCache(state, host.chars, path.chars, NULL, &request->cachePath))))
+            return request;
+    }
+
+    request->status = ffNetworkingSendHttpRequest(state, host.chars, path.chars, NULL);
+    request->sent = true;
+    return request;
+}
+
+void ffPreparePublicIp(FFPublicIpOptions* options)
+{
+    startRequest(options);
+}
 
-        *status = ffNetworkingSendHttpRequest(state, host.chars, path.length == 0 ? "/" : path.chars, NULL);
+void ffReleasePublicIpRequests(void)
+{
+    FF_LIST_FOR_EACH(FFPublicIpRequest*, item, requests)
+    {
+        FFPublicIpRequest* request = *item;
+        if (request->sent && !request->consumed)
+            ffNetworkingAbortHttpRequest(&request->state);
+        ffStrbufDestroy(&request->url);
+        ffStrbufDestroy(&request->cachePath);
+        ffStrbufDestroy(&request->cached);
+        free(request);
     }
+    ffListDestroy(&requests);
 }
 
 static inline void wrapYyjsonFree(yyjson_doc** doc)
@@ -56,19 +106,39 @@ static inline void wrapYyjsonFree(yyjson_doc** doc)
 
 const char* ffDetectPublicIp(FFPublicIpOptions* options, FFPublicIpResult* result)
 {
-    FFNetworkingState* state = &states[options->ipv6];
-    const char** status = &statuses[options->ipv6];
-    if (*status == FF_UNITIALIZED)
-        ffPreparePublicIp(options);
-
-    if (*status != NULL)
-        return *status;
+    FFPublicIpRequest* request = NULL;
+    FF_LIST_FOR_EACH(FFPublicIpRequest*, item, requests)
+    {
+        if ((*item)->consumed || (*item)->ipv6 != options->ipv6 || !ffStrbufEqual(&(*item)->url, &options->url))
+            continue;
+        request = *item;
+        break;
+    }
+    if (!request)
+        request = startRequest(options);
+    request->consumed = true;
 
     FF_STRBUF_AUTO_DESTROY response = ffStrbufCreateA(4096);
-    const char* error = ffNetworkingRecvHttpResponse(state, &response);
-    if (error == NULL)
-        ffStrbufSubstrAfterFirstS(&response, "\r\n\r\n");
-    else
+    const char* error = NULL;
+    if (request->sent)
+    {
+        error = request->status ? request->status : ffNetworkingRecvHttpResponse(&request->state, &response);
+        if (error == NULL)
+        {
+            ffStrbufSubstrAfterFirstS(&response, "\r\n\r\n");
+            if (request->cachePath.length > 0)
+                ffNetworkingWriteCache(&request->cachePath, &response);
+        }
+    }
+
+    if (!request->sent || (error != NULL && request->cached.length > 0))
+    {
+        // Fresh enough, being refreshed in the background, or we are offline
+        ffStrbufSet(&response, &request->cached);
+        error = NULL;
+    }
+
+    if (error != NULL)
         return error;
 
     if (response.length == 0)
@@ -9,4 +9,6 @@ typedef struct FFPublicIpResult
 } FFPublicIpResult;
 
 void ffPreparePublicIp(FFPublicIpOptions* options);
+// Closes the requests that were started but never printed, and frees all of them
+void ffReleasePublicIpRequests(void);
 const char* ffDetectPublicIp(FFPublicIpOptions* options, FFPublicIpResult* result);
@@ -1,4 +1,5 @@
 #include "fastfetch.h"
+#include "common/binary.h"
 #include "common/io/io.h"
 #include "common/processing.h"
 #include "common/properties.h"
@@ -63,6 +64,39 @@ static bool getExeVersionGeneral(FFstrbuf* exe, FFstrbuf* version)
     return true;
 }
 
+typedef struct FFExeVersionPattern
+{
+    const char* name;
+    FFBinaryVersionPattern pattern;
+} FFExeVersionPattern;
+
+// Version literals compiled into the executables, read from the file without spawning it
+static const FFExeVersionPattern shellPatterns[] = {
+    { "bash", { "@(#)Bash version ", NULL, "(" } }, // @(#)Bash version 5.2.15(1) release GNU
+    { "ksh", { "@(#)$Id: Version ", " ", "$" } }, // @(#)$Id: Version AJM 93u+ 2012-08-01 $
+    { "ash", { "BusyBox v", NULL, " " } }, // BusyBox v1.36.1 (2023-11-07 18:53:09 UTC)
+    {},
+};
+
+static const FFExeVersionPattern terminalPatterns[] = {
+    // rxvt-unicode (urxvt) v9.31 - released: 2023-01-02
+    { "urxvt", { "rxvt-unicode (urxvt) v", NULL, " " } },
+    { "urxvtd", { "rxvt-unicode (urxvt) v", NULL, " " } },
+    { "rxvt", { "rxvt-unicode (urxvt) v", NULL, " " } },
+    { "rxvt-unicode", { "rxvt-unicode (urxvt) v", NULL, " " } },
+    {},
+};
+
+static bool getExeVersionFromBinary(const FFExeVersionPattern* patterns, const char* name, const char* file, FFstrbuf* version)
+{
+    for (const FFExeVersionPattern* p = patterns; p->name; ++p)
+    {
+        if (strcasecmp(name, p->name) == 0)
+            return ffBinaryFindVersion(file, &p->pattern, version);
+    }
+    return false;
+}
+
 static bool getShellVersionBash(FFstrbuf* exe, FFstrbuf* version)
 {
     if(!getExeVersionRaw(exe, version))
@@ -224,13 +258,8 @@ static bool getShellVersionGeneric(FFstrbuf* exe, const char* exeName, FFstrbuf*
 }
 #endif
 
-bool fftsGetShellVersion(FFstrbuf* exe, const char* exeName, FFstrbuf* version)
+static bool getShellVersion(FFstrbuf* exe, const char* exeName, FFstrbuf* version)
 {
-    if (!instance.config.display.tsVersion) return false;
-
-    if(ffStrEqualsIgnCase(exeName, "sh")) // #849
-        return false;
-
     if(strcasecmp(exeName, "bash") == 0)
         return getShellVersionBash(exe, version);
     if(strcasecmp(exeName, "zsh") == 0)
@@ -266,6 +295,47 @@ bool fftsGetShellVersion(FFstrbuf* exe, const char* exeName, FFstrbuf* version)
     #endif
 }
 
+// `exe` is argv[0], which may be a bare command name. The binary is read from the resolved `exePath` if known
+static inline const char* getExeFile(const FFstrbuf* exe, const FFstrbuf* exePath)
+{
+    return exePath->length > 0 ? exePath->chars : exe->chars;
+}
+
+// The version cache is keyed on `file`. For scripts, `file` is the interpreter, whose key stays the same when the script is upgraded.
+// Only cache programs that run as themselves; `name` may be truncated (TASK_COMM_LEN)
+static bool isVersionCacheable(const char* file, const char* name)
+{
+    const char* base = strrchr(file, '/');
+    #ifdef _WIN32
+    const char* backslash = strrchr(file, '\\');
+    if (backslash && (!base || backslash > base)) base = backslash;
+    #endif
+    base = base ? base + 1 : file;
+    return name[0] != '\0' && ffStrStartsWithIgnCase(base, name);
+}
+
+bool fftsGetShellVersion(FFstrbuf* exe, const char* exeName, const FFstrbuf* exePath, FFstrbuf* version)
+{
+    if (!instance.config.display.tsVersion) return false;
+
+    if(ffStrEqualsIgnCase(exeName, "sh")) // #849
+        return false;
+
+    const char* file = getExeFile(exe, exePath);
+    bool cacheable = isVersionCacheable(file, exeName);
+    FF_STRBUF_AUTO_DESTROY cacheName = ffStrbufCreateF("shell-%s", exeName);
+    if (cacheable && ffBinaryVersionCacheRead(cacheName.chars, file, version))
+        return true;
+
+    // Spawning the shell is the last resort
+    if (!getExeVersionFromBinary(shellPatterns, exeName, file, version) && !getShellVersion(exe, exeName, version))
+        return false;
+
+    if (cacheable)
+        ffBinaryVersionCacheWrite(cacheName.chars, file, version);
+    return true;
+}
+
 FF_MAYBE_UNUSED static bool getTerminalVersionTermux(FFstrbuf* version)
 {
     ffStrbufSetS(version, getenv("TERMUX_VERSION"));
@@ -542,10 +612,8 @@ static bool getTerminalVersionConEmu(FFstrbuf* exe, FFstrbuf* version)
 
 #endif
 
-bool fftsGetTerminalVersion(FFstrbuf* processName, FF_MAYBE_UNUSED FFstrbuf* exe, FFstrbuf* version)
+static bool getTerminalVersion(FFstrbuf* processName, FF_MAYBE_UNUSED FFstrbuf* exe, FFstrbuf* version)
 {
-    if (!instance.config.display.tsVersion) return false;
-
     #ifdef __ANDROID__
 
     if(ffStrbufEqualS(processName, "com.termux"))
@@ -692,3 +760,21 @@ bool fftsGetTerminalVersion(FFstrbuf* processName, FF_MAYBE_UNUSED FFstrbuf* exe
 
     #endif
 }
+
+bool fftsGetTerminalVersion(FFstrbuf* processName, FFstrbuf* exe, const FFstrbuf* exePath, FFstrbuf* version)
+{
+    if (!instance.config.display.tsVersion) return false;
+
+    const char* file = getExeFile(exe, exePath);
+    bool cacheable = isVersionCacheable(file, processName->chars);
+    FF_STRBUF_AUTO_DESTROY cacheName = ffStrbufCreateF("terminal-%s", processName->chars);
+    if (cacheable && ffBinaryVersionCacheRead(cacheName.chars, file, version))
+        return true;
+
+    if (!getExeVersionFromBinary(terminalPatterns, processName->chars, file, version) && !getTerminalVersion(processName, exe, version))
+        return false;
+
+    if (cacheable)
+        ffBinaryVersionCacheWrite(cacheName.chars, file, version);
+    return true;
+}
@@ -10,6 +10,10 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#ifdef __linux__
+    #include "detection/proctable/proctable_linux.h"
+#endif
+
 #if defined(__FreeBSD__) || defined(__APPLE__)
     #include <sys/types.h>
     #include <sys/user.h>
@@ -132,27 +136,20 @@ static const char* getProcessNameAndPpid(pid_t pid, char* name, pid_t* ppid, int
 
     #ifdef __linux__
 
-    char statFilePath[64];
-    snprintf(statFilePath, sizeof(statFilePath), "/proc/%d/stat", (int)pid);
-    char buf[PROC_FILE_BUFFSIZ];
-    ssize_t nRead = ffReadFileData(statFilePath, sizeof(buf) - 1, buf);
-    if(nRead < 0)
-        return "ffReadFileData(statFilePath, sizeof(buf)-1, buf) failed";
-    buf[nRead] = '\0';
-
     *ppid = 0;
-    static_assert(sizeof(*ppid) == sizeof(int), "");
 
-    int tty_;
-    if(
-        sscanf(buf, "%*s (%255[^)]) %*c %d %*d %*d %d", name, ppid, &tty_) < 2 || //stat (comm) state ppid pgrp session tty
-        !ffStrSet(name) ||
-        *ppid == 0
-    )
-        return "sscanf(stat) failed";
+    // Shared with WM / DE and Processes detection
+    FFProcInfo info;
+    if (!ffProcTableFind(pid, &info))
+        return "ffProcTableFind(pid) failed";
+
+    *ppid = info.ppid;
+    if (!ffStrSet(info.comm) || info.ppid == 0)
+        return "Invalid /proc/<pid>/stat";
 
+    strcpy(name, info.comm);
     if (tty)
-        *tty = tty_ & 0xFF;
+        *tty = info.tty & 0xFF;
 
     #elif defined(__APPLE__)
 
@@ -475,14 +472,14 @@ static void getUserShellFromEnv(FFShellResult* result)
     }
 }
 
-bool fftsGetShellVersion(FFstrbuf* exe, const char* exeName, FFstrbuf* version);
+bool fftsGetShellVersion(FFstrbuf* exe, const char* exeName, const FFstrbuf* exePath, FFstrbuf* version);
 
-bool fftsGetTerminalVersion(FFstrbuf* processName, FFstrbuf* exe, FFstrbuf* version);
+bool fftsGetTerminalVersion(FFstrbuf* processName, FFstrbuf* exe, const FFstrbuf* exePath, FFstrbuf* version);
 
 static void setShellInfoDetails(FFShellResult* result)
 {
     ffStrbufClear(&result->version);
-    fftsGetShellVersion(&result->exe, result->exeName, &result->version);
+    fftsGetShellVersion(&result->exe, result->exeName, &result->exePath, &result->version);
 
     if(ffStrbufEqualS(&result->processName, "pwsh"))
         ffStrbufInitStatic(&result->prettyName, "PowerShell");
@@ -552,7 +549,7 @@ static void setTerminalInfoDetails(FFTerminalResult* result)
     else
         ffStrbufInitCopy(&result->prettyName, &result->processName);
 
-    fftsGetTerminalVersion(&result->processName, &result->exe, &result->version);
+    fftsGetTerminalVersion(&result->processName, &result->exe, &result->exePath, &result->version);
 }
 
 #if defined(MAXPATH)
@@ -4,31 +4,28 @@
 
 #include <inttypes.h>
 
-static bool detectByEscapeCode(FFTerminalThemeResult* result)
+static bool parseOscColor(const FFTerminalQuery* query, int command, int expected, FFTerminalThemeColor* color)
 {
-    int command = 0;
-
-    if (ffGetTerminalResponse("\e]10;?\e\\", "\e]%d;rgb:%" SCNx16 "/%" SCNx16 "/%" SCNx16 "\e\\", &command, &result->fg.r, &result->fg.g, &result->fg.b) == NULL)
-    {
-        if (command != 10)
-            return false;
-        if (result->fg.r > 0x0100 || result->fg.g > 0x0100 || result->fg.b > 0x0100)
-            result->fg.r /= 0x0100, result->fg.g /= 0x0100, result->fg.b /= 0x0100;
-    }
-    else
+    if (!query->answered || command != expected)
         return false;
+    if (color->r > 0x0100 || color->g > 0x0100 || color->b > 0x0100)
+        color->r /= 0x0100, color->g /= 0x0100, color->b /= 0x0100;
+    return true;
+}
 
-    if (ffGetTerminalResponse("\e]11;?\e\\", "\e]%d;rgb:%" SCNx16 "/%" SCNx16 "/%" SCNx16 "\e\\", &command, &result->bg.r, &result->bg.g, &result->bg.b) == NULL)
-    {
-        if (command != 11)
-            return false;
-        if (result->bg.r > 0x0100 || result->bg.g > 0x0100 || result->bg.b > 0x0100)
-            result->bg.r /= 0x0100, result->bg.g /= 0x0100, result->bg.b /= 0x0100;
-    }
-    else
+static bool detectByEscapeCode(FFTerminalThemeResult* result)
+{
+    int fgCommand = 0, bgCommand = 0;
+
+    FFTerminalQuery queries[] = {
+        { .request = "\e]10;?\e\\", .format = "\e]%d;rgb:%" SCNx16 "/%" SCNx16 "/%" SCNx16 "\e\\", .args = { &fgCommand, &result->fg.r, &result->fg.g, &result->fg.b } },
+        { .request = "\e]11;?\e\\", .format = "\e]%d;rgb:%" SCNx16 "/%" SCNx16 "/%" SCNx16 "\e\\", .args = { &bgCommand, &result->bg.r, &result->bg.g, &result->bg.b } },
+    };
+    if (ffGetTerminalResponses(queries, 2) != NULL)
         return false;
 
-    return true;
+    return parseOscColor(&queries[0], fgCommand, 10, &result->fg) &&
+        parseOscColor(&queries[1], bgCommand, 11, &result->bg);
 }
 
 static FFTerminalThemeColor fgbgToColor(int num)
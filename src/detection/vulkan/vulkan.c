@@ -6,8 +6,10 @@
 #include "common/library.h"
 #include "common/io/io.h"
 #include "common/parsing.h"
+#include "detection/gpu/gpu_driver_cache.h"
 #include "util/stringUtils.h"
 
+#include <inttypes.h>
 #include <stdlib.h>
 #include <vulkan/vulkan.h>
 
@@ -205,6 +207,7 @@ static const char* detectVulkan(FFVulkanResult* result)
         gpu->coreCount = FF_GPU_CORE_COUNT_UNSET;
         gpu->temperature = FF_GPU_TEMP_UNSET;
         gpu->frequency = FF_GPU_FREQUENCY_UNSET;
+        gpu->usage = gpu->memoryBandwidthUsage = FF_GPU_USAGE_UNSET;
 
     next:
         continue;
@@ -218,6 +221,90 @@ static const char* detectVulkan(FFVulkanResult* result)
     return NULL;
 }
 
+// Creating a Vulkan instance loads and initializes every installed driver, which is slow
+static bool readCache(FFVulkanResult* result)
+{
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+    if(!ffGPUDriverCacheRead("vulkan", &instance.config.library.libVulkan, &content))
+        return false;
+
+    uint32_t index = 0;
+    if(!ffGPUDriverCacheReadLine(&content, &index, &result->driver) ||
+        !ffGPUDriverCacheReadLine(&content, &index, &result->apiVersion) ||
+        !ffGPUDriverCacheReadLine(&content, &index, &result->conformanceVersion) ||
+        !ffGPUDriverCacheReadLine(&content, &index, &result->instanceVersion))
+        return false;
+
+    FF_STRBUF_AUTO_DESTROY line = ffStrbufCreate();
+    while(ffGPUDriverCacheReadLine(&content, &index, &line))
+    {
+        FFGPUResult* gpu = ffListAdd(&result->gpus);
+        gpu->type = (FFGPUType) ffStrbufToUInt(&line, FF_GPU_TYPE_UNKNOWN);
+        ffStrbufInit(&gpu->vendor);
+        ffStrbufInit(&gpu->name);
+        ffStrbufInit(&gpu->driver);
+        ffStrbufInit(&gpu->platformApi);
+        gpu->coreCount = FF_GPU_CORE_COUNT_UNSET;
+        gpu->temperature = FF_GPU_TEMP_UNSET;
+        gpu->frequency = FF_GPU_FREQUENCY_UNSET;
+        gpu->usage = gpu->memoryBandwidthUsage = FF_GPU_USAGE_UNSET;
+        gpu->dedicated.used = gpu->shared.used = FF_GPU_VMEM_SIZE_UNSET;
+
+        if(!ffGPUDriverCacheReadLine(&content, &index, &gpu->vendor) ||
+            !ffGPUDriverCacheReadLine(&content, &index, &gpu->name) ||
+            !ffGPUDriverCacheReadLine(&content, &index, &gpu->driver) ||
+            !ffGPUDriverCacheReadLine(&content, &index, &gpu->platformApi) ||
+            !ffGPUDriverCacheReadLine(&content, &index, &line))
+            return false;
+        gpu->dedicated.total = ffStrbufToUInt(&line, 0);
+
+        if(!ffGPUDriverCacheReadLine(&content, &index, &line))
+            return false;
+        gpu->shared.total = ffStrbufToUInt(&line, 0);
+
+        if(!ffGPUDriverCacheReadLine(&content, &index, &line))
+            return false;
+        gpu->deviceId = ffStrbufToUInt(&line, 0);
+    }
+
+    return true;
+}
+
+static void writeCache(const FFVulkanResult* result)
+{
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreateF("%s\n%s\n%s\n%s\n",
+        result->driver.chars, result->apiVersion.chars, result->conformanceVersion.chars, result->instanceVersion.chars);
+    uint32_t lineCount = 4;
+
+    FF_LIST_FOR_EACH(FFGPUResult, gpu, result->gpus)
+    {
+        ffStrbufAppendF(&content, "%u\n%s\n%s\n%s\n%s\n%" PRIu64 "\n%" PRIu64 "\n%" PRIu64 "\n",
+            (unsigned) gpu->type, gpu->vendor.chars, gpu->name.chars, gpu->driver.chars, gpu->platformApi.chars,
+            gpu->dedicated.total, gpu->shared.total, gpu->deviceId);
+        lineCount += 8;
+    }
+
+    // Every value must fit into a single line
+    if(ffStrbufCountC(&content, '\n') == lineCount)
+        ffGPUDriverCacheWrite("vulkan", &instance.config.library.libVulkan, &content);
+}
+
+static void clearResult(FFVulkanResult* result)
+{
+    ffStrbufClear(&result->driver);
+    ffStrbufClear(&result->apiVersion);
+    ffStrbufClear(&result->conformanceVersion);
+    ffStrbufClear(&result->instanceVersion);
+    FF_LIST_FOR_EACH(FFGPUResult, gpu, result->gpus)
+    {
+        ffStrbufDestroy(&gpu->vendor);
+        ffStrbufDestroy(&gpu->name);
+        ffStrbufDestroy(&gpu->driver);
+        ffStrbufDestroy(&gpu->platformApi);
+    }
+    ffListClear(&result->gpus);
+}
+
 #endif
 
 FFVulkanResult* ffDetectVulkan(void)
@@ -233,7 +320,14 @@ FFVulkanResult* ffDetectVulkan(void)
         ffListInit(&result.gpus, sizeof(FFGPUResult));
 
         #ifdef FF_HAVE_VULKAN
-            result.error = detectVulkan(&result);
+            if(!readCache(&result))
+            {
+                // Discard a partially read cache entry
+                clearResult(&result);
+                result.error = detectVulkan(&result);
+                if(result.error == NULL)
+                    writeCache(&result);
+            }
         #else
             result.error = "fastfetch was compiled without vulkan support";
         #endif
@@ -1,45 +1,119 @@
 #include "weather.h"
 
-#define FF_UNITIALIZED ((const char*)(uintptr_t) -1)
-static FFNetworkingState state;
-static const char* status = FF_UNITIALIZED;
+// One request per Weather module instance, started in the prepare pass and consumed in order when printed
+typedef struct FFWeatherRequest
+{
+    FFstrbuf location;
+    FFstrbuf outputFormat;
+    bool consumed;
+    bool sent; // False if the response is served from the cache
+    const char* status;
+    FFstrbuf cachePath; // Empty if caching is disabled
+    FFstrbuf cached; // Cached response body; also the fallback if the request fails
+    FFNetworkingState state;
+} FFWeatherRequest;
 
-void ffPrepareWeather(FFWeatherOptions* options)
+static FFlist requests = { .elementSize = sizeof(FFWeatherRequest*) };
+
+static FFWeatherRequest* startRequest(FFWeatherOptions* options)
 {
-    if (status != FF_UNITIALIZED)
-    {
-        fputs("Error: Weather module can only be used once due to internal limitations\n", stderr);
-        exit(1);
-    }
+    // Allocated separately; the networking code keeps a pointer to the state while the request is active
+    FFWeatherRequest* request = calloc(1, sizeof(*request));
+    *(FFWeatherRequest**) ffListAdd(&requests) = request;
+    ffStrbufInitCopy(&request->location, &options->location);
+    ffStrbufInitCopy(&request->outputFormat, &options->outputFormat);
+    ffStrbufInit(&request->cachePath);
+    ffStrbufInit(&request->cached);
 
-    state.timeout = options->timeout;
+    request->state.timeout = options->timeout;
+    request->state.dualStack = true;
 
     FF_STRBUF_AUTO_DESTROY path = ffStrbufCreateS("/");
     if (options->location.length)
         ffStrbufAppend(&path, &options->location);
     ffStrbufAppendS(&path, "?format=");
     ffStrbufAppend(&path, &options->outputFormat);
-    status = ffNetworkingSendHttpRequest(&state, "wttr.in", path.chars, "User-Agent: curl/0.0.0\r\n");
+    const char* headers = "User-Agent: curl/0.0.0\r\n";
+
+    if (options->cacheTtl > 0)
+    {
+        ffNetworkingGetCachePath(&request->cachePath, "weather", &path, false);
+
+        bool stale;
+        if (ffNetworkingReadCache(&request->cachePath, options->cacheTtl, &request->cached, &stale) &&
+            (!stale || (options->cacheRefresh && ffNetworkingRefreshCache(&request->state, "wttr.in", path.chars, headers, &request->cachePath))))
+            return request;
+    }
+
+    request->status = ffNetworkingSendHttpRequest(&request->state, "wttr.in", path.chars, headers);
+    request->sent = true;
+    return request;
+}
+
+void ffPrepareWeather(FFWeatherOptions* options)
+{
+    startRequest(options);
+}
+
+void ffReleaseWeatherRequests(void)
+{
+    FF_LIST_FOR_EACH(FFWeatherRequest*, item, requests)
+    {
+        FFWeatherRequest* request = *item;
+        if (request->sent && !request->consumed)
+            ffNetworkingAbortHttpRequest(&request->state);
+        ffStrbufDestroy(&request->location);
+        ffStrbufDestroy(&request->outputFormat);
+        ffStrbufDestroy(&request->cachePath);
+        ffStrbufDestroy(&request->cached);
+        free(request);
+    }
+    ffListDestroy(&requests);
 }
 
 const char* ffDetectWeather(FFWeatherOptions* options, FFstrbuf* result)
 {
-    if(status == FF_UNITIALIZED)
-        ffPrepareWeather(options);
+    FFWeatherRequest* request = NULL;
+    FF_LIST_FOR_EACH(FFWeatherRequest*, item, requests)
+    {
+        if ((*item)->consumed || !ffStrbufEqual(&(*item)->location, &options->location) || !ffStrbufEqual(&(*item)->outputFormat, &options->outputFormat))
+            continue;
+        request = *item;
+        break;
+    }
+    if (!request)
+        request = startRequest(options);
+    request->consumed = true;
 
-    if(status != NULL)
-        return status;
+    const char* error = NULL;
+    if (request->sent)
+    {
+        error = request->status;
+        if (error == NULL)
+        {
+            FF_STRBUF_AUTO_DESTROY response = ffStrbufCreateA(4096);
+            error = ffNetworkingRecvHttpResponse(&request->state, &response);
+            if (error == NULL)
+            {
+                ffStrbufSubstrAfterFirstS(&response, "\r\n\r\n");
+                if (request->cachePath.length > 0)
+                    ffNetworkingWriteCache(&request->cachePath, &response);
+                ffStrbufAppend(result, &response);
+            }
+        }
+    }
 
-    ffStrbufEnsureFree(result, 4095);
-    const char* error = ffNetworkingRecvHttpResponse(&state, result);
-    if (error == NULL)
+    if (!request->sent || (error != NULL && request->cached.length > 0))
     {
-        ffStrbufSubstrAfterFirstS(result, "\r\n\r\n");
-        ffStrbufTrimRightSpace(result);
+        // Fresh enough, being refreshed in the background, or we are offline
+        ffStrbufAppend(result, &request->cached);
+        error = NULL;
     }
-    else
+
+    if (error != NULL)
         return error;
 
+    ffStrbufTrimRightSpace(result);
     if(result->length == 0)
         return "Empty server response received";
 
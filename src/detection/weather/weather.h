@@ -3,4 +3,6 @@
 #include "common/networking.h"
 
 void ffPrepareWeather(FFWeatherOptions* options);
+// Closes the requests that were started but never printed, and frees all of them
+void ffReleaseWeatherRequests(void);
 const char* ffDetectWeather(FFWeatherOptions* options, FFstrbuf* result);
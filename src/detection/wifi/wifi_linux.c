@@ -216,6 +216,7 @@ static const char* detectWifiWithLibnm(FFlist* result)
 #define FF_DETECT_WIFI_WITH_IOCTLS
 
 #include "common/io/io.h"
+#include "common/netif/netif.h"
 
 #include <net/if.h>
 #include <sys/ioctl.h>
@@ -223,110 +224,133 @@ static const char* detectWifiWithLibnm(FFlist* result)
 #include <unistd.h>
 #include <linux/wireless.h> //TODO: Don't depend on kernel headers
 
-static const char* detectWifiWithIoctls(FFlist* result)
-{
-    struct if_nameindex* infs = if_nameindex();
-    if(!infs)
-        return "if_nameindex() failed";
+// Same strings as `/sys/class/net/<iface>/operstate`
+static const char* operStateNames[] = {
+    "unknown", "notpresent", "down", "lowerlayerdown", "testing", "dormant", "up",
+};
 
+// `operState` is an IF_OPER_* value, or -1 to read it from sysfs
+static void detectWifiInterface(FFlist* result, const char* ifName, int operState)
+{
     FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
 
-    for(struct if_nameindex* i = infs; !(i->if_index == 0 && i->if_name == NULL); ++i)
+    ffStrbufSetF(&path, "/sys/class/net/%s/phy80211", ifName);
+    if(!ffPathExists(path.chars, FF_PATHTYPE_DIRECTORY))
+        return;
+
+    FFWifiResult* item = (FFWifiResult*)ffListAdd(result);
+    ffStrbufInitS(&item->inf.description, ifName);
+    ffStrbufInit(&item->inf.status);
+    ffStrbufInit(&item->conn.status);
+    ffStrbufInit(&item->conn.ssid);
+    ffStrbufInit(&item->conn.macAddress);
+    ffStrbufInit(&item->conn.protocol);
+    ffStrbufInit(&item->conn.security);
+    item->conn.signalQuality = 0.0/0.0;
+    item->conn.rxRate = 0.0/0.0;
+    item->conn.txRate = 0.0/0.0;
+
+    if (operState >= 0)
+        ffStrbufSetS(&item->inf.status, operState < (int) (sizeof(operStateNames) / sizeof(*operStateNames)) ? operStateNames[operState] : "unknown");
+    else
     {
-        ffStrbufSetF(&path, "/sys/class/net/%s/phy80211", i->if_name);
-        if(!ffPathExists(path.chars, FF_PATHTYPE_DIRECTORY))
-            continue;
-
-        FFWifiResult* item = (FFWifiResult*)ffListAdd(result);
-        ffStrbufInitS(&item->inf.description, i->if_name);
-        ffStrbufInit(&item->inf.status);
-        ffStrbufInit(&item->conn.status);
-        ffStrbufInit(&item->conn.ssid);
-        ffStrbufInit(&item->conn.macAddress);
-        ffStrbufInit(&item->conn.protocol);
-        ffStrbufInit(&item->conn.security);
-        item->conn.signalQuality = 0.0/0.0;
-        item->conn.rxRate = 0.0/0.0;
-        item->conn.txRate = 0.0/0.0;
-
-        ffStrbufSetF(&path, "/sys/class/net/%s/operstate", i->if_name);
+        ffStrbufSetF(&path, "/sys/class/net/%s/operstate", ifName);
         if (!ffAppendFileBuffer(path.chars, &item->inf.status))
-            continue;
-
+            return;
         ffStrbufTrimRightSpace(&item->inf.status);
-        if (!ffStrbufEqualS(&item->inf.status, "up"))
-            continue;
+    }
 
-        FF_AUTO_CLOSE_FD int sock = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
-        if(sock < 0)
-            continue;
+    if (!ffStrbufEqualS(&item->inf.status, "up"))
+        return;
 
-        struct iwreq iwr;
-        strncpy(iwr.ifr_name, i->if_name, IFNAMSIZ);
-        ffStrbufEnsureFree(&item->conn.ssid, IW_ESSID_MAX_SIZE);
-        iwr.u.essid.pointer = (caddr_t) item->conn.ssid.chars;
-        iwr.u.essid.length = IW_ESSID_MAX_SIZE + 1;
-        iwr.u.essid.flags = 0;
-        if(ioctl(sock, SIOCGIWESSID, &iwr) >= 0)
-            ffStrbufRecalculateLength(&item->conn.ssid);
+    FF_AUTO_CLOSE_FD int sock = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if(sock < 0)
+        return;
 
-        if(ioctl(sock, SIOCGIWNAME, &iwr) >= 0 && !ffStrEqualsIgnCase(iwr.u.name, "IEEE 802.11"))
-        {
-            if(ffStrStartsWithIgnCase(iwr.u.name, "IEEE "))
-                ffStrbufSetS(&item->conn.protocol, iwr.u.name + strlen("IEEE "));
-            else
-                ffStrbufSetS(&item->conn.protocol, iwr.u.name);
-        }
+    struct iwreq iwr;
+    strncpy(iwr.ifr_name, ifName, IFNAMSIZ);
+    ffStrbufEnsureFree(&item->conn.ssid, IW_ESSID_MAX_SIZE);
+    iwr.u.essid.pointer = (caddr_t) item->conn.ssid.chars;
+    iwr.u.essid.length = IW_ESSID_MAX_SIZE + 1;
+    iwr.u.essid.flags = 0;
+    if(ioctl(sock, SIOCGIWESSID, &iwr) >= 0)
+        ffStrbufRecalculateLength(&item->conn.ssid);
 
-        if(ioctl(sock, SIOCGIWAP, &iwr) >= 0)
-        {
-            for(int i = 0; i < 6; ++i)
-                ffStrbufAppendF(&item->conn.macAddress, "%.2X-", (uint8_t) iwr.u.ap_addr.sa_data[i]);
-            ffStrbufTrimRight(&item->conn.macAddress, '-');
-        }
+    if(ioctl(sock, SIOCGIWNAME, &iwr) >= 0 && !ffStrEqualsIgnCase(iwr.u.name, "IEEE 802.11"))
+    {
+        if(ffStrStartsWithIgnCase(iwr.u.name, "IEEE "))
+            ffStrbufSetS(&item->conn.protocol, iwr.u.name + strlen("IEEE "));
+        else
+            ffStrbufSetS(&item->conn.protocol, iwr.u.name);
+    }
 
-        struct iw_statistics stats;
-        iwr.u.data.pointer = &stats;
-        iwr.u.data.length = sizeof(stats);
-        iwr.u.data.flags = 0;
+    if(ioctl(sock, SIOCGIWAP, &iwr) >= 0)
+    {
+        for(int i = 0; i < 6; ++i)
+            ffStrbufAppendF(&item->conn.macAddress, "%.2X-", (uint8_t) iwr.u.ap_addr.sa_data[i]);
+        ffStrbufTrimRight(&item->conn.macAddress, '-');
+    }
 
-        if(ioctl(sock, SIOCGIWSTATS, &iwr) >= 0)
-        {
-            int8_t level = (int8_t) stats.qual.level; // https://stackoverflow.com/questions/18079771/wireless-h-how-do-i-print-out-the-signal-level
-            item->conn.signalQuality = level >= -50 ? 100 : level <= -100 ? 0 : (level + 100) * 2;
-        }
+    struct iw_statistics stats;
+    iwr.u.data.pointer = &stats;
+    iwr.u.data.length = sizeof(stats);
+    iwr.u.data.flags = 0;
+
+    if(ioctl(sock, SIOCGIWSTATS, &iwr) >= 0)
+    {
+        int8_t level = (int8_t) stats.qual.level; // https://stackoverflow.com/questions/18079771/wireless-h-how-do-i-print-out-the-signal-level
+        item->conn.signalQuality = level >= -50 ? 100 : level <= -100 ? 0 : (level + 100) * 2;
+    }
 
-        //FIXME: doesn't work
-        struct iw_encode_ext iwe;
-        iwr.u.data.pointer = &iwe;
-        iwr.u.data.length = sizeof(iwe);
-        iwr.u.data.flags = 0;
-        if(ioctl(sock, SIOCGIWENCODEEXT, &iwr) >= 0)
+    //FIXME: doesn't work
+    struct iw_encode_ext iwe;
+    iwr.u.data.pointer = &iwe;
+    iwr.u.data.length = sizeof(iwe);
+    iwr.u.data.flags = 0;
+    if(ioctl(sock, SIOCGIWENCODEEXT, &iwr) >= 0)
+    {
+        struct iw_encode_ext* iwe = iwr.u.data.pointer;
+        switch(iwe->alg)
         {
-            struct iw_encode_ext* iwe = iwr.u.data.pointer;
-            switch(iwe->alg)
-            {
-                case IW_ENCODE_ALG_WEP:
-                    ffStrbufAppendS(&item->conn.security, "WEP");
-                    break;
-                case IW_ENCODE_ALG_TKIP:
-                    ffStrbufAppendS(&item->conn.security, "TKIP");
-                    break;
-                case IW_ENCODE_ALG_CCMP:
-                    ffStrbufAppendS(&item->conn.security, "CCMP");
-                    break;
-                case IW_ENCODE_ALG_PMK:
-                    ffStrbufAppendS(&item->conn.security, "PMK");
-                    break;
-                case IW_ENCODE_ALG_AES_CMAC:
-                    ffStrbufAppendS(&item->conn.security, "CMAC");
-                    break;
-                default:
-                    ffStrbufAppendF(&item->conn.security, "Unknown (%d)", (int) iwe->alg);
-                    break;
-            }
+            case IW_ENCODE_ALG_WEP:
+                ffStrbufAppendS(&item->conn.security, "WEP");
+                break;
+            case IW_ENCODE_ALG_TKIP:
+                ffStrbufAppendS(&item->conn.security, "TKIP");
+                break;
+            case IW_ENCODE_ALG_CCMP:
+                ffStrbufAppendS(&item->conn.security, "CCMP");
+                break;
+            case IW_ENCODE_ALG_PMK:
+                ffStrbufAppendS(&item->conn.security, "PMK");
+                break;
+            case IW_ENCODE_ALG_AES_CMAC:
+                ffStrbufAppendS(&item->conn.security, "CMAC");
+                break;
+            default:
+                ffStrbufAppendF(&item->conn.security, "Unknown (%d)", (int) iwe->alg);
+                break;
         }
     }
+}
+
+static const char* detectWifiWithIoctls(FFlist* result)
+{
+    // Names and operational states of all links come from the shared netlink interface table
+    const FFlist* interfaces = ffNetifGetInterfaces();
+    if (interfaces)
+    {
+        FF_LIST_FOR_EACH(FFNetifInterface, inf, *interfaces)
+            detectWifiInterface(result, inf->name, inf->operState);
+        return NULL;
+    }
+
+    struct if_nameindex* infs = if_nameindex();
+    if(!infs)
+        return "if_nameindex() failed";
+
+    for(struct if_nameindex* i = infs; !(i->if_index == 0 && i->if_name == NULL); ++i)
+        detectWifiInterface(result, i->if_name, -1);
     if_freenameindex(infs);
 
     return NULL;
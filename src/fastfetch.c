@@ -2,6 +2,8 @@
 #include "common/commandoption.h"
 #include "common/io/io.h"
 #include "common/jsonconfig.h"
+#include "common/networking.h"
+#include "modules/command/command.h"
 #include "detection/version/version.h"
 #include "util/stringUtils.h"
 #include "util/mallocHelper.h"
@@ -759,6 +761,13 @@ int main(int argc, char** argv)
     ffInitInstance();
     atexit(ffDestroyInstance);
 
+    #ifndef _WIN32
+    if (argc > 1 && strcmp(argv[1], FF_NETWORKING_REFRESH_COMMAND) == 0)
+        return ffNetworkingRefreshCacheMain(argc, argv);
+    if (argc > 1 && strcmp(argv[1], FF_COMMAND_REFRESH_COMMAND) == 0)
+        return ffCommandRefreshCacheMain(argc, argv);
+    #endif
+
     //Data stores things only needed for the configuration of fastfetch
     FFdata data = {
         .structure = ffStrbufCreate(),
@@ -4558,3 +4558,9 @@ static const FFlogo Z[] = {
 const FFlogo* ffLogoBuiltins[] = {
     A, B, C, D, E, F, G, H, I, J, K, L, M, N, O, P, Q, R, S, T, U, V, W, X, Y, Z,
 };
+
+const FFLogoBuiltinAlias ffLogoBuiltinAliases[] = {
+    FASTFETCH_LOGO_BUILTIN_ALIASES
+};
+
+const uint32_t ffLogoBuiltinAliasCount = sizeof(ffLogoBuiltinAliases) / sizeof(*ffLogoBuiltinAliases);
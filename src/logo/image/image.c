@@ -1,10 +1,15 @@
 #include "image.h"
 #include "common/io/io.h"
 #include "common/printing.h"
+#include "util/base64.h"
+#include "util/hash.h"
 #include "util/stringUtils.h"
 
+#include <inttypes.h>
 #include <limits.h>
 #include <math.h>
+#include <string.h>
+#include <sys/stat.h>
 
 #ifdef __APPLE__
     #include <sys/syslimits.h>
@@ -12,83 +17,187 @@
     #include <windows.h>
 #endif
 
-// https://github.com/kostya/benchmarks/blob/master/base64/test-nolib.c#L145
-static void base64EncodeRaw(uint32_t size, const char *str, uint32_t *out_size, char *output)
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/uio.h>
+#endif
+
+typedef struct FFOutputPart
+{
+    const char* chars;
+    size_t length;
+} FFOutputPart;
+
+// Writes the parts to stdout without joining them first. Used for multi-megabyte image payloads
+static void writeStdoutParts(uint32_t count, const FFOutputPart* parts)
+{
+    fflush(stdout);
+
+    #ifndef _WIN32
+    struct iovec iov[4];
+    assert(count <= sizeof(iov) / sizeof(*iov));
+    size_t remaining = 0;
+    int iovcnt = 0;
+    for(uint32_t i = 0; i < count; ++i)
+    {
+        if(parts[i].length == 0)
+            continue;
+        iov[iovcnt++] = (struct iovec) { .iov_base = (void*) parts[i].chars, .iov_len = parts[i].length };
+        remaining += parts[i].length;
+    }
+
+    struct iovec* current = iov;
+    while(remaining > 0)
+    {
+        ssize_t written = writev(STDOUT_FILENO, current, (int) (&iov[iovcnt] - current));
+        if(written <= 0)
+            break;
+        remaining -= (size_t) written;
+        // Partial writes are possible on pipes and ttys
+        while(current < &iov[iovcnt] && (size_t) written >= current->iov_len)
+            written -= (ssize_t) current++->iov_len;
+        if(current < &iov[iovcnt])
+        {
+            current->iov_base = (char*) current->iov_base + written;
+            current->iov_len -= (size_t) written;
+        }
+    }
+    #else
+    for(uint32_t i = 0; i < count; ++i)
+        ffWriteFDData(FFUnixFD2NativeFD(STDOUT_FILENO), parts[i].length, parts[i].chars);
+    #endif
+}
+
+// The encoded image is cached by the identity of the source file (path, device, inode, size and mtime),
+// so a hit needs neither to read nor to encode the image
+static bool getItermCachePath(const char* source, FFstrbuf* path, uint32_t* encodedLength)
 {
-    static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    char *out = output;
-    const char *ends = str + (size - size % 3);
-    while (str != ends) {
-        uint32_t n = __builtin_bswap32(*(uint32_t*) str);
-        *out++ = chars[(n >> 26) & 63];
-        *out++ = chars[(n >> 20) & 63];
-        *out++ = chars[(n >> 14) & 63];
-        *out++ = chars[(n >> 8) & 63];
-        str += 3;
-    }
-
-    if (size % 3 == 1) {
-        uint64_t n = (uint64_t)*str << 16;
-        *out++ = chars[(n >> 18) & 63];
-        *out++ = chars[(n >> 12) & 63];
-        *out++ = '=';
-        *out++ = '=';
-    } else if (size % 3 == 2) {
-        uint64_t n = (uint64_t)*str++ << 16;
-        n |= (uint64_t)*str << 8;
-        *out++ = chars[(n >> 18) & 63];
-        *out++ = chars[(n >> 12) & 63];
-        *out++ = chars[(n >> 6) & 63];
-        *out++ = '=';
-    }
-    *out = '\0';
-    *out_size = (uint32_t) (out - output);
+    struct stat st;
+    if(stat(source, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 || st.st_size > UINT32_MAX / 4 * 3)
+        return false;
+
+    struct
+    {
+        uint64_t device;
+        uint64_t inode;
+        uint64_t size;
+        int64_t mtimeSec;
+        int64_t mtimeNsec;
+    } identity = {
+        .device = (uint64_t) st.st_dev,
+        .inode = (uint64_t) st.st_ino,
+        .size = (uint64_t) st.st_size,
+        .mtimeSec = (int64_t) st.st_mtime,
+        #if defined(__APPLE__)
+        .mtimeNsec = st.st_mtimespec.tv_nsec,
+        #elif !defined(_WIN32)
+        .mtimeNsec = st.st_mtim.tv_nsec,
+        #endif
+    };
+
+    uint64_t hash = ffHashFnv1aAppend(FF_HASH_FNV1A_INIT, &identity, sizeof(identity));
+    hash = ffHashFnv1aAppend(hash, source, strlen(source));
+
+    ffStrbufSet(path, &instance.state.platform.cacheDir);
+    ffStrbufAppendF(path, "fastfetch/images/%016" PRIx64 ".b64", hash);
+    *encodedLength = ffBase64EncodedLength((uint32_t) st.st_size);
+    return true;
 }
 
-static FFstrbuf base64Encode(const FFstrbuf* in)
+// Sets `payload` to the base64 encoded image: a mapping of the cache file on a hit, the contents of `buffer` otherwise.
+// The mapping must be released with `releaseItermPayload`
+static bool loadItermPayload(const char* source, FFstrbuf* buffer, FFOutputPart* payload)
 {
-    FFstrbuf out = ffStrbufCreateA(10 + in->length * 4 / 3);
-    base64EncodeRaw(in->length, in->chars, &out.length, out.chars);
-    assert(out.length < out.allocated);
+    FF_STRBUF_AUTO_DESTROY cachePath = ffStrbufCreate();
+    uint32_t encodedLength = 0;
+    bool cacheable = getItermCachePath(source, &cachePath, &encodedLength);
+
+    if(cacheable)
+    {
+        #ifndef _WIN32
+        FF_AUTO_CLOSE_FD int fd = open(cachePath.chars, O_RDONLY | O_CLOEXEC);
+        struct stat st;
+        if(fd >= 0 && fstat(fd, &st) == 0 && st.st_size == (off_t) encodedLength)
+        {
+            void* data = mmap(NULL, encodedLength, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(data != MAP_FAILED)
+            {
+                *payload = (FFOutputPart) { data, encodedLength };
+                return true;
+            }
+        }
+        #else
+        if(ffReadFileBuffer(cachePath.chars, buffer) && buffer->length == encodedLength)
+        {
+            *payload = (FFOutputPart) { buffer->chars, buffer->length };
+            return true;
+        }
+        ffStrbufClear(buffer);
+        #endif
+    }
+
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+    if(!ffAppendFileBuffer(source, &content))
+        return false;
+
+    ffBase64Append(buffer, content.length, content.chars);
+    if(cacheable && buffer->length == encodedLength)
+        ffWriteFileBufferAtomic(cachePath.chars, buffer); // Other instances may have it mapped
+
+    *payload = (FFOutputPart) { buffer->chars, buffer->length };
+    return true;
+}
 
-    return out;
+static void releaseItermPayload(const FFstrbuf* buffer, const FFOutputPart* payload)
+{
+    #ifndef _WIN32
+    if(payload->chars != buffer->chars)
+        munmap((void*) payload->chars, payload->length);
+    #else
+    FF_UNUSED(buffer, payload);
+    #endif
 }
 
 static bool printImageIterm(bool printError)
 {
     const FFOptionsLogo* options = &instance.config.logo;
-    FF_STRBUF_AUTO_DESTROY buf = ffStrbufCreate();
-    if(!ffAppendFileBuffer(options->source.chars, &buf))
+    FF_STRBUF_AUTO_DESTROY base64 = ffStrbufCreate();
+    FFOutputPart payload;
+    if(!loadItermPayload(options->source.chars, &base64, &payload))
     {
         if (printError)
             fputs("Logo (iterm): Failed to load image file\n", stderr);
         return false;
     }
 
-    fflush(stdout);
-
-    FF_STRBUF_AUTO_DESTROY base64 = base64Encode(&buf);
-    ffStrbufClear(&buf);
+    FF_STRBUF_AUTO_DESTROY prefix = ffStrbufCreate();
+    FF_STRBUF_AUTO_DESTROY suffix = ffStrbufCreate();
 
     if (!options->width || !options->height)
     {
         if (!options->separate)
         {
-            ffStrbufAppendF(&buf, "\e[2J\e[3J\e[%u;%uH",
+            ffStrbufAppendF(&prefix, "\e[2J\e[3J\e[%u;%uH",
                 (unsigned) options->paddingTop,
                 (unsigned) options->paddingLeft
             );
         }
         else
         {
-            ffStrbufAppendNC(&buf, options->paddingTop, '\n');
-            ffStrbufAppendNC(&buf, options->paddingLeft, ' ');
+            ffStrbufAppendNC(&prefix, options->paddingTop, '\n');
+            ffStrbufAppendNC(&prefix, options->paddingLeft, ' ');
         }
         if (options->width)
-            ffStrbufAppendF(&buf, "\e]1337;File=inline=1;width=%u:%s\a", (unsigned) options->width, base64.chars);
+            ffStrbufAppendF(&prefix, "\e]1337;File=inline=1;width=%u:", (unsigned) options->width);
         else
-            ffStrbufAppendF(&buf, "\e]1337;File=inline=1:%s\a", base64.chars);
-        ffWriteFDBuffer(FFUnixFD2NativeFD(STDOUT_FILENO), &buf);
+            ffStrbufAppendS(&prefix, "\e]1337;File=inline=1:");
+        ffStrbufAppendC(&suffix, '\a');
+        writeStdoutParts(3, (FFOutputPart[]) {
+            { prefix.chars, prefix.length },
+            payload,
+            { suffix.chars, suffix.length },
+        });
 
         if (!options->separate)
         {
@@ -96,12 +205,15 @@ static bool printImageIterm(bool printError)
             const char* error = ffGetTerminalResponse("\e[6n", "\e[%hu;%huR", &Y, &X);
             if (error)
             {
+                // We already printed image logo, don't print ascii logo then
                 fprintf(stderr, "\nLogo (iterm): fail to query cursor position: %s\n", error);
-                return true; // We already printed image logo, don't print ascii logo then
             }
-            instance.state.logoWidth = X + options->paddingRight;
-            instance.state.logoHeight = Y;
-            fputs("\e[H", stdout);
+            else
+            {
+                instance.state.logoWidth = X + options->paddingRight;
+                instance.state.logoHeight = Y;
+                fputs("\e[H", stdout);
+            }
         }
         else
         {
@@ -111,29 +223,34 @@ static bool printImageIterm(bool printError)
     }
     else
     {
-        ffStrbufAppendNC(&buf, options->paddingTop, '\n');
-        ffStrbufAppendNC(&buf, options->paddingLeft, ' ');
-        ffStrbufAppendF(&buf, "\e]1337;File=inline=1;width=%u;height=%u;preserveAspectRatio=%u:%s\a\n",
+        ffStrbufAppendNC(&prefix, options->paddingTop, '\n');
+        ffStrbufAppendNC(&prefix, options->paddingLeft, ' ');
+        ffStrbufAppendF(&prefix, "\e]1337;File=inline=1;width=%u;height=%u;preserveAspectRatio=%u:",
             (unsigned) options->width,
             (unsigned) options->height,
-            (unsigned) options->preserveAspectRatio,
-            base64.chars
+            (unsigned) options->preserveAspectRatio
         );
+        ffStrbufAppendS(&suffix, "\a\n");
 
         if (!options->separate)
         {
             instance.state.logoWidth = options->width + options->paddingLeft + options->paddingRight;
             instance.state.logoHeight = options->paddingTop + options->height;
-            ffStrbufAppendF(&buf, "\e[%uA", (unsigned) instance.state.logoHeight);
+            ffStrbufAppendF(&suffix, "\e[%uA", (unsigned) instance.state.logoHeight);
         }
         else
         {
             instance.state.logoWidth = instance.state.logoHeight = 0;
-            ffStrbufAppendNC(&buf, options->paddingRight, '\n');
+            ffStrbufAppendNC(&suffix, options->paddingRight, '\n');
         }
-        ffWriteFDBuffer(FFUnixFD2NativeFD(STDOUT_FILENO), &buf);
+        writeStdoutParts(3, (FFOutputPart[]) {
+            { prefix.chars, prefix.length },
+            payload,
+            { suffix.chars, suffix.length },
+        });
     }
 
+    releaseItermPayload(&base64, &payload);
     return true;
 }
 
@@ -148,7 +265,9 @@ static bool printImageKittyDirect(bool printError)
         return false;
     }
 
-    FF_STRBUF_AUTO_DESTROY base64 = base64Encode(&options->source);
+    // With `t=f` only the file path is transmitted; the terminal reads the image itself
+    FF_STRBUF_AUTO_DESTROY base64 = ffStrbufCreate();
+    ffBase64Append(&base64, options->source.length, options->source.chars);
 
     if (!options->width || !options->height)
     {
@@ -220,33 +339,29 @@ static bool printImageKittyDirect(bool printError)
 
 #define FF_KITTY_MAX_CHUNK_SIZE 4096
 
-#define FF_CACHE_FILE_HEIGHT "height"
-#define FF_CACHE_FILE_WIDTH "width"
-#define FF_CACHE_FILE_SIXEL "sixel"
-#define FF_CACHE_FILE_KITTY_COMPRESSED "kittyc"
-#define FF_CACHE_FILE_KITTY_UNCOMPRESSED "kittyu"
-#define FF_CACHE_FILE_CHAFA "chafa"
+#define FF_CACHE_MAGIC "FFIC"
+#define FF_CACHE_VERSION 1
 
-#include <string.h>
 #include <unistd.h>
-#include <fcntl.h>
 
 #ifndef _WIN32
 #include <sys/ioctl.h>
 #else
 #include <wincon.h>
+#endif
 
-static inline char* realpath(const char* restrict file_name, char* restrict resolved_name)
+// A rendered logo is cached in one file: this header, the payload (escape codes or chafa output) and a NUL terminator.
+// The file name is a hash of the image content and all render parameters, so it never needs to be invalidated
+typedef struct FFLogoCacheHeader
 {
-    char* result = _fullpath(resolved_name, file_name, _MAX_PATH);
-    if(result)
-    {
-        resolved_name[1] = resolved_name[0]; // Drive Name
-        resolved_name[0] = '/';
-    }
-    return result;
-}
-#endif
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t characterWidth;
+    uint32_t characterHeight;
+    uint32_t payloadLength;
+    uint32_t reserved;
+} FFLogoCacheHeader;
 
 #ifdef FF_HAVE_ZLIB
 #include "common/library.h"
@@ -290,7 +405,6 @@ typedef struct ImageData
 {
     FF_LIBRARY_SYMBOL(CopyMagickString)
     FF_LIBRARY_SYMBOL(ImageToBlob)
-    FF_LIBRARY_SYMBOL(Base64Encode)
 
     ImageInfo* imageInfo;
     Image* image;
@@ -311,37 +425,33 @@ static inline bool checkAllocationResult(void* data, size_t length)
     return true;
 }
 
-static void writeCacheStrbuf(FFLogoRequestData* requestData, const FFstrbuf* value, const char* cacheFileName)
-{
-    uint32_t cacheDirLength = requestData->cacheDir.length;
-    ffStrbufAppendS(&requestData->cacheDir, cacheFileName);
-    ffWriteFileBuffer(requestData->cacheDir.chars, value);
-    ffStrbufSubstrBefore(&requestData->cacheDir, cacheDirLength);
-}
-
-static void writeCacheUint32(FFLogoRequestData* requestData, uint32_t value, const char* cacheFileName)
+static void writeCache(const FFLogoRequestData* requestData, const FFstrbuf* payload)
 {
-    FFstrbuf content;
-    content.chars = (char*) &value;
-    content.length = sizeof(value);
-    writeCacheStrbuf(requestData, &content, cacheFileName);
+    FFLogoCacheHeader header = {
+        .magic = FF_CACHE_MAGIC,
+        .version = FF_CACHE_VERSION,
+        .key = requestData->cacheKey,
+        .characterWidth = requestData->logoCharacterWidth,
+        .characterHeight = requestData->logoCharacterHeight,
+        .payloadLength = payload->length,
+    };
+
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreateA((uint32_t) sizeof(header) + payload->length + 1);
+    ffStrbufAppendNS(&content, sizeof(header), (const char*) &header);
+    ffStrbufAppendNS(&content, payload->length, payload->chars);
+    ffStrbufAppendC(&content, '\0'); // So that the chafa output can be printed straight from the mapping
+    // Other instances may have the file mapped. Truncating it under them would fault
+    ffWriteFileBufferAtomic(requestData->cachePath.chars, &content);
 }
 
-static void printImagePixels(FFLogoRequestData* requestData, const FFstrbuf* result, const char* cacheFileName)
+static void printImagePixels(FFLogoRequestData* requestData, const FFstrbuf* result)
 {
     const FFOptionsLogo* options = &instance.config.logo;
     //Calculate character dimensions
     instance.state.logoWidth = requestData->logoCharacterWidth + options->paddingLeft + options->paddingRight;
     instance.state.logoHeight = requestData->logoCharacterHeight + options->paddingTop - 1;
 
-    //Write cache files
-    writeCacheStrbuf(requestData, result, cacheFileName);
-
-    if(options->width == 0)
-        writeCacheUint32(requestData, requestData->logoCharacterWidth, FF_CACHE_FILE_WIDTH);
-
-    if(options->height == 0)
-        writeCacheUint32(requestData, requestData->logoCharacterHeight, FF_CACHE_FILE_HEIGHT);
+    writeCache(requestData, result);
 
     //Write result to stdout
     ffPrintCharTimes('\n', options->paddingTop);
@@ -366,27 +476,34 @@ static bool printImageSixel(FFLogoRequestData* requestData, const ImageData* ima
     result.chars = (char*) blob;
     result.length = (uint32_t) length;
 
-    printImagePixels(requestData, &result, FF_CACHE_FILE_SIXEL);
+    printImagePixels(requestData, &result);
 
     free(blob);
     return true;
 }
 
-static void appendKittyChunk(FFstrbuf* result, const char** blob, size_t* length, bool printEscapeCode)
+// Every chunk carries at most FF_KITTY_MAX_CHUNK_SIZE base64 chars, i.e. 3/4 as many bytes of the blob.
+// The blob is encoded straight into the chunks, without an intermediate copy of the whole encoding
+static void appendKittyChunks(FFstrbuf* result, const uint8_t* blob, size_t length)
 {
-    uint32_t chunkSize = *length > FF_KITTY_MAX_CHUNK_SIZE ? FF_KITTY_MAX_CHUNK_SIZE : (uint32_t) *length;
+    const size_t chunkBytes = FF_KITTY_MAX_CHUNK_SIZE / 4 * 3;
+    const size_t chunkCount = (length + chunkBytes - 1) / chunkBytes;
+    ffStrbufEnsureFree(result, (uint32_t) (length / 3 * 4 + chunkCount * sizeof("\033_Gm=1;\033\\") + 4));
 
-    if(printEscapeCode)
-        ffStrbufAppendS(result, "\033_G");
-    else
-        ffStrbufAppendC(result, ',');
-
-    ffStrbufAppendS(result, chunkSize != *length ? "m=1" : "m=0");
-    ffStrbufAppendC(result, ';');
-    ffStrbufAppendNS(result, chunkSize, *blob);
-    ffStrbufAppendS(result, "\033\\");
-    *length -= chunkSize;
-    *blob += chunkSize;
+    bool first = true;
+    while(length > 0)
+    {
+        uint32_t chunkSize = length > chunkBytes ? (uint32_t) chunkBytes : (uint32_t) length;
+
+        ffStrbufAppendS(result, first ? "," : "\033_G");
+        ffStrbufAppendS(result, chunkSize != length ? "m=1;" : "m=0;");
+        ffBase64Append(result, chunkSize, blob);
+        ffStrbufAppendS(result, "\033\\");
+
+        length -= chunkSize;
+        blob += chunkSize;
+        first = false;
+    }
 }
 
 static bool printImageKitty(FFLogoRequestData* requestData, const ImageData* imageData)
@@ -404,26 +521,15 @@ static bool printImageKitty(FFLogoRequestData* requestData, const ImageData* ima
         bool isCompressed = false;
     #endif
 
-    char* chars = imageData->ffBase64Encode(blob, length, &length);
-    free(blob);
-    if(!checkAllocationResult(chars, length))
-        return false;
-
-    FF_STRBUF_AUTO_DESTROY result = ffStrbufCreateA((uint32_t) (length + 1024));
-
-    const char* currentPos = chars;
-    size_t remainingLength = length;
+    FF_STRBUF_AUTO_DESTROY result = ffStrbufCreate();
 
     ffStrbufAppendF(&result, "\033_Ga=T,f=32,s=%u,v=%u", requestData->logoPixelWidth, requestData->logoPixelHeight);
     if(isCompressed)
         ffStrbufAppendS(&result, ",o=z");
-    appendKittyChunk(&result, &currentPos, &remainingLength, false);
-    while(remainingLength > 0)
-        appendKittyChunk(&result, &currentPos, &remainingLength, true);
-
-    printImagePixels(requestData, &result, isCompressed ? FF_CACHE_FILE_KITTY_COMPRESSED : FF_CACHE_FILE_KITTY_UNCOMPRESSED);
+    appendKittyChunks(&result, blob, length);
+    free(blob);
 
-    free(chars);
+    printImagePixels(requestData, &result);
     return true;
 }
 
@@ -504,7 +610,7 @@ static bool printImageChafa(FFLogoRequestData* requestData, const ImageData* ima
     result.chars = str->str;
 
     ffLogoPrintChars(result.chars, false);
-    writeCacheStrbuf(requestData, &result, FF_CACHE_FILE_CHAFA);
+    writeCache(requestData, &result);
 
     // FIXME: These functions must be imported from `libglib` dlls on Windows
     FF_LIBRARY_LOAD_SYMBOL_LAZY(chafa, g_string_free);
@@ -540,7 +646,6 @@ FFLogoImageResult ffLogoPrintImageImpl(FFLogoRequestData* requestData, const FFI
 
     FF_LIBRARY_LOAD_SYMBOL_VAR(imData->library, imageData, CopyMagickString, FF_LOGO_IMAGE_RESULT_INIT_ERROR)
     FF_LIBRARY_LOAD_SYMBOL_VAR(imData->library, imageData, ImageToBlob, FF_LOGO_IMAGE_RESULT_INIT_ERROR)
-    FF_LIBRARY_LOAD_SYMBOL_VAR(imData->library, imageData, Base64Encode, FF_LOGO_IMAGE_RESULT_INIT_ERROR)
 
     ffMagickCoreGenesis(NULL, MagickFalse);
 
@@ -631,112 +736,121 @@ FFLogoImageResult ffLogoPrintImageImpl(FFLogoRequestData* requestData, const FFI
     return printSuccessful ? FF_LOGO_IMAGE_RESULT_SUCCESS : FF_LOGO_IMAGE_RESULT_RUN_ERROR;
 }
 
-static int getCacheFD(FFLogoRequestData* requestData, const char* fileName)
-{
-    uint32_t cacheDirLength = requestData->cacheDir.length;
-    ffStrbufAppendS(&requestData->cacheDir, fileName);
-    int fd = open(requestData->cacheDir.chars, O_RDONLY
-        #ifdef O_CLOEXEC
-            | O_CLOEXEC
-        #endif
-    );
-    ffStrbufSubstrBefore(&requestData->cacheDir, cacheDirLength);
-    return fd;
-}
-
-static void readCachedStrbuf(FFLogoRequestData* requestData, FFstrbuf* result, const char* cacheFileName)
+static bool printCachedRecord(FFLogoRequestData* requestData, const char* data, size_t size)
 {
-    uint32_t cacheDirLength = requestData->cacheDir.length;
-    ffStrbufAppendS(&requestData->cacheDir, cacheFileName);
-    ffAppendFileBuffer(requestData->cacheDir.chars, result);
-    ffStrbufSubstrBefore(&requestData->cacheDir, cacheDirLength);
-}
-
-static uint32_t readCachedUint32(FFLogoRequestData* requestData, const char* cacheFileName)
-{
-    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
-    readCachedStrbuf(requestData, &content, cacheFileName);
-
-    uint32_t result = 0;
+    FFLogoCacheHeader header;
+    if(size < sizeof(header) + 1)
+        return false;
+    memcpy(&header, data, sizeof(header));
 
-    if(content.length != sizeof(result))
-        return 0;
+    if(memcmp(header.magic, FF_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != FF_CACHE_VERSION ||
+        header.key != requestData->cacheKey ||
+        sizeof(header) + header.payloadLength + 1 != size ||
+        header.payloadLength == 0)
+        return false;
 
-    memcpy(&result, content.chars, sizeof(result));
+    const char* payload = data + sizeof(header);
 
-    return result;
-}
+    if(requestData->type == FF_LOGO_TYPE_IMAGE_CHAFA)
+    {
+        ffLogoPrintChars(payload, false);
+        return true;
+    }
 
-static bool printCachedChars(FFLogoRequestData* requestData)
-{
-    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreateA(32768);
+    const FFOptionsLogo* options = &instance.config.logo;
+    requestData->logoCharacterWidth = header.characterWidth;
+    requestData->logoCharacterHeight = header.characterHeight;
 
-    if(requestData->type == FF_LOGO_TYPE_IMAGE_CHAFA)
-        readCachedStrbuf(requestData, &content, FF_CACHE_FILE_CHAFA);
+    FF_STRBUF_AUTO_DESTROY padding = ffStrbufCreate();
+    ffStrbufAppendNC(&padding, options->paddingTop, '\n');
+    ffStrbufAppendNC(&padding, options->paddingLeft, ' ');
+    writeStdoutParts(2, (FFOutputPart[]) {
+        { padding.chars, padding.length },
+        { payload, header.payloadLength },
+    });
 
-    if(content.length == 0)
-        return false;
+    instance.state.logoWidth = requestData->logoCharacterWidth + options->paddingLeft + options->paddingRight;
+    instance.state.logoHeight = requestData->logoCharacterHeight + options->paddingTop;
 
-    ffLogoPrintChars(content.chars, false);
+    //Go to upper left corner
+    printf("\e[1G\e[%uA", instance.state.logoHeight);
     return true;
 }
 
-static bool printCachedPixel(FFLogoRequestData* requestData)
+static bool printCached(FFLogoRequestData* requestData)
 {
-    requestData->logoCharacterWidth = instance.config.logo.width;
-    if(requestData->logoCharacterWidth == 0)
-    {
-        requestData->logoCharacterWidth = readCachedUint32(requestData, FF_CACHE_FILE_WIDTH);
-        if(requestData->logoCharacterWidth == 0)
-            return false;
-    }
-
-    requestData->logoCharacterHeight = instance.config.logo.height;
-    if(requestData->logoCharacterHeight == 0)
-    {
-        requestData->logoCharacterHeight = readCachedUint32(requestData, FF_CACHE_FILE_HEIGHT);
-        if(requestData->logoCharacterHeight == 0)
-            return false;
-    }
+    #ifndef _WIN32
+    int fd = open(requestData->cachePath.chars, O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+        return false;
 
-    int fd = -1;
-    if(requestData->type == FF_LOGO_TYPE_IMAGE_KITTY)
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size <= 0)
     {
-        fd = getCacheFD(requestData, FF_CACHE_FILE_KITTY_COMPRESSED);
-        if(fd == -1)
-            fd = getCacheFD(requestData, FF_CACHE_FILE_KITTY_UNCOMPRESSED);
-    }
-    else if(requestData->type == FF_LOGO_TYPE_IMAGE_SIXEL)
-        fd = getCacheFD(requestData, FF_CACHE_FILE_SIXEL);
-
-    if(fd == -1)
+        close(fd);
         return false;
+    }
 
-    ffPrintCharTimes('\n', instance.config.logo.paddingTop);
-    ffPrintCharTimes(' ', instance.config.logo.paddingLeft);
-    fflush(stdout);
-
-    char buffer[32768];
-    ssize_t readBytes;
-    while((readBytes = ffReadFDData(FFUnixFD2NativeFD(fd), sizeof(buffer), buffer)) > 0)
-        ffWriteFDData(FFUnixFD2NativeFD(STDOUT_FILENO), (size_t) readBytes, buffer);
-
+    size_t size = (size_t) st.st_size;
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
     close(fd);
+    if(data == MAP_FAILED)
+        return false;
 
-    instance.state.logoWidth = requestData->logoCharacterWidth + instance.config.logo.paddingLeft + instance.config.logo.paddingRight;
-    instance.state.logoHeight = requestData->logoCharacterHeight + instance.config.logo.paddingTop;
-
-    //Go to upper left corner
-    printf("\e[1G\e[%uA", instance.state.logoHeight);
-    return true;
+    bool result = printCachedRecord(requestData, data, size);
+    munmap(data, size);
+    return result;
+    #else
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+    if(!ffReadFileBuffer(requestData->cachePath.chars, &content))
+        return false;
+    return printCachedRecord(requestData, content.chars, content.length);
+    #endif
 }
 
-static bool printCached(FFLogoRequestData* requestData)
+// Hash of the image content and everything that affects the rendered output
+static bool getCacheKey(const FFLogoRequestData* requestData, uint64_t* key)
 {
+    FF_STRBUF_AUTO_DESTROY content = ffStrbufCreate();
+    if(!ffReadFileBuffer(instance.config.logo.source.chars, &content) || content.length == 0)
+        return false;
+
+    const FFOptionsLogo* options = &instance.config.logo;
+    struct
+    {
+        uint32_t version;
+        uint32_t type;
+        double characterPixelWidth;
+        double characterPixelHeight;
+        uint32_t logoPixelWidth;
+        uint32_t logoPixelHeight;
+        uint32_t chafaCanvasMode;
+        uint32_t chafaColorSpace;
+        uint32_t chafaDitherMode;
+        uint32_t chafaFgOnly;
+    } params;
+    memset(&params, 0, sizeof(params)); // No garbage in padding bytes
+    params.version = FF_CACHE_VERSION;
+    params.type = (uint32_t) requestData->type;
+    params.characterPixelWidth = requestData->characterPixelWidth;
+    params.characterPixelHeight = requestData->characterPixelHeight;
+    params.logoPixelWidth = requestData->logoPixelWidth;
+    params.logoPixelHeight = requestData->logoPixelHeight;
     if(requestData->type == FF_LOGO_TYPE_IMAGE_CHAFA)
-        return printCachedChars(requestData);
-    else
-        return printCachedPixel(requestData);
+    {
+        params.chafaCanvasMode = options->chafaCanvasMode;
+        params.chafaColorSpace = options->chafaColorSpace;
+        params.chafaDitherMode = options->chafaDitherMode;
+        params.chafaFgOnly = options->chafaFgOnly;
+    }
+
+    uint64_t hash = ffHashFnv1aAppend(FF_HASH_FNV1A_INIT, content.chars, content.length);
+    hash = ffHashFnv1aAppend(hash, &params, sizeof(params));
+    if(requestData->type == FF_LOGO_TYPE_IMAGE_CHAFA)
+        hash = ffHashFnv1aAppend(hash, options->chafaSymbols.chars, options->chafaSymbols.length);
+    *key = hash;
+    return true;
 }
 
 static bool getCharacterPixelDimensions(FFLogoRequestData* requestData)
@@ -750,15 +864,11 @@ static bool getCharacterPixelDimensions(FFLogoRequestData* requestData)
 
     ioctl(STDOUT_FILENO, TIOCGWINSZ, &winsize);
 
-    if(winsize.ws_row == 0 || winsize.ws_col == 0)
-        ffGetTerminalResponse("\033[18t", "\033[8;%hu;%hut", &winsize.ws_row, &winsize.ws_col);
+    ffGetTerminalWinsize(&winsize);
 
     if(winsize.ws_row == 0 || winsize.ws_col == 0)
         return false;
 
-    if(winsize.ws_ypixel == 0 || winsize.ws_xpixel == 0)
-        ffGetTerminalResponse("\033[14t", "\033[4;%hu;%hut", &winsize.ws_ypixel, &winsize.ws_xpixel);
-
     requestData->characterPixelWidth = winsize.ws_xpixel / (double) winsize.ws_col;
     requestData->characterPixelHeight = winsize.ws_ypixel / (double) winsize.ws_row;
 
@@ -793,26 +903,20 @@ static bool printImageIfExistsSlowPath(FFLogoType type, bool printError)
     requestData.logoPixelWidth = (uint32_t) ceil((double) instance.config.logo.width * requestData.characterPixelWidth);
     requestData.logoPixelHeight = (uint32_t) ceil((double) instance.config.logo.height * requestData.characterPixelHeight);
 
-    ffStrbufInit(&requestData.cacheDir);
-    ffStrbufAppend(&requestData.cacheDir, &instance.state.platform.cacheDir);
-    ffStrbufAppendS(&requestData.cacheDir, "fastfetch/images");
-
-    ffStrbufEnsureFree(&requestData.cacheDir, PATH_MAX);
-    if(realpath(instance.config.logo.source.chars, requestData.cacheDir.chars + requestData.cacheDir.length) == NULL)
+    if(!getCacheKey(&requestData, &requestData.cacheKey))
     {
-        //We can safely return here, because if realpath failed, we surely won't be able to read the file
-        ffStrbufDestroy(&requestData.cacheDir);
+        //We can safely return here, because if we can't read the file, Image Magick won't either
         if(printError)
-            fputs("Logo: Querying realpath of the image source failed\n", stderr);
+            fputs("Logo: Reading the image source failed\n", stderr);
         return false;
     }
-    ffStrbufRecalculateLength(&requestData.cacheDir);
-    ffStrbufEnsureEndsWithC(&requestData.cacheDir, '/');
-    ffStrbufAppendF(&requestData.cacheDir, "%u*%u/", requestData.logoPixelWidth, requestData.logoPixelHeight);
+
+    ffStrbufInitS(&requestData.cachePath, instance.state.platform.cacheDir.chars);
+    ffStrbufAppendF(&requestData.cachePath, "fastfetch/images/%016" PRIx64, requestData.cacheKey);
 
     if(!instance.config.logo.recache && printCached(&requestData))
     {
-        ffStrbufDestroy(&requestData.cacheDir);
+        ffStrbufDestroy(&requestData.cachePath);
         return true;
     }
 
@@ -827,7 +931,7 @@ static bool printImageIfExistsSlowPath(FFLogoType type, bool printError)
             result = ffLogoPrintImageIM6(&requestData);
     #endif
 
-    ffStrbufDestroy(&requestData.cacheDir);
+    ffStrbufDestroy(&requestData.cachePath);
 
     if(result == FF_LOGO_IMAGE_RESULT_SUCCESS)
         return true;
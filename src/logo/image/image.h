@@ -14,7 +14,8 @@ typedef enum FFLogoImageResult
 typedef struct FFLogoRequestData
 {
     FFLogoType type;
-    FFstrbuf cacheDir;
+    FFstrbuf cachePath;
+    uint64_t cacheKey;
 
     double characterPixelWidth;
     double characterPixelHeight;
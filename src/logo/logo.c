@@ -5,16 +5,16 @@
 #include "detection/terminalshell/terminalshell.h"
 #include "util/textModifier.h"
 #include "util/stringUtils.h"
+#include "util/wcwidth.h"
 
 #include <ctype.h>
 #include <string.h>
 
-typedef enum FFLogoSize
-{
-    FF_LOGO_SIZE_UNKNOWN,
-    FF_LOGO_SIZE_NORMAL,
-    FF_LOGO_SIZE_SMALL,
-} FFLogoSize;
+#if defined(__SSE2__) || defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
 
 static void ffLogoPrintCharsRaw(const char* data, size_t length)
 {
@@ -53,6 +53,67 @@ static void ffLogoPrintCharsRaw(const char* data, size_t length)
     }
 }
 
+// Length of the run at `data` that needs no special handling: printable ASCII, except `$` when colors are replaced.
+// Scans 16 (or 32 with AVX2) bytes at a time
+static uint32_t logoScanPlain(const char* data, const char* end, bool stopAtDollar)
+{
+    const char* p = data;
+
+    #if defined(__AVX2__)
+    const __m256i space32 = _mm256_set1_epi8(' ');
+    const __m256i dollar32 = _mm256_set1_epi8('$');
+    for(; end - p >= 32; p += 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*) p);
+        // Control chars and non-ASCII bytes (negative as signed chars) compare less than the space
+        __m256i special = _mm256_cmpgt_epi8(space32, v);
+        if(stopAtDollar)
+            special = _mm256_or_si256(special, _mm256_cmpeq_epi8(v, dollar32));
+        uint32_t mask = (uint32_t) _mm256_movemask_epi8(special);
+        if(mask)
+            return (uint32_t) (p - data) + (uint32_t) __builtin_ctz(mask);
+    }
+    #endif
+
+    #if defined(__SSE2__)
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i dollar = _mm_set1_epi8('$');
+    for(; end - p >= 16; p += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*) p);
+        __m128i special = _mm_cmpgt_epi8(space, v);
+        if(stopAtDollar)
+            special = _mm_or_si128(special, _mm_cmpeq_epi8(v, dollar));
+        uint32_t mask = (uint32_t) _mm_movemask_epi8(special);
+        if(mask)
+            return (uint32_t) (p - data) + (uint32_t) __builtin_ctz(mask);
+    }
+    #elif defined(__aarch64__) && defined(__ARM_NEON)
+    const uint8x16_t space = vdupq_n_u8(' ');
+    const uint8x16_t high = vdupq_n_u8(0x80);
+    const uint8x16_t dollar = vdupq_n_u8(stopAtDollar ? '$' : ' ');
+    for(; end - p >= 16; p += 16)
+    {
+        uint8x16_t v = vld1q_u8((const uint8_t*) p);
+        uint8x16_t special = vorrq_u8(vorrq_u8(vcltq_u8(v, space), vcgeq_u8(v, high)), vceqq_u8(v, dollar));
+        if(vmaxvq_u8(special))
+            break; // Locate it with the scalar loop
+    }
+    #endif
+
+    while(p < end && (uint8_t) *p >= ' ' && (uint8_t) *p < 0x80 && !(stopAtDollar && *p == '$'))
+        ++p;
+    return (uint32_t) (p - data);
+}
+
+// Expands a color placeholder. Called for every `$N` of a logo, so avoid the printf machinery
+static inline void logoAppendColor(FFstrbuf* result, const FFstrbuf* color)
+{
+    ffStrbufAppendS(result, "\e[");
+    ffStrbufAppend(result, color);
+    ffStrbufAppendC(result, 'm');
+}
+
 void ffLogoPrintChars(const char* data, bool doColorReplacement)
 {
     FFOptionsLogo* options = &instance.config.logo;
@@ -71,10 +132,24 @@ void ffLogoPrintChars(const char* data, bool doColorReplacement)
 
     //Use logoColor[0] as the default color
     if(doColorReplacement && !instance.config.display.pipe)
-        ffStrbufAppendF(&result, "\e[%sm", options->colors[0].chars);
+        logoAppendColor(&result, &options->colors[0]);
+
+    const char* end = data + strlen(data);
+    ffStrbufEnsureFree(&result, (uint32_t) (end - data));
 
-    while(*data != '\0')
+    while(data < end)
     {
+        //Copy printable ASCII in bulk. Each of these chars takes exactly one column
+        uint32_t plain = logoScanPlain(data, end, doColorReplacement);
+        if(plain > 0)
+        {
+            ffStrbufAppendNS(&result, plain, data);
+            currentlineLength += plain;
+            data += plain;
+            if(data == end)
+                break;
+        }
+
         //We are at the end of a line. Print paddings and update max line length
         if(*data == '\n' || (*data == '\r' && *(data + 1) == '\n'))
         {
@@ -101,6 +176,7 @@ void ffLogoPrintChars(const char* data, bool doColorReplacement)
         if(*data == '\t')
         {
             ffStrbufAppendNC(&result, 4, ' ');
+            currentlineLength += 4;
             ++data;
             continue;
         }
@@ -109,24 +185,26 @@ void ffLogoPrintChars(const char* data, bool doColorReplacement)
         if(*data == '\e' && *(data + 1) == '[')
         {
             const char* start = data;
-
-            ffStrbufAppendS(&result, "\e[");
             data += 2;
 
             while(isdigit(*data) || *data == ';')
-                ffStrbufAppendC(&result, *data++); // number
+                ++data; // number
 
             //We have a valid control sequence, print it and continue with next char
-            if(isascii(*data))
+            if(isascii(*data) && *data != '\0')
             {
-                ffStrbufAppendC(&result, *data++); // single letter, end of control sequence
+                ++data; // single letter, end of control sequence
+                ffStrbufAppendNS(&result, (uint32_t) (data - start), start);
                 continue;
             }
 
             //Invalid control sequence, try to get most accurate length
+            ffStrbufAppendNS(&result, (uint32_t) (data - start), start);
             currentlineLength += (uint32_t) (data - start - 1); //-1 for \033 which for sure doesn't take any space
 
             //Don't continue here, print the char after the letters with the unicode printing
+            if(data == end)
+                break;
         }
 
         //We have a fastfetch color placeholder. Replace it with the esacape sequence, don't increase the line length
@@ -139,7 +217,8 @@ void ffLogoPrintChars(const char* data, bool doColorReplacement)
             {
                 ffStrbufAppendC(&result, '$');
                 ++currentlineLength;
-                ++data;
+                if(*data == '$')
+                    ++data;
                 continue;
             }
 
@@ -157,7 +236,7 @@ void ffLogoPrintChars(const char* data, bool doColorReplacement)
                 }
                 else
                 {
-                    ffStrbufAppendF(&result, "\e[%sm", options->colors[index].chars);
+                    logoAppendColor(&result, &options->colors[index]);
                     ++data;
                     continue;
                 }
@@ -170,30 +249,14 @@ void ffLogoPrintChars(const char* data, bool doColorReplacement)
         }
 
         //Do the printing, respecting unicode
-
-        ++currentlineLength;
-
-        int codepoint = (unsigned char) *data;
-        uint8_t bytes;
-
-        if(codepoint <= 127)
-            bytes = 1;
-        else if((codepoint & 0xE0) == 0xC0)
-            bytes = 2;
-        else if((codepoint & 0xF0) == 0xE0)
-            bytes = 3;
-        else if((codepoint & 0xF8) == 0xF0)
-            bytes = 4;
-        else
-            bytes = 1; //Invalid utf8, print it as is, byte by byte
-
-        for(uint8_t i = 0; i < bytes; ++i)
-        {
-            if(*data == '\0')
-                break;
-
-            ffStrbufAppendC(&result, *data++);
-        }
+        uint32_t codepoint;
+        uint32_t bytes = ffUtf8Decode(data, (uint32_t) (end - data), &codepoint);
+        int width = ffWcwidth(codepoint);
+        if(width > 0)
+            currentlineLength += (uint32_t) width;
+
+        ffStrbufAppendNS(&result, bytes, data);
+        data += bytes;
     }
 
     if(!instance.config.display.pipe)
@@ -228,50 +291,73 @@ static void logoApplyColors(const FFlogo* logo)
         ffStrbufAppendS(&instance.config.display.colorKeys, logo->colorKeys ? logo->colorKeys : logo->colors[1]);
 }
 
-static bool logoHasName(const FFlogo* logo, const FFstrbuf* name, bool small)
+static bool logoMatchesSize(const FFlogo* logo, FFLogoSize size)
 {
-    for(
-        const char* const* logoName = logo->names;
-        *logoName != NULL && logoName <= &logo->names[FASTFETCH_LOGO_MAX_NAMES];
-        ++logoName
-    ) {
-        if(small)
-        {
-            uint32_t logoNameLength = (uint32_t) (strlen(*logoName) - strlen("_small"));
-            if(name->length == logoNameLength && strncasecmp(*logoName, name->chars, logoNameLength) == 0) return true;
-        }
-        if(ffStrbufIgnCaseEqualS(name, *logoName))
+    switch (size)
+    {
+        // Never use alternate logos
+        case FF_LOGO_SIZE_NORMAL:
+            return logo->type == FF_LOGO_LINE_TYPE_NORMAL;
+        case FF_LOGO_SIZE_SMALL:
+            return logo->type == FF_LOGO_LINE_TYPE_SMALL_BIT;
+        default:
             return true;
     }
+}
+
+static inline const FFlogo* logoFromAlias(const FFLogoBuiltinAlias* alias)
+{
+    return &ffLogoBuiltins[alias->letter - 'A'][alias->index];
+}
+
+// Binary search in the generated alias index. Returns the first logo in builtin order with the given (lowercase) name and size
+const FFLogoBuiltinAlias* ffLogoBuiltinFindAlias(const char* name, FFLogoSize size)
+{
+    uint32_t low = 0, high = ffLogoBuiltinAliasCount;
+    while(low < high)
+    {
+        uint32_t mid = low + (high - low) / 2;
+        if(strcmp(ffLogoBuiltinAliases[mid].name, name) < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
 
-    return false;
+    for(; low < ffLogoBuiltinAliasCount && strcmp(ffLogoBuiltinAliases[low].name, name) == 0; ++low)
+    {
+        if(logoMatchesSize(logoFromAlias(&ffLogoBuiltinAliases[low]), size))
+            return &ffLogoBuiltinAliases[low];
+    }
+
+    return NULL;
 }
 
 static const FFlogo* logoGetBuiltin(const FFstrbuf* name, FFLogoSize size)
 {
-    if (name->length == 0 || !isalpha(name->chars[0]))
+    char lowerName[64];
+    if (name->length == 0 || name->length >= sizeof(lowerName) - strlen("_small"))
         return NULL;
 
-    for(const FFlogo* logo = ffLogoBuiltins[toupper(name->chars[0]) - 'A']; *logo->names; ++logo)
+    for(uint32_t i = 0; i < name->length; ++i)
+        lowerName[i] = (char) tolower((unsigned char) name->chars[i]);
+    lowerName[name->length] = '\0';
+
+    const FFLogoBuiltinAlias* result = ffLogoBuiltinFindAlias(lowerName, size);
+
+    if(size == FF_LOGO_SIZE_SMALL)
     {
-        switch (size)
+        // Small logos can be referred to without their `_small` / `-small` suffix
+        static const char* const suffixes[] = { "_small", "-small" };
+        for(uint32_t i = 0; i < sizeof(suffixes) / sizeof(*suffixes); ++i)
         {
-            // Never use alternate logos
-            case FF_LOGO_SIZE_NORMAL:
-                if(logo->type != FF_LOGO_LINE_TYPE_NORMAL) continue;
-                break;
-            case FF_LOGO_SIZE_SMALL:
-                if(logo->type != FF_LOGO_LINE_TYPE_SMALL_BIT) continue;
-                break;
-            default:
-                break;
+            strcpy(lowerName + name->length, suffixes[i]);
+            const FFLogoBuiltinAlias* alias = ffLogoBuiltinFindAlias(lowerName, size);
+            if(alias && (!result || alias->letter < result->letter || (alias->letter == result->letter && alias->index < result->index)))
+                result = alias;
         }
-
-        if(logoHasName(logo, name, size == FF_LOGO_SIZE_SMALL))
-            return logo;
     }
 
-    return NULL;
+    return result ? logoFromAlias(result) : NULL;
 }
 
 static const FFlogo* logoGetBuiltinDetected(FFLogoSize size)
@@ -22,12 +22,30 @@ typedef struct FFlogo
     FFLogoLineType type;
 } FFlogo;
 
+typedef enum FFLogoSize
+{
+    FF_LOGO_SIZE_UNKNOWN,
+    FF_LOGO_SIZE_NORMAL,
+    FF_LOGO_SIZE_SMALL,
+} FFLogoSize;
+
+// Entry of the alias index generated from `builtin.c`. `name` is lowercase
+typedef struct FFLogoBuiltinAlias
+{
+    const char* name;
+    char letter;
+    uint16_t index; // into ffLogoBuiltins[letter - 'A']
+} FFLogoBuiltinAlias;
+
 //logo.c
 void ffLogoPrintChars(const char* data, bool doColorReplacement);
+const FFLogoBuiltinAlias* ffLogoBuiltinFindAlias(const char* name, FFLogoSize size);
 
 //builtin.c
 extern const FFlogo* ffLogoBuiltins[];
 extern const FFlogo ffLogoUnknown;
+extern const FFLogoBuiltinAlias ffLogoBuiltinAliases[]; // Sorted by name, then by position
+extern const uint32_t ffLogoBuiltinAliasCount;
 
 //image/image.c
 bool ffLogoPrintImageIfExists(FFLogoType type, bool printError);
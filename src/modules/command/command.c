@@ -1,15 +1,149 @@
 #include "common/printing.h"
 #include "common/jsonconfig.h"
 #include "common/processing.h"
+#include "common/io/io.h"
 #include "modules/command/command.h"
+#include "util/hash.h"
 #include "util/stringUtils.h"
 
+#include <inttypes.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/file.h>
+#endif
+
 #define FF_COMMAND_NUM_FORMAT_ARGS 1
 
-void ffPrintCommand(FFCommandOptions* options)
+// A command started in the prepare pass, whose output is collected when the module is printed
+typedef struct FFCommandPending
 {
-    FF_STRBUF_AUTO_DESTROY result = ffStrbufCreate();
-    const char* error = ffProcessAppendStdOut(&result, (char* const[]){
+    FFstrbuf shell;
+    FFstrbuf text;
+    FFstrbuf cached; // Output read from the cache in the prepare pass; no child is started then
+    FFProcessHandle handle;
+    const char* error;
+    bool spawned;
+    bool consumed;
+} FFCommandPending;
+
+static FFlist pendings = { .elementSize = sizeof(FFCommandPending) };
+
+static void getCachePath(const FFCommandOptions* options, FFstrbuf* path)
+{
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, sizeof(cwd)))
+        cwd[0] = '\0';
+
+    // Shell, text and working directory, each including its NUL terminator
+    uint64_t hash = FF_HASH_FNV1A_INIT;
+    hash = ffHashFnv1aAppend(hash, options->shell.chars, options->shell.length + 1);
+    hash = ffHashFnv1aAppend(hash, options->text.chars, options->text.length + 1);
+    hash = ffHashFnv1aAppend(hash, cwd, strlen(cwd) + 1);
+
+    ffStrbufSet(path, &instance.state.platform.cacheDir);
+    ffStrbufAppendF(path, "fastfetch/command/%016" PRIx64, hash);
+}
+
+// Returns false if there is no cached output. The mtime of the cache file is the time the output was produced
+static bool readCache(const FFCommandOptions* options, const FFstrbuf* path, FFstrbuf* result, bool* stale)
+{
+    struct stat st;
+    if (stat(path->chars, &st) != 0 || !ffReadFileBuffer(path->chars, result))
+        return false;
+
+    ffStrbufTrimRightSpace(result);
+    if (result->length == 0)
+        return false;
+
+    *stale = time(NULL) - st.st_mtime >= (time_t) options->cacheTtl;
+    return true;
+}
+
+#ifndef _WIN32
+// Returns a locked fd, or -1 if another refresh of the same cache entry holds the lock. The kernel releases it when the holder exits
+static int lockRefresh(const FFstrbuf* path)
+{
+    FF_STRBUF_AUTO_DESTROY lockPath = ffStrbufCreateF("%s.lock", path->chars);
+    int fd = open(lockPath.chars, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return -1;
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+#endif
+
+static void revalidateCache(const FFCommandOptions* options, const FFstrbuf* path)
+{
+    #ifndef _WIN32
+    // Stale-while-revalidate: fastfetch is re-executed detached, runs the command and replaces the cache file when it's done, after we have exited.
+    // No fork(): we are multithreaded, and only async-signal-safe calls may follow it
+    if (instance.state.platform.exePath.length == 0)
+        return;
+
+    // Don't start another refresh while one is running
+    int lockFd = lockRefresh(path);
+    if (lockFd < 0)
+        return;
+    close(lockFd);
+
+    ffProcessSpawnDetached((char* const[]) {
+        instance.state.platform.exePath.chars,
+        FF_COMMAND_REFRESH_COMMAND,
+        path->chars,
+        options->shell.chars,
+        options->text.chars,
+        NULL,
+    });
+    #else
+    FF_UNUSED(options, path);
+    #endif
+}
+
+#ifndef _WIN32
+// argv: fastfetch FF_COMMAND_REFRESH_COMMAND <cache path> <shell> <text>
+int ffCommandRefreshCacheMain(int argc, char** argv)
+{
+    if (argc != 5)
+        return 1;
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreateS(argv[2]);
+    FF_AUTO_CLOSE_FD int lockFd = lockRefresh(&path);
+    if (lockFd < 0)
+        return 0; // Another refresh is running
+
+    // Nobody is waiting for the output, so a slow command doesn't need to be cut short
+    instance.config.general.processingTimeout = -1;
+
+    FF_STRBUF_AUTO_DESTROY output = ffStrbufCreate();
+    FFProcessRequest request = {
+        .argv = (char* const[]) { argv[3], "-c", argv[4], NULL },
+        .buffer = &output,
+    };
+    ffProcessAppendOutputs(&request, 1);
+
+    // Keep the old output rather than caching the result of a failed run
+    if (request.error || request.exitStatus != 0)
+        return 1;
+
+    ffStrbufTrimRightSpace(&output);
+    if (output.length == 0)
+        return 1;
+    return ffWriteFileBufferAtomic(path.chars, &output) ? 0 : 1;
+}
+#endif
+
+static void spawnCommand(const FFCommandOptions* options, FFProcessHandle* handle, const char** error)
+{
+    *error = ffProcessSpawn((char* const[]){
         options->shell.chars,
         #ifdef _WIN32
         "/c",
@@ -18,7 +152,121 @@ void ffPrintCommand(FFCommandOptions* options)
         #endif
         options->text.chars,
         NULL
-    });
+    }, false, handle);
+}
+
+void ffPrepareCommand(FFCommandOptions* options)
+{
+    if (options->text.length == 0)
+        return;
+
+    FFCommandPending* pending = (FFCommandPending*) ffListAdd(&pendings);
+    ffStrbufInitCopy(&pending->shell, &options->shell);
+    ffStrbufInitCopy(&pending->text, &options->text);
+    ffStrbufInit(&pending->cached);
+    pending->error = NULL;
+    pending->spawned = pending->consumed = false;
+
+    if (options->cacheTtl > 0)
+    {
+        FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+        getCachePath(options, &path);
+
+        bool stale;
+        if (readCache(options, &path, &pending->cached, &stale))
+        {
+            #ifndef _WIN32
+            if (stale) revalidateCache(options, &path);
+            return;
+            #else
+            if (!stale) return;
+            ffStrbufClear(&pending->cached);
+            #endif
+        }
+    }
+
+    spawnCommand(options, &pending->handle, &pending->error);
+    pending->spawned = true;
+}
+
+static const char* getCommandResult(FFCommandOptions* options, FFstrbuf* result)
+{
+    FFCommandPending* pending = NULL;
+    FF_LIST_FOR_EACH(FFCommandPending, item, pendings)
+    {
+        if (item->consumed || !ffStrbufEqual(&item->shell, &options->shell) || !ffStrbufEqual(&item->text, &options->text))
+            continue;
+        pending = item;
+        pending->consumed = true;
+        break;
+    }
+
+    FF_STRBUF_AUTO_DESTROY path = ffStrbufCreate();
+    if (options->cacheTtl > 0)
+        getCachePath(options, &path);
+
+    const char* error;
+    if (pending)
+    {
+        if (!pending->spawned)
+        {
+            ffStrbufSet(result, &pending->cached);
+            return NULL;
+        }
+        if (pending->error)
+        {
+            error = pending->error;
+            ffProcessDiscard(&pending->handle);
+        }
+        else
+            error = ffProcessReadOutput(&pending->handle, result);
+    }
+    else
+    {
+        bool stale;
+        if (options->cacheTtl > 0 && readCache(options, &path, result, &stale))
+        {
+            #ifndef _WIN32
+            if (stale) revalidateCache(options, &path);
+            return NULL;
+            #else
+            if (!stale) return NULL;
+            ffStrbufClear(result);
+            #endif
+        }
+
+        FFProcessHandle handle;
+        spawnCommand(options, &handle, &error);
+        if (!error) error = ffProcessReadOutput(&handle, result);
+    }
+
+    if (error)
+        return error;
+
+    ffStrbufTrimRightSpace(result);
+    if (options->cacheTtl > 0 && result->length > 0)
+        ffWriteFileBufferAtomic(path.chars, result);
+    return NULL;
+}
+
+// Kills and reaps the children of commands that were started in the prepare pass but never printed
+static void releasePendings(void)
+{
+    FF_LIST_FOR_EACH(FFCommandPending, item, pendings)
+    {
+        if (item->spawned && !item->consumed)
+            ffProcessDiscard(&item->handle);
+        ffStrbufDestroy(&item->shell);
+        ffStrbufDestroy(&item->text);
+        ffStrbufDestroy(&item->cached);
+    }
+    ffListDestroy(&pendings);
+}
+
+void ffPrintCommand(FFCommandOptions* options)
+{
+    FF_STRBUF_AUTO_DESTROY result = ffStrbufCreate();
+    const char* error = getCommandResult(options, &result);
 
     if(error)
     {
@@ -64,6 +312,12 @@ bool ffParseCommandCommandOptions(FFCommandOptions* options, const char* key, co
         return true;
     }
 
+    if(ffStrEqualsIgnCase(subKey, "cache-ttl"))
+    {
+        options->cacheTtl = ffOptionParseUInt32(key, value);
+        return true;
+    }
+
     return false;
 }
 
@@ -92,6 +346,12 @@ void ffParseCommandJsonObject(FFCommandOptions* options, yyjson_val* module)
             continue;
         }
 
+        if (ffStrEqualsIgnCase(key, "cacheTtl"))
+        {
+            options->cacheTtl = (uint32_t) yyjson_get_uint(val);
+            continue;
+        }
+
         ffPrintError(FF_COMMAND_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, "Unknown JSON key %s", key);
     }
 }
@@ -108,21 +368,15 @@ void ffGenerateCommandJsonConfig(FFCommandOptions* options, yyjson_mut_doc* doc,
 
     if (!ffStrbufEqual(&defaultOptions.text, &options->text))
         yyjson_mut_obj_add_strbuf(doc, module, "text", &options->text);
+
+    if (defaultOptions.cacheTtl != options->cacheTtl)
+        yyjson_mut_obj_add_uint(doc, module, "cacheTtl", options->cacheTtl);
 }
 
 void ffGenerateCommandJsonResult(FF_MAYBE_UNUSED FFCommandOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module)
 {
     FF_STRBUF_AUTO_DESTROY result = ffStrbufCreate();
-    const char* error = ffProcessAppendStdOut(&result, (char* const[]){
-        options->shell.chars,
-        #ifdef _WIN32
-        "/c",
-        #else
-        "-c",
-        #endif
-        options->text.chars,
-        NULL
-    });
+    const char* error = getCommandResult(options, &result);
 
     if(error)
     {
@@ -170,10 +424,14 @@ void ffInitCommandOptions(FFCommandOptions* options)
     );
 
     ffStrbufInit(&options->text);
+    options->cacheTtl = 0;
 }
 
 void ffDestroyCommandOptions(FFCommandOptions* options)
 {
+    // Command options are also created and destroyed temporarily; the pending list lives as long as the global ones
+    if (options == &instance.config.modules.command)
+        releasePendings();
     ffOptionDestroyModuleArg(&options->moduleArgs);
     ffStrbufDestroy(&options->shell);
     ffStrbufDestroy(&options->text);
@@ -4,6 +4,13 @@
 
 #define FF_COMMAND_MODULE_NAME "Command"
 
+void ffPrepareCommand(FFCommandOptions* options);
 void ffPrintCommand(FFCommandOptions* options);
 void ffInitCommandOptions(FFCommandOptions* options);
 void ffDestroyCommandOptions(FFCommandOptions* options);
+
+#ifndef _WIN32
+// The process that refreshes a stale cache entry: fastfetch re-executed as `fastfetch FF_COMMAND_REFRESH_COMMAND <args>`. Returns the exit code
+#define FF_COMMAND_REFRESH_COMMAND "--internal-refresh-command-cache"
+int ffCommandRefreshCacheMain(int argc, char** argv);
+#endif
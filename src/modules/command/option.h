@@ -11,4 +11,5 @@ typedef struct FFCommandOptions
 
     FFstrbuf shell;
     FFstrbuf text;
+    uint32_t cacheTtl; // In seconds, 0 to disable
 } FFCommandOptions;
@@ -73,6 +73,8 @@ static void printDisk(FFDiskOptions* options, const FFDisk* disk)
                 ffStrbufAppendC(&str, ' ');
             }
         }
+        else if(disk->type & FF_DISK_VOLUME_TYPE_UNRESPONSIVE_BIT)
+            ffStrbufAppendS(&str, "Unresponsive ");
         else
             ffStrbufAppendS(&str, "Unknown ");
 
@@ -227,6 +229,21 @@ bool ffParseDiskCommandOptions(FFDiskOptions* options, const char* key, const ch
         return true;
     }
 
+    if (ffStrEqualsIgnCase(subKey, "show-unresponsive"))
+    {
+        if (ffOptionParseBoolean(value))
+            options->showTypes |= FF_DISK_VOLUME_TYPE_UNRESPONSIVE_BIT;
+        else
+            options->showTypes &= ~FF_DISK_VOLUME_TYPE_UNRESPONSIVE_BIT;
+        return true;
+    }
+
+    if (ffStrEqualsIgnCase(subKey, "timeout"))
+    {
+        options->timeout = ffOptionParseUInt32(key, value);
+        return true;
+    }
+
     if (ffStrEqualsIgnCase(subKey, "use-available"))
     {
         if (ffOptionParseBoolean(value))
@@ -306,6 +323,21 @@ void ffParseDiskJsonObject(FFDiskOptions* options, yyjson_val* module)
             continue;
         }
 
+        if (ffStrEqualsIgnCase(key, "showUnresponsive"))
+        {
+            if (yyjson_get_bool(val))
+                options->showTypes |= FF_DISK_VOLUME_TYPE_UNRESPONSIVE_BIT;
+            else
+                options->showTypes &= ~FF_DISK_VOLUME_TYPE_UNRESPONSIVE_BIT;
+            continue;
+        }
+
+        if (ffStrEqualsIgnCase(key, "timeout"))
+        {
+            options->timeout = (uint32_t) yyjson_get_uint(val);
+            continue;
+        }
+
         if (ffStrEqualsIgnCase(key, "useAvailable"))
         {
             if (yyjson_get_bool(val))
@@ -345,6 +377,9 @@ void ffGenerateDiskJsonConfig(FFDiskOptions* options, yyjson_mut_doc* doc, yyjso
 
         if (options->showTypes & FF_DISK_VOLUME_TYPE_UNKNOWN_BIT)
             yyjson_mut_obj_add_bool(doc, module, "showUnknown", true);
+
+        if ((options->showTypes ^ defaultOptions.showTypes) & FF_DISK_VOLUME_TYPE_UNRESPONSIVE_BIT)
+            yyjson_mut_obj_add_bool(doc, module, "showUnresponsive", !!(options->showTypes & FF_DISK_VOLUME_TYPE_UNRESPONSIVE_BIT));
     }
 
     if (!ffStrbufEqual(&options->folders, &defaultOptions.folders))
@@ -354,6 +389,9 @@ void ffGenerateDiskJsonConfig(FFDiskOptions* options, yyjson_mut_doc* doc, yyjso
         yyjson_mut_obj_add_bool(doc, module, "useAvailable", options->calcType == FF_DISK_CALC_TYPE_AVAILABLE);
 
     ffPercentGenerateJsonConfig(doc, module, defaultOptions.percent, options->percent);
+
+    if (defaultOptions.timeout != options->timeout)
+        yyjson_mut_obj_add_uint(doc, module, "timeout", options->timeout);
 }
 
 void ffGenerateDiskJsonResult(FFDiskOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module)
@@ -408,6 +446,8 @@ void ffGenerateDiskJsonResult(FFDiskOptions* options, yyjson_mut_doc* doc, yyjso
             yyjson_mut_arr_add_str(doc, typeArr, "Read-only");
         if(item->type & FF_DISK_VOLUME_TYPE_UNKNOWN_BIT)
             yyjson_mut_arr_add_str(doc, typeArr, "Unknown");
+        if(item->type & FF_DISK_VOLUME_TYPE_UNRESPONSIVE_BIT)
+            yyjson_mut_arr_add_str(doc, typeArr, "Unresponsive");
 
         const char* pstr = ffTimeToFullStr(item->createTime);
         if (*pstr)
@@ -459,9 +499,10 @@ void ffInitDiskOptions(FFDiskOptions* options)
     ffOptionInitModuleArg(&options->moduleArgs);
 
     ffStrbufInit(&options->folders);
-    options->showTypes = FF_DISK_VOLUME_TYPE_REGULAR_BIT | FF_DISK_VOLUME_TYPE_EXTERNAL_BIT | FF_DISK_VOLUME_TYPE_READONLY_BIT;
+    options->showTypes = FF_DISK_VOLUME_TYPE_REGULAR_BIT | FF_DISK_VOLUME_TYPE_EXTERNAL_BIT | FF_DISK_VOLUME_TYPE_READONLY_BIT | FF_DISK_VOLUME_TYPE_UNRESPONSIVE_BIT;
     options->calcType = FF_DISK_CALC_TYPE_FREE;
     options->percent = (FFColorRangeConfig) { 50, 80 };
+    options->timeout = 1000;
 }
 
 void ffDestroyDiskOptions(FFDiskOptions* options)
@@ -14,6 +14,7 @@ typedef enum FFDiskVolumeType
     FF_DISK_VOLUME_TYPE_SUBVOLUME_BIT = 1 << 3,
     FF_DISK_VOLUME_TYPE_UNKNOWN_BIT = 1 << 4,
     FF_DISK_VOLUME_TYPE_READONLY_BIT = 1 << 5,
+    FF_DISK_VOLUME_TYPE_UNRESPONSIVE_BIT = 1 << 6,
 } FFDiskVolumeType;
 
 typedef enum FFDiskCalcType
@@ -31,4 +32,5 @@ typedef struct FFDiskOptions
     FFDiskVolumeType showTypes;
     FFDiskCalcType calcType;
     FFColorRangeConfig percent;
+    uint32_t timeout;
 } FFDiskOptions;
@@ -10,7 +10,7 @@
 
 #include <stdlib.h>
 
-#define FF_GPU_NUM_FORMAT_ARGS 12
+#define FF_GPU_NUM_FORMAT_ARGS 14
 
 static void printGPUResult(FFGPUOptions* options, uint8_t index, const FFGPUResult* gpu)
 {
@@ -48,6 +48,12 @@ static void printGPUResult(FFGPUOptions* options, uint8_t index, const FFGPUResu
             ffTempsAppendNum(gpu->temperature, &output, options->tempConfig, &options->moduleArgs);
         }
 
+        if(gpu->usage == gpu->usage) //FF_GPU_USAGE_UNSET
+        {
+            ffStrbufAppendS(&output, " - ");
+            ffPercentAppendNum(&output, gpu->usage, options->percent, false, &options->moduleArgs);
+        }
+
         if(gpu->dedicated.total != FF_GPU_VMEM_SIZE_UNSET && gpu->dedicated.total != 0)
         {
             ffStrbufAppendS(&output, " (");
@@ -75,6 +81,12 @@ static void printGPUResult(FFGPUOptions* options, uint8_t index, const FFGPUResu
     {
         FF_STRBUF_AUTO_DESTROY tempStr = ffStrbufCreate();
         ffTempsAppendNum(gpu->temperature, &tempStr, options->tempConfig, &options->moduleArgs);
+        FF_STRBUF_AUTO_DESTROY usageStr = ffStrbufCreate();
+        if(gpu->usage == gpu->usage)
+            ffPercentAppendNum(&usageStr, gpu->usage, options->percent, false, &options->moduleArgs);
+        FF_STRBUF_AUTO_DESTROY memoryBandwidthUsageStr = ffStrbufCreate();
+        if(gpu->memoryBandwidthUsage == gpu->memoryBandwidthUsage)
+            ffPercentAppendNum(&memoryBandwidthUsageStr, gpu->memoryBandwidthUsage, options->percent, false, &options->moduleArgs);
         FF_PRINT_FORMAT_CHECKED(FF_GPU_MODULE_NAME, index, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, FF_GPU_NUM_FORMAT_ARGS, ((FFformatarg[]) {
             {FF_FORMAT_ARG_TYPE_STRBUF, &gpu->vendor},
             {FF_FORMAT_ARG_TYPE_STRBUF, &gpu->name},
@@ -88,6 +100,8 @@ static void printGPUResult(FFGPUOptions* options, uint8_t index, const FFGPUResu
             {FF_FORMAT_ARG_TYPE_UINT64, &gpu->shared.used},
             {FF_FORMAT_ARG_TYPE_STRBUF, &gpu->platformApi},
             {FF_FORMAT_ARG_TYPE_DOUBLE, &gpu->frequency},
+            {FF_FORMAT_ARG_TYPE_STRBUF, &usageStr},
+            {FF_FORMAT_ARG_TYPE_STRBUF, &memoryBandwidthUsageStr},
         }));
     }
 }
@@ -159,6 +173,12 @@ bool ffParseGPUCommandOptions(FFGPUOptions* options, const char* key, const char
     if (ffTempsParseCommandOptions(key, subKey, value, &options->temp, &options->tempConfig))
         return true;
 
+    if (ffStrEqualsIgnCase(subKey, "usage"))
+    {
+        options->usage = ffOptionParseBoolean(value);
+        return true;
+    }
+
     if (ffStrEqualsIgnCase(subKey, "hide-type"))
     {
         options->hideType = (FFGPUType) ffOptionParseEnum(key, value, (FFKeyValuePair[]) {
@@ -197,6 +217,12 @@ void ffParseGPUJsonObject(FFGPUOptions* options, yyjson_val* module)
             continue;
         }
 
+        if (ffStrEqualsIgnCase(key, "usage"))
+        {
+            options->usage = yyjson_get_bool(val);
+            continue;
+        }
+
         if (ffStrEqualsIgnCase(key, "detectionMethod"))
         {
             int value;
@@ -247,6 +273,9 @@ void ffGenerateGPUJsonConfig(FFGPUOptions* options, yyjson_mut_doc* doc, yyjson_
     if (options->driverSpecific != defaultOptions.driverSpecific)
         yyjson_mut_obj_add_bool(doc, module, "driverSpecific", options->driverSpecific);
 
+    if (options->usage != defaultOptions.usage)
+        yyjson_mut_obj_add_bool(doc, module, "usage", options->usage);
+
     if (options->detectionMethod != defaultOptions.detectionMethod)
     {
         switch (options->detectionMethod)
@@ -354,6 +383,16 @@ void ffGenerateGPUJsonResult(FFGPUOptions* options, yyjson_mut_doc* doc, yyjson_
             yyjson_mut_obj_add_null(doc, obj, "frequency");
         else
             yyjson_mut_obj_add_real(doc, obj, "frequency", gpu->frequency);
+
+        if (gpu->usage == gpu->usage) //FF_GPU_USAGE_UNSET
+            yyjson_mut_obj_add_real(doc, obj, "usage", gpu->usage);
+        else
+            yyjson_mut_obj_add_null(doc, obj, "usage");
+
+        if (gpu->memoryBandwidthUsage == gpu->memoryBandwidthUsage)
+            yyjson_mut_obj_add_real(doc, obj, "memoryBandwidthUsage", gpu->memoryBandwidthUsage);
+        else
+            yyjson_mut_obj_add_null(doc, obj, "memoryBandwidthUsage");
     }
 
     FF_LIST_FOR_EACH(FFGPUResult, gpu, gpus)
@@ -380,6 +419,8 @@ void ffPrintGPUHelpFormat(void)
         "GPU used shared memory",
         "The platform API that GPU supports",
         "Current frequency in GHz",
+        "GPU usage percentage",
+        "GPU memory bandwidth usage percentage",
     }));
 }
 
@@ -401,6 +442,7 @@ void ffInitGPUOptions(FFGPUOptions* options)
     options->driverSpecific = false;
     options->detectionMethod = FF_GPU_DETECTION_METHOD_AUTO;
     options->temp = false;
+    options->usage = false;
     options->hideType = FF_GPU_TYPE_UNKNOWN;
     options->tempConfig = (FFColorRangeConfig) { 60, 80 };
     options->percent = (FFColorRangeConfig) { 50, 80 };
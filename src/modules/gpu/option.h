@@ -28,6 +28,7 @@ typedef struct FFGPUOptions
     FFGPUType hideType;
     FFGPUDetectionMethod detectionMethod;
     bool temp;
+    bool usage;
     bool driverSpecific;
     bool forceMethod;
     FFColorRangeConfig tempConfig;
@@ -6,7 +6,7 @@
 #include "util/stringUtils.h"
 
 #define FF_NETIO_DISPLAY_NAME "Network IO"
-#define FF_NETIO_NUM_FORMAT_ARGS 12
+#define FF_NETIO_NUM_FORMAT_ARGS 14
 
 static int sortInfs(const FFNetIOResult* left, const FFNetIOResult* right)
 {
@@ -49,6 +49,8 @@ void ffPrintNetIO(FFNetIOOptions* options)
     FF_STRBUF_AUTO_DESTROY key = ffStrbufCreate();
     FF_STRBUF_AUTO_DESTROY buffer = ffStrbufCreate();
     FF_STRBUF_AUTO_DESTROY buffer2 = ffStrbufCreate();
+    FF_STRBUF_AUTO_DESTROY peakRx = ffStrbufCreate();
+    FF_STRBUF_AUTO_DESTROY peakTx = ffStrbufCreate();
 
     FF_LIST_FOR_EACH(FFNetIOResult, inf, result)
     {
@@ -79,20 +81,37 @@ void ffPrintNetIO(FFNetIOOptions* options)
             ffParseSize(inf->txBytes, &buffer2);
             if (!options->detectTotal) ffStrbufAppendS(&buffer2, "/s");
 
+            ffStrbufClear(&peakRx);
+            ffStrbufClear(&peakTx);
+            if (!options->detectTotal)
+            {
+                ffParseSize((uint64_t) inf->peak.rxBytes, &peakRx);
+                ffStrbufAppendS(&peakRx, "/s");
+                ffParseSize((uint64_t) inf->peak.txBytes, &peakTx);
+                ffStrbufAppendS(&peakTx, "/s");
+            }
+
+            #define FF_NETIO_COUNTER_ARG(field) (options->detectTotal \
+                ? (FFformatarg) {FF_FORMAT_ARG_TYPE_UINT64, &inf->field} \
+                : (FFformatarg) {FF_FORMAT_ARG_TYPE_DOUBLE, &inf->average.field})
+
             FF_PRINT_FORMAT_CHECKED(key.chars, 0, &options->moduleArgs, FF_PRINT_TYPE_NO_CUSTOM_KEY, FF_NETIO_NUM_FORMAT_ARGS, ((FFformatarg[]){
                 {FF_FORMAT_ARG_TYPE_STRBUF, &buffer},
                 {FF_FORMAT_ARG_TYPE_STRBUF, &buffer2},
                 {FF_FORMAT_ARG_TYPE_STRBUF, &inf->name},
                 {FF_FORMAT_ARG_TYPE_BOOL, &inf->defaultRoute},
-                {FF_FORMAT_ARG_TYPE_UINT64, &inf->txBytes},
-                {FF_FORMAT_ARG_TYPE_UINT64, &inf->rxBytes},
-                {FF_FORMAT_ARG_TYPE_UINT64, &inf->txPackets},
-                {FF_FORMAT_ARG_TYPE_UINT64, &inf->rxPackets},
-                {FF_FORMAT_ARG_TYPE_UINT64, &inf->rxErrors},
-                {FF_FORMAT_ARG_TYPE_UINT64, &inf->txErrors},
-                {FF_FORMAT_ARG_TYPE_UINT64, &inf->rxDrops},
-                {FF_FORMAT_ARG_TYPE_UINT64, &inf->txDrops},
+                FF_NETIO_COUNTER_ARG(txBytes),
+                FF_NETIO_COUNTER_ARG(rxBytes),
+                FF_NETIO_COUNTER_ARG(txPackets),
+                FF_NETIO_COUNTER_ARG(rxPackets),
+                FF_NETIO_COUNTER_ARG(rxErrors),
+                FF_NETIO_COUNTER_ARG(txErrors),
+                FF_NETIO_COUNTER_ARG(rxDrops),
+                FF_NETIO_COUNTER_ARG(txDrops),
+                {FF_FORMAT_ARG_TYPE_STRBUF, &peakRx},
+                {FF_FORMAT_ARG_TYPE_STRBUF, &peakTx},
             }));
+            #undef FF_NETIO_COUNTER_ARG
         }
         ++index;
     }
@@ -128,6 +147,13 @@ bool ffParseNetIOCommandOptions(FFNetIOOptions* options, const char* key, const
         return true;
     }
 
+    if (ffStrEqualsIgnCase(subKey, "samples"))
+    {
+        options->samples = ffOptionParseUInt32(key, value);
+        if (options->samples == 0) options->samples = 1;
+        return true;
+    }
+
     return false;
 }
 
@@ -162,6 +188,13 @@ void ffParseNetIOJsonObject(FFNetIOOptions* options, yyjson_val* module)
             continue;
         }
 
+        if (ffStrEqualsIgnCase(key, "samples"))
+        {
+            options->samples = (uint32_t) yyjson_get_uint(val);
+            if (options->samples == 0) options->samples = 1;
+            continue;
+        }
+
         ffPrintError(FF_NETIO_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, "Unknown JSON key %s", key);
     }
 }
@@ -181,6 +214,21 @@ void ffGenerateNetIOJsonConfig(FFNetIOOptions* options, yyjson_mut_doc* doc, yyj
 
     if (options->detectTotal != defaultOptions.detectTotal)
         yyjson_mut_obj_add_bool(doc, module, "detectTotal", options->detectTotal);
+
+    if (options->samples != defaultOptions.samples)
+        yyjson_mut_obj_add_uint(doc, module, "samples", options->samples);
+}
+
+static void addRates(yyjson_mut_doc* doc, yyjson_mut_val* obj, const FFNetIORates* rates)
+{
+    yyjson_mut_obj_add_real(doc, obj, "txBytes", rates->txBytes);
+    yyjson_mut_obj_add_real(doc, obj, "rxBytes", rates->rxBytes);
+    yyjson_mut_obj_add_real(doc, obj, "txPackets", rates->txPackets);
+    yyjson_mut_obj_add_real(doc, obj, "rxPackets", rates->rxPackets);
+    yyjson_mut_obj_add_real(doc, obj, "rxErrors", rates->rxErrors);
+    yyjson_mut_obj_add_real(doc, obj, "txErrors", rates->txErrors);
+    yyjson_mut_obj_add_real(doc, obj, "rxDrops", rates->rxDrops);
+    yyjson_mut_obj_add_real(doc, obj, "txDrops", rates->txDrops);
 }
 
 void ffGenerateNetIOJsonResult(FFNetIOOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module)
@@ -200,14 +248,22 @@ void ffGenerateNetIOJsonResult(FFNetIOOptions* options, yyjson_mut_doc* doc, yyj
         yyjson_mut_val* obj = yyjson_mut_arr_add_obj(doc, arr);
         yyjson_mut_obj_add_strbuf(doc, obj, "name", &counter->name);
         yyjson_mut_obj_add_bool(doc, obj, "defaultRoute", counter->defaultRoute);
-        yyjson_mut_obj_add_uint(doc, obj, "txBytes", counter->txBytes);
-        yyjson_mut_obj_add_uint(doc, obj, "rxBytes", counter->rxBytes);
-        yyjson_mut_obj_add_uint(doc, obj, "txPackets", counter->txPackets);
-        yyjson_mut_obj_add_uint(doc, obj, "rxPackets", counter->rxPackets);
-        yyjson_mut_obj_add_uint(doc, obj, "rxErrors", counter->rxErrors);
-        yyjson_mut_obj_add_uint(doc, obj, "txErrors", counter->txErrors);
-        yyjson_mut_obj_add_uint(doc, obj, "rxDrops", counter->rxDrops);
-        yyjson_mut_obj_add_uint(doc, obj, "txDrops", counter->txDrops);
+        if (options->detectTotal)
+        {
+            yyjson_mut_obj_add_uint(doc, obj, "txBytes", counter->txBytes);
+            yyjson_mut_obj_add_uint(doc, obj, "rxBytes", counter->rxBytes);
+            yyjson_mut_obj_add_uint(doc, obj, "txPackets", counter->txPackets);
+            yyjson_mut_obj_add_uint(doc, obj, "rxPackets", counter->rxPackets);
+            yyjson_mut_obj_add_uint(doc, obj, "rxErrors", counter->rxErrors);
+            yyjson_mut_obj_add_uint(doc, obj, "txErrors", counter->txErrors);
+            yyjson_mut_obj_add_uint(doc, obj, "rxDrops", counter->rxDrops);
+            yyjson_mut_obj_add_uint(doc, obj, "txDrops", counter->txDrops);
+        }
+        else
+        {
+            addRates(doc, obj, &counter->average);
+            addRates(doc, yyjson_mut_obj_add_obj(doc, obj, "peak"), &counter->peak);
+        }
     }
 
     FF_LIST_FOR_EACH(FFNetIOResult, inf, result)
@@ -231,6 +287,8 @@ void ffPrintNetIOHelpFormat(void)
         "Number of errors sent [per second]",
         "Number of packets dropped when receiving [per second]",
         "Number of packets dropped when sending [per second]",
+        "Peak size of data received per second (formatted)",
+        "Peak size of data sent per second (formatted)",
     }));
 }
 
@@ -258,6 +316,7 @@ void ffInitNetIOOptions(FFNetIOOptions* options)
         #endif
     ;
     options->detectTotal = false;
+    options->samples = 1;
 }
 
 void ffDestroyNetIOOptions(FFNetIOOptions* options)
@@ -12,4 +12,5 @@ typedef struct FFNetIOOptions
     FFstrbuf namePrefix;
     bool defaultRouteOnly;
     bool detectTotal;
+    uint32_t samples;
 } FFNetIOOptions;
@@ -11,5 +11,7 @@ typedef struct FFPublicIpOptions
 
     FFstrbuf url;
     uint32_t timeout;
+    uint32_t cacheTtl;
+    bool cacheRefresh;
     bool ipv6;
 } FFPublicIpOptions;
@@ -65,6 +65,18 @@ bool ffParsePublicIpCommandOptions(FFPublicIpOptions* options, const char* key,
         return true;
     }
 
+    if (ffStrEqualsIgnCase(subKey, "cache-ttl"))
+    {
+        options->cacheTtl = ffOptionParseUInt32(key, value);
+        return true;
+    }
+
+    if (ffStrEqualsIgnCase(subKey, "cache-refresh"))
+    {
+        options->cacheRefresh = ffOptionParseBoolean(value);
+        return true;
+    }
+
     return false;
 }
 
@@ -99,6 +111,18 @@ void ffParsePublicIpJsonObject(FFPublicIpOptions* options, yyjson_val* module)
             continue;
         }
 
+        if (ffStrEqualsIgnCase(key, "cacheTtl"))
+        {
+            options->cacheTtl = (uint32_t) yyjson_get_uint(val);
+            continue;
+        }
+
+        if (ffStrEqualsIgnCase(key, "cacheRefresh"))
+        {
+            options->cacheRefresh = yyjson_get_bool(val);
+            continue;
+        }
+
         ffPrintError(FF_PUBLICIP_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, "Unknown JSON key %s", key);
     }
 }
@@ -118,6 +142,12 @@ void ffGeneratePublicIpJsonConfig(FFPublicIpOptions* options, yyjson_mut_doc* do
 
     if (defaultOptions.ipv6 != options->ipv6)
         yyjson_mut_obj_add_bool(doc, module, "ipv6", options->ipv6);
+
+    if (defaultOptions.cacheTtl != options->cacheTtl)
+        yyjson_mut_obj_add_uint(doc, module, "cacheTtl", options->cacheTtl);
+
+    if (defaultOptions.cacheRefresh != options->cacheRefresh)
+        yyjson_mut_obj_add_bool(doc, module, "cacheRefresh", options->cacheRefresh);
 }
 
 void ffGeneratePublicIpJsonResult(FFPublicIpOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module)
@@ -167,10 +197,15 @@ void ffInitPublicIpOptions(FFPublicIpOptions* options)
     ffStrbufInit(&options->url);
     options->timeout = 0;
     options->ipv6 = false;
+    options->cacheTtl = 0;
+    options->cacheRefresh = true;
 }
 
 void ffDestroyPublicIpOptions(FFPublicIpOptions* options)
 {
+    // Like command options, public IP options are also created and destroyed temporarily; the requests live as long as the global ones
+    if (options == &instance.config.modules.publicIP)
+        ffReleasePublicIpRequests();
     ffOptionDestroyModuleArg(&options->moduleArgs);
 
     ffStrbufDestroy(&options->url);
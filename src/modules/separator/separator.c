@@ -2,44 +2,21 @@
 #include "common/jsonconfig.h"
 #include "modules/separator/separator.h"
 #include "util/stringUtils.h"
-#include "util/mallocHelper.h"
 #include "util/wcwidth.h"
 
-static inline uint32_t max(uint32_t a, uint32_t b)
+static inline uint32_t getWcsWidth(const FFstrbuf* mbstr)
 {
-    return a > b ? a : b;
-}
-
-static inline uint32_t getWcsWidth(const FFstrbuf* mbstr, wchar_t* wstr, mbstate_t* state)
-{
-    int result = 1;
-    for (uint32_t i = 0; i < mbstr->length; i++)
-    {
-        if (!isascii(mbstr->chars[i]))
-        {
-            result = 0;
-            break;
-        }
-    }
-    if (__builtin_expect(result, 1)) return mbstr->length;
-
-    const char* str = mbstr->chars;
-    uint32_t wstrLength = (uint32_t) mbsrtowcs(wstr, &str, mbstr->length, state);
-    result = mk_wcswidth(wstr, wstrLength);
+    int result = ffUtf8Width(mbstr->chars, mbstr->length);
     return result > 0 ? (uint32_t) result : mbstr->length;
 }
 
 void ffPrintSeparator(FFSeparatorOptions* options)
 {
-    mbstate_t state = {};
     bool fqdn = instance.config.modules.title.fqdn;
     const FFPlatform* platform = &instance.state.platform;
 
-    FF_AUTO_FREE wchar_t* wstr = malloc((max(
-        platform->userName.length, options->string.length) + 1) * sizeof(*wstr));
-
     uint32_t titleLength = 1 // @
-        + getWcsWidth(&platform->userName, wstr, &state) // user name
+        + getWcsWidth(&platform->userName) // user name
         + (fqdn ? platform->hostName.length : ffStrbufFirstIndexC(&platform->hostName, '.')); // host name
     ffLogoPrintLine();
 
@@ -51,7 +28,7 @@ void ffPrintSeparator(FFSeparatorOptions* options)
     }
     else
     {
-        uint32_t wcsLength = getWcsWidth(&options->string, wstr, &state);
+        uint32_t wcsLength = getWcsWidth(&options->string);
 
         int remaining = (int) titleLength;
         //Write the whole separator as often as it fits fully into titleLength
@@ -64,17 +41,13 @@ void ffPrintSeparator(FFSeparatorOptions* options)
             if (wcsLength != options->string.length)
             {
                 // Unicode chars
-                for(int i = 0; remaining > 0; ++i)
+                for(uint32_t i = 0; remaining > 0 && i < options->string.length;)
                 {
-                    #ifdef __linux__
-                    // https://stackoverflow.com/questions/75126743/i-have-difficulties-with-putwchar-in-c#answer-75137784
-                    char wch[16] = "";
-                    uint32_t wchLength = (uint32_t) wcrtomb(wch, wstr[i], &state);
-                    fwrite(wch, wchLength, 1, stdout);
-                    #else
-                    putwchar(wstr[i]);
-                    #endif
-                    int width = mk_wcwidth(wstr[i]);
+                    uint32_t codepoint;
+                    uint32_t bytes = ffUtf8Decode(options->string.chars + i, options->string.length - i, &codepoint);
+                    fwrite(options->string.chars + i, bytes, 1, stdout);
+                    i += bytes;
+                    int width = ffWcwidth(codepoint);
                     remaining -= width < 0 ? 0 : width;
                 }
             }
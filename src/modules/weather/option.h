@@ -12,4 +12,6 @@ typedef struct FFWeatherOptions
     FFstrbuf location;
     FFstrbuf outputFormat;
     uint32_t timeout;
+    uint32_t cacheTtl;
+    bool cacheRefresh;
 } FFWeatherOptions;
@@ -56,6 +56,18 @@ bool ffParseWeatherCommandOptions(FFWeatherOptions* options, const char* key, co
         return true;
     }
 
+    if (ffStrEqualsIgnCase(subKey, "cache-ttl"))
+    {
+        options->cacheTtl = ffOptionParseUInt32(key, value);
+        return true;
+    }
+
+    if (ffStrEqualsIgnCase(subKey, "cache-refresh"))
+    {
+        options->cacheRefresh = ffOptionParseBoolean(value);
+        return true;
+    }
+
     return false;
 }
 
@@ -90,6 +102,18 @@ void ffParseWeatherJsonObject(FFWeatherOptions* options, yyjson_val* module)
             continue;
         }
 
+        if (ffStrEqualsIgnCase(key, "cacheTtl"))
+        {
+            options->cacheTtl = (uint32_t) yyjson_get_uint(val);
+            continue;
+        }
+
+        if (ffStrEqualsIgnCase(key, "cacheRefresh"))
+        {
+            options->cacheRefresh = yyjson_get_bool(val);
+            continue;
+        }
+
         ffPrintError(FF_WEATHER_MODULE_NAME, 0, &options->moduleArgs, FF_PRINT_TYPE_DEFAULT, "Unknown JSON key %s", key);
     }
 }
@@ -109,6 +133,12 @@ void ffGenerateWeatherJsonConfig(FFWeatherOptions* options, yyjson_mut_doc* doc,
 
     if (options->timeout != defaultOptions.timeout)
         yyjson_mut_obj_add_uint(doc, module, "timeout", options->timeout);
+
+    if (defaultOptions.cacheTtl != options->cacheTtl)
+        yyjson_mut_obj_add_uint(doc, module, "cacheTtl", options->cacheTtl);
+
+    if (defaultOptions.cacheRefresh != options->cacheRefresh)
+        yyjson_mut_obj_add_bool(doc, module, "cacheRefresh", options->cacheRefresh);
 }
 
 void ffGenerateWeatherJsonResult(FFWeatherOptions* options, yyjson_mut_doc* doc, yyjson_mut_val* module)
@@ -150,11 +180,17 @@ void ffInitWeatherOptions(FFWeatherOptions* options)
     ffStrbufInit(&options->location);
     ffStrbufInitStatic(&options->outputFormat, "%t+-+%C+(%l)");
     options->timeout = 0;
+    options->cacheTtl = 0;
+    options->cacheRefresh = true;
 }
 
 void ffDestroyWeatherOptions(FFWeatherOptions* options)
 {
+    // The requests live as long as the global options, see ffDestroyPublicIpOptions
+    if (options == &instance.config.modules.weather)
+        ffReleaseWeatherRequests();
     ffOptionDestroyModuleArg(&options->moduleArgs);
 
+    ffStrbufDestroy(&options->location);
     ffStrbufDestroy(&options->outputFormat);
 }
@@ -21,6 +21,11 @@ const char* ffOptionsParseGeneralJsonConfig(FFOptionsGeneral* options, yyjson_va
             options->multithreading = yyjson_get_bool(val);
         else if (ffStrEqualsIgnCase(key, "processingTimeout"))
             options->processingTimeout = (int32_t) yyjson_get_int(val);
+        else if (ffStrEqualsIgnCase(key, "samplingWindow"))
+        {
+            options->samplingWindow = (uint32_t) yyjson_get_uint(val);
+            if (options->samplingWindow < 100) options->samplingWindow = 100;
+        }
 
         #if defined(__linux__) || defined(__FreeBSD__)
         else if (ffStrEqualsIgnCase(key, "escapeBedrock"))
@@ -71,6 +76,11 @@ bool ffOptionsParseGeneralCommandLine(FFOptionsGeneral* options, const char* key
         options->multithreading = ffOptionParseBoolean(value);
     else if(ffStrEqualsIgnCase(key, "--processing-timeout"))
         options->processingTimeout = ffOptionParseInt32(key, value);
+    else if(ffStrEqualsIgnCase(key, "--sampling-window"))
+    {
+        options->samplingWindow = ffOptionParseUInt32(key, value);
+        if (options->samplingWindow < 100) options->samplingWindow = 100;
+    }
 
     #if defined(__linux__) || defined(__FreeBSD__)
     else if(ffStrEqualsIgnCase(key, "--escape-bedrock"))
@@ -100,6 +110,7 @@ bool ffOptionsParseGeneralCommandLine(FFOptionsGeneral* options, const char* key
 void ffOptionsInitGeneral(FFOptionsGeneral* options)
 {
     options->processingTimeout = 1000;
+    options->samplingWindow = 1000;
     options->multithreading = true;
 
     #if defined(__linux__) || defined(__FreeBSD__)
@@ -131,6 +142,9 @@ void ffOptionsGenerateGeneralJsonConfig(FFOptionsGeneral* options, yyjson_mut_do
     if (options->processingTimeout != defaultOptions.processingTimeout)
         yyjson_mut_obj_add_int(doc, obj, "processingTimeout", options->processingTimeout);
 
+    if (options->samplingWindow != defaultOptions.samplingWindow)
+        yyjson_mut_obj_add_uint(doc, obj, "samplingWindow", options->samplingWindow);
+
     #if defined(__linux__) || defined(__FreeBSD__)
 
     if (options->escapeBedrock != defaultOptions.escapeBedrock)
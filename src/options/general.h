@@ -13,6 +13,7 @@ typedef struct FFOptionsGeneral
 {
     bool multithreading;
     int32_t processingTimeout;
+    uint32_t samplingWindow;
 
     // Module options that cannot be put in module option structure
     #if defined(__linux__) || defined(__FreeBSD__)
@@ -0,0 +1,228 @@
+#include "base64.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+    #define FF_BASE64_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define FF_BASE64_NEON 1
+#endif
+
+static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Originally from https://github.com/kostya/benchmarks/blob/master/base64/test-nolib.c#L145
+static void encodeScalar(uint32_t size, const uint8_t* str, char* out)
+{
+    const uint8_t* ends = str + (size - size % 3);
+    while (str != ends) {
+        uint32_t n = (uint32_t) str[0] << 16 | (uint32_t) str[1] << 8 | str[2];
+        *out++ = chars[(n >> 18) & 63];
+        *out++ = chars[(n >> 12) & 63];
+        *out++ = chars[(n >> 6) & 63];
+        *out++ = chars[n & 63];
+        str += 3;
+    }
+
+    if (size % 3 == 1) {
+        uint32_t n = (uint32_t) *str << 16;
+        *out++ = chars[(n >> 18) & 63];
+        *out++ = chars[(n >> 12) & 63];
+        *out++ = '=';
+        *out++ = '=';
+    } else if (size % 3 == 2) {
+        uint32_t n = (uint32_t) str[0] << 16 | (uint32_t) str[1] << 8;
+        *out++ = chars[(n >> 18) & 63];
+        *out++ = chars[(n >> 12) & 63];
+        *out++ = chars[(n >> 6) & 63];
+        *out++ = '=';
+    }
+}
+
+#if FF_BASE64_X86
+
+// Wojciech Muła, Daniel Lemire: Faster Base64 Encoding and Decoding Using AVX2 Instructions (https://arxiv.org/abs/1704.00605).
+// Every 32 bit lane holds 3 input bytes; they are split into four 6 bit indices, which are turned into ASCII with one pshufb.
+// The functions handle complete blocks only and return the number of input bytes consumed
+
+// Moves the four 6 bit fields of every 32 bit lane into its four bytes
+__attribute__((__target__("ssse3")))
+static inline __m128i splitSSSE3(__m128i v)
+{
+    const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t0, t1);
+}
+
+__attribute__((__target__("ssse3")))
+static inline __m128i lookupSSSE3(__m128i indices)
+{
+    // 0..25 -> 'A'..; 26..51 -> 'a'..; 52..61 -> '0'..; 62 -> '+'; 63 -> '/'
+    __m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+    const __m128i shiftLUT = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(shiftLUT, result), indices);
+}
+
+__attribute__((__target__("ssse3")))
+static uint32_t encodeSSSE3(uint32_t size, const uint8_t* in, char* out)
+{
+    const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    uint32_t done = 0;
+    // Loads 16 bytes for 12 of input
+    for (; size - done >= 16; done += 12, out += 16)
+    {
+        __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (in + done)), shuffle);
+        _mm_storeu_si128((__m128i*) out, lookupSSSE3(splitSSSE3(v)));
+    }
+    return done;
+}
+
+__attribute__((__target__("avx2")))
+static uint32_t encodeAVX2(uint32_t size, const uint8_t* in, char* out)
+{
+    const __m256i shuffle = _mm256_set_epi8(
+        10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+        10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m256i shiftLUT = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+    uint32_t done = 0;
+    // Two 12 byte blocks per iteration, one per 128 bit lane. Loads 28 bytes for 24 of input
+    for (; size - done >= 28; done += 24, out += 32)
+    {
+        __m256i v = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) (in + done))),
+            _mm_loadu_si128((const __m128i*) (in + done + 12)), 1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+        const __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+        const __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t0, t1);
+
+        __m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        result = _mm256_add_epi8(_mm256_shuffle_epi8(shiftLUT, result), indices);
+        _mm256_storeu_si256((__m256i*) out, result);
+    }
+    return done;
+}
+
+typedef uint32_t EncodeBlocksFunc(uint32_t size, const uint8_t* in, char* out);
+
+static EncodeBlocksFunc* getEncodeBlocks(void)
+{
+    static EncodeBlocksFunc* func;
+    if (!func)
+    {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            func = encodeAVX2;
+        else if (__builtin_cpu_supports("ssse3"))
+            func = encodeSSSE3;
+        else
+            func = NULL;
+    }
+    return func;
+}
+
+#elif FF_BASE64_NEON
+
+static uint32_t encodeNEON(uint32_t size, const uint8_t* in, char* out)
+{
+    const uint8x16x4_t table = {{
+        vld1q_u8((const uint8_t*) chars),
+        vld1q_u8((const uint8_t*) chars + 16),
+        vld1q_u8((const uint8_t*) chars + 32),
+        vld1q_u8((const uint8_t*) chars + 48),
+    }};
+    const uint8x16_t mask = vdupq_n_u8(0x3F);
+
+    uint32_t done = 0;
+    // vld3 splits 48 bytes into the first, second and third bytes of each triple
+    for (; size - done >= 48; done += 48, out += 64)
+    {
+        uint8x16x3_t src = vld3q_u8(in + done);
+        uint8x16x4_t dst;
+        dst.val[0] = vshrq_n_u8(src.val[0], 2);
+        dst.val[1] = vandq_u8(vorrq_u8(vshrq_n_u8(src.val[1], 4), vshlq_n_u8(src.val[0], 4)), mask);
+        dst.val[2] = vandq_u8(vorrq_u8(vshrq_n_u8(src.val[2], 6), vshlq_n_u8(src.val[1], 2)), mask);
+        dst.val[3] = vandq_u8(src.val[2], mask);
+        for (int i = 0; i < 4; ++i)
+            dst.val[i] = vqtbl4q_u8(table, dst.val[i]);
+        vst4q_u8((uint8_t*) out, dst);
+    }
+    return done;
+}
+
+#endif
+
+static FFBase64Impl forcedImpl;
+
+bool ffBase64ForceImpl(FFBase64Impl impl)
+{
+    switch (impl)
+    {
+        case FF_BASE64_IMPL_AUTO:
+        case FF_BASE64_IMPL_SCALAR:
+            break;
+        #if FF_BASE64_X86
+        case FF_BASE64_IMPL_SSSE3:
+            __builtin_cpu_init();
+            if (!__builtin_cpu_supports("ssse3")) return false;
+            break;
+        case FF_BASE64_IMPL_AVX2:
+            __builtin_cpu_init();
+            if (!__builtin_cpu_supports("avx2")) return false;
+            break;
+        #elif FF_BASE64_NEON
+        case FF_BASE64_IMPL_NEON:
+            break;
+        #endif
+        default:
+            return false;
+    }
+    forcedImpl = impl;
+    return true;
+}
+
+void ffBase64EncodeRaw(uint32_t size, const void* data, char* output)
+{
+    const uint8_t* in = data;
+    uint32_t done = 0;
+
+    #if FF_BASE64_X86
+    EncodeBlocksFunc* encodeBlocks;
+    switch (forcedImpl)
+    {
+        case FF_BASE64_IMPL_SCALAR: encodeBlocks = NULL; break;
+        case FF_BASE64_IMPL_SSSE3: encodeBlocks = encodeSSSE3; break;
+        case FF_BASE64_IMPL_AVX2: encodeBlocks = encodeAVX2; break;
+        default: encodeBlocks = getEncodeBlocks(); break;
+    }
+    if (encodeBlocks)
+        done = encodeBlocks(size, in, output);
+    #elif FF_BASE64_NEON
+    if (forcedImpl != FF_BASE64_IMPL_SCALAR)
+        done = encodeNEON(size, in, output);
+    #endif
+
+    // `done` is a multiple of 3
+    encodeScalar(size - done, in + done, output + done / 3 * 4);
+}
+
+void ffBase64Append(FFstrbuf* out, uint32_t size, const void* data)
+{
+    uint32_t length = ffBase64EncodedLength(size);
+    ffStrbufEnsureFree(out, length);
+    ffBase64EncodeRaw(size, data, out->chars + out->length);
+    out->length += length;
+    out->chars[out->length] = '\0';
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+#include "util/FFstrbuf.h"
+
+static inline uint32_t ffBase64EncodedLength(uint32_t size)
+{
+    return (size + 2) / 3 * 4;
+}
+
+// Encodes `size` bytes into `output`, which must have room for ffBase64EncodedLength(size) chars. No NUL terminator is written.
+// Uses AVX2 / SSSE3 (chosen at runtime) or NEON when available
+void ffBase64EncodeRaw(uint32_t size, const void* data, char* output);
+
+// Appends the encoding of `size` bytes to `out`
+void ffBase64Append(FFstrbuf* out, uint32_t size, const void* data);
+
+typedef enum FFBase64Impl
+{
+    FF_BASE64_IMPL_AUTO, // Best one supported by the CPU
+    FF_BASE64_IMPL_SCALAR,
+    FF_BASE64_IMPL_SSSE3,
+    FF_BASE64_IMPL_AVX2,
+    FF_BASE64_IMPL_NEON,
+} FFBase64Impl;
+
+// Forces the implementation used by ffBase64EncodeRaw. For tests. Returns false if it isn't available in this build or on this CPU
+bool ffBase64ForceImpl(FFBase64Impl impl);
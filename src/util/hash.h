@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util/FFstrbuf.h"
+
+// 64-bit FNV-1a. Not cryptographic; used to name cache files after their keys
+#define FF_HASH_FNV1A_INIT 0xcbf29ce484222325ULL
+
+static inline uint64_t ffHashFnv1aAppend(uint64_t hash, const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*) data;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static inline uint64_t ffHashFnv1a(const void* data, size_t size)
+{
+    return ffHashFnv1aAppend(FF_HASH_FNV1A_INIT, data, size);
+}
+
+static inline uint64_t ffHashFnv1aStrbuf(const FFstrbuf* strbuf)
+{
+    return ffHashFnv1a(strbuf->chars, strbuf->length);
+}
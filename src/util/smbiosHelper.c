@@ -122,15 +122,36 @@ typedef union FFSmbiosEntryPoint
     FFSmbios30EntryPoint Smbios30;
 } FFSmbiosEntryPoint;
 
+static uint16_t smbiosVersion;
+
+static uint16_t getEntryPointVersion(const FFSmbiosEntryPoint* entryPoint)
+{
+    if (memcmp(entryPoint->Smbios20.AnchorString, "_SM_", sizeof(entryPoint->Smbios20.AnchorString)) == 0)
+        return (uint16_t) (entryPoint->Smbios20.SmbiosMajorVersion << 8 | entryPoint->Smbios20.SmbiosMinorVersion);
+    if (memcmp(entryPoint->Smbios30.AnchorString, "_SM3_", sizeof(entryPoint->Smbios30.AnchorString)) == 0)
+        return (uint16_t) (entryPoint->Smbios30.SmbiosMajorVersion << 8 | entryPoint->Smbios30.SmbiosMinorVersion);
+    return 0;
+}
+
 const FFSmbiosHeaderTable* ffGetSmbiosHeaderTable()
 {
     static FFstrbuf buffer;
     static FFSmbiosHeaderTable table;
+    static bool initialized;
 
-    if (buffer.chars == NULL)
+    // The table is parsed once and shared by all modules. An unreadable table is remembered as well
+    if (!initialized)
     {
+        initialized = true;
+
         #ifdef __linux__
-        if (!ffAppendFileBuffer("/sys/firmware/dmi/tables/DMI", &buffer))
+        if (ffAppendFileBuffer("/sys/firmware/dmi/tables/DMI", &buffer))
+        {
+            FFSmbiosEntryPoint entryPoint;
+            if (ffReadFileData("/sys/firmware/dmi/tables/smbios_entry_point", sizeof(entryPoint), &entryPoint) >= 0x10)
+                smbiosVersion = getEntryPointVersion(&entryPoint);
+        }
+        else
         #endif
         {
             FF_STRBUF_AUTO_DESTROY strEntryAddress = ffStrbufCreate();
@@ -165,6 +186,8 @@ const FFSmbiosHeaderTable* ffGetSmbiosHeaderTable()
                 munmap(p, sizeof(entryPoint));
             }
 
+            smbiosVersion = getEntryPointVersion(&entryPoint);
+
             uint32_t tableLength = 0;
             loff_t tableAddress = 0;
             if (memcmp(entryPoint.Smbios20.AnchorString, "_SM_", sizeof(entryPoint.Smbios20.AnchorString)) == 0)
@@ -219,7 +242,12 @@ const FFSmbiosHeaderTable* ffGetSmbiosHeaderTable()
         }
     }
 
-    return &table;
+    return buffer.length > 0 ? &table : NULL;
+}
+
+uint16_t ffGetSmbiosVersion()
+{
+    return ffGetSmbiosHeaderTable() ? smbiosVersion : 0;
 }
 #elif defined(_WIN32)
 #include <windows.h>
@@ -236,13 +264,18 @@ typedef struct FFRawSmbiosData
     uint8_t SMBIOSTableData[];
 } FFRawSmbiosData;
 
+static uint16_t smbiosVersion;
+
 const FFSmbiosHeaderTable* ffGetSmbiosHeaderTable()
 {
     static FFRawSmbiosData* buffer;
     static FFSmbiosHeaderTable table;
+    static bool initialized;
 
-    if (!buffer)
+    if (!initialized)
     {
+        initialized = true;
+
         const DWORD signature = 'RSMB';
         uint32_t bufSize = GetSystemFirmwareTable(signature, 0, NULL, 0);
         if (bufSize <= sizeof(FFRawSmbiosData))
@@ -252,6 +285,7 @@ const FFSmbiosHeaderTable* ffGetSmbiosHeaderTable()
         assert(buffer);
         FF_MAYBE_UNUSED uint32_t resultSize = GetSystemFirmwareTable(signature, 0, buffer, bufSize);
         assert(resultSize == bufSize);
+        smbiosVersion = (uint16_t) (buffer->SMBIOSMajorVersion << 8 | buffer->SMBIOSMinorVersion);
 
         for (
             const FFSmbiosHeader* header = (const FFSmbiosHeader*) buffer->SMBIOSTableData;
@@ -269,6 +303,11 @@ const FFSmbiosHeaderTable* ffGetSmbiosHeaderTable()
         }
     }
 
-    return &table;
+    return buffer ? &table : NULL;
+}
+
+uint16_t ffGetSmbiosVersion()
+{
+    return ffGetSmbiosHeaderTable() ? smbiosVersion : 0;
 }
 #endif
@@ -5,6 +5,8 @@
 
 #include "util/FFstrbuf.h"
 
+#include <stddef.h>
+
 bool ffIsSmbiosValueSet(FFstrbuf* value);
 static inline void ffCleanUpSmbiosValue(FFstrbuf* value)
 {
@@ -87,10 +89,114 @@ static inline const char* ffSmbiosLocateString(const char* start, uint8_t index
     return start;
 }
 
+typedef struct FFSmbiosBios
+{
+    FFSmbiosHeader Header;
+
+    uint8_t Vendor; // string
+    uint8_t BiosVersion; // string
+    uint16_t BiosStartingAddressSegment; // varies
+    uint8_t BiosReleaseDate; // string
+    uint8_t BiosRomSize; // string
+    uint64_t BiosCharacteristics; // bit field
+
+    // 2.4+
+    uint8_t BiosCharacteristicsExtensionBytes[2]; // bit field
+    uint8_t SystemBiosMajorRelease; // varies
+    uint8_t SystemBiosMinorRelease; // varies
+    uint8_t EmbeddedControllerFirmwareMajorRelease; // varies
+    uint8_t EmbeddedControllerFirmwareMinorRelease; // varies
+
+    // 3.1+
+    uint16_t ExtendedBiosRomSize; // bit field
+} __attribute__((__packed__)) FFSmbiosBios;
+
+static_assert(offsetof(FFSmbiosBios, ExtendedBiosRomSize) == 0x18,
+    "FFSmbiosBios: Wrong struct alignment");
+
+typedef struct FFSmbiosBaseboard
+{
+    FFSmbiosHeader Header;
+
+    uint8_t Manufacturer; // string
+    uint8_t Product; // string
+    uint8_t Version; // string
+    uint8_t SerialNumber; // string
+    uint8_t AssetTag; // string
+    uint8_t FeatureFlags; // bit field
+    uint8_t LocationInChassis; // string
+    uint16_t ChassisHandle; // varies
+    uint8_t BoardType; // enum
+    uint8_t NumberOfContainedObjectHandles; // varies
+    uint16_t ContainedObjectHandles[]; // varies
+} __attribute__((__packed__)) FFSmbiosBaseboard;
+
+static_assert(offsetof(FFSmbiosBaseboard, ContainedObjectHandles) == 0x0F,
+    "FFSmbiosBaseboard: Wrong struct alignment");
+
+// 7.4
+typedef struct FFSmbiosSystemEnclosure
+{
+    FFSmbiosHeader Header;
+
+    uint8_t Manufacturer; // string
+    uint8_t Type; // varies
+    uint8_t Version; // string
+    uint8_t SerialNumber; // string
+    uint8_t AssetTagNumber; // string
+
+    // 2.1+
+    uint8_t BootupState; // enum
+    uint8_t PowerSupplyState; // enum
+    uint8_t ThermalState; // enum
+    uint8_t SecurityStatus; // enum
+
+    // 2.3+
+    uint32_t OEMDefined; // varies
+    uint8_t Height; // varies
+    uint8_t NumberOfPowerCords; // varies
+    uint8_t ContainedElementCount; // varies
+    uint8_t ContainedRecordLength; // varies
+    uint8_t ContainedElements[]; // varies
+} __attribute__((__packed__)) FFSmbiosSystemEnclosure;
+
+static_assert(offsetof(FFSmbiosSystemEnclosure, ContainedElements) == 0x15,
+    "FFSmbiosSystemEnclosure: Wrong struct alignment");
+
+typedef struct FFSmbiosSystemInfo
+{
+    FFSmbiosHeader Header;
+
+    uint8_t Manufacturer; // string
+    uint8_t ProductName; // string
+    uint8_t Version; // string
+    uint8_t SerialNumber; // string
+
+    // 2.1+
+    struct {
+        uint32_t TimeLow;
+        uint16_t TimeMid;
+        uint16_t TimeHighAndVersion;
+        uint8_t ClockSeqHiAndReserved;
+        uint8_t ClockSeqLow;
+        uint8_t Node[6];
+    } __attribute__((__packed__)) UUID; // varies
+    uint8_t WakeUpType; // enum
+
+    // 2.4+
+    uint8_t SKUNumber; // string
+    uint8_t Family; // string
+} __attribute__((__packed__)) FFSmbiosSystemInfo;
+
+static_assert(offsetof(FFSmbiosSystemInfo, Family) == 0x1A,
+    "FFSmbiosSystemInfo: Wrong struct alignment");
+
 typedef const FFSmbiosHeader* FFSmbiosHeaderTable[FF_SMBIOS_TYPE_END_OF_TABLE];
 
 const FFSmbiosHeader* ffSmbiosNextEntry(const FFSmbiosHeader* header);
 const FFSmbiosHeaderTable* ffGetSmbiosHeaderTable();
+// Version of the table as (major << 8) | minor, e.g. 0x0206 for SMBIOS 2.6. 0 if the table or its entry point can't be read
+uint16_t ffGetSmbiosVersion();
 
 #ifdef __linux__
 bool ffGetSmbiosValue(const char* devicesPath, const char* classPath, FFstrbuf* buffer);
@@ -0,0 +1,90 @@
+#include "wcwidth.h"
+#include "3rdparty/mk_wcwidch/wcwidth_table.h"
+
+int ffWcwidth(uint32_t codepoint)
+{
+    if (codepoint < 0x80)
+        return codepoint >= 0x20 && codepoint < 0x7f ? 1 : codepoint == 0 ? 0 : -1;
+    if (codepoint >= 0x110000)
+        return 1;
+
+    uint32_t block = ffWcwidthStage1[codepoint / FF_WCWIDTH_BLOCK_SIZE];
+    uint32_t offset = codepoint % FF_WCWIDTH_BLOCK_SIZE;
+    int width = (ffWcwidthStage2[block][offset / 4] >> (offset % 4 * 2)) & 3;
+    return width == 3 ? -1 : width;
+}
+
+uint32_t ffUtf8Decode(const char* str, uint32_t length, uint32_t* codepoint)
+{
+    const uint8_t* s = (const uint8_t*) str;
+    uint32_t bytes;
+    uint32_t min;
+
+    if (s[0] < 0x80)
+    {
+        *codepoint = s[0];
+        return 1;
+    }
+    else if ((s[0] & 0xE0) == 0xC0)
+    {
+        *codepoint = s[0] & 0x1Fu;
+        bytes = 2;
+        min = 0x80;
+    }
+    else if ((s[0] & 0xF0) == 0xE0)
+    {
+        *codepoint = s[0] & 0x0Fu;
+        bytes = 3;
+        min = 0x800;
+    }
+    else if ((s[0] & 0xF8) == 0xF0)
+    {
+        *codepoint = s[0] & 0x07u;
+        bytes = 4;
+        min = 0x10000;
+    }
+    else
+        goto invalid;
+
+    if (bytes > length)
+        goto invalid;
+
+    for (uint32_t i = 1; i < bytes; ++i)
+    {
+        if ((s[i] & 0xC0) != 0x80)
+            goto invalid;
+        *codepoint = (*codepoint << 6) | (s[i] & 0x3Fu);
+    }
+
+    // Overlong encodings and surrogates
+    if (*codepoint < min || *codepoint >= 0x110000 || (*codepoint >= 0xD800 && *codepoint <= 0xDFFF))
+        goto invalid;
+
+    return bytes;
+
+invalid:
+    *codepoint = 0xFFFD;
+    return 1;
+}
+
+int ffUtf8Width(const char* str, uint32_t length)
+{
+    int width = 0;
+    for (uint32_t i = 0; i < length;)
+    {
+        if (__builtin_expect((uint8_t) str[i] >= 0x20 && (uint8_t) str[i] < 0x7f, 1))
+        {
+            ++width;
+            ++i;
+            continue;
+        }
+
+        uint32_t codepoint;
+        i += ffUtf8Decode(str + i, length - i, &codepoint);
+        int w = ffWcwidth(codepoint);
+        if (w < 0)
+            return -1;
+        width += w;
+    }
+    return width;
+}
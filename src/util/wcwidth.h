@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdint.h>
 #include <wchar.h>
 
 #ifdef FF_HAVE_WCWIDTH
@@ -14,3 +15,14 @@ static inline int mk_wcswidth(const wchar_t *pwcs, size_t n) {
 int mk_wcwidth(wchar_t ucs);
 int mk_wcswidth(const wchar_t *pwcs, size_t n);
 #endif
+
+// Column width of a code point as defined by mk_wcwidth(), looked up in a two-level table. Doesn't depend on the locale.
+// Returns -1 for control characters
+int ffWcwidth(uint32_t codepoint);
+
+// Decodes the UTF-8 char at `str` and returns its length in bytes.
+// Invalid or truncated sequences are consumed one byte at a time and decode to U+FFFD
+uint32_t ffUtf8Decode(const char* str, uint32_t length, uint32_t* codepoint);
+
+// Column width of a UTF-8 string, or -1 if it contains control characters
+int ffUtf8Width(const char* str, uint32_t length);
@@ -0,0 +1,105 @@
+#include "util/base64.h"
+#include "util/textModifier.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+__attribute__((__noreturn__))
+static void testFailed(const char* name, const char* expression, int lineNo)
+{
+    fputs(FASTFETCH_TEXT_MODIFIER_ERROR, stderr);
+    fprintf(stderr, "[%d] %s, name: %s", lineNo, expression, name);
+    fputs(FASTFETCH_TEXT_MODIFIER_RESET, stderr);
+    fputc('\n', stderr);
+    exit(1);
+}
+
+#define VERIFY(expression) if(!(expression)) testFailed(name, #expression, __LINE__)
+
+// RFC 4648, one bit at a time
+static void encodeReference(uint32_t size, const uint8_t* in, char* out)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint32_t bits = size * 8;
+    uint32_t chars = 0;
+    for (uint32_t bit = 0; bit < bits; bit += 6)
+    {
+        uint32_t index = 0;
+        for (uint32_t i = bit; i < bit + 6; ++i)
+        {
+            index <<= 1;
+            if (i < bits)
+                index |= (in[i / 8] >> (7 - i % 8)) & 1;
+        }
+        out[chars++] = alphabet[index];
+    }
+    while (chars % 4)
+        out[chars++] = '=';
+}
+
+// Longest block is 48 input bytes (NEON); cover several blocks of every implementation and every remainder
+#define MAX_SIZE (48 * 4 + 47)
+
+int main(void)
+{
+    const char* name = "";
+
+    uint8_t input[MAX_SIZE];
+    srand(42);
+    for (uint32_t i = 0; i < MAX_SIZE; ++i)
+        input[i] = (uint8_t) rand();
+    // Make sure every 6 bit value shows up, including 62 ('+') and 63 ('/')
+    for (uint32_t i = 0; i < 48; ++i)
+        input[i] = (uint8_t) (i * 0x55 ^ 0xFC);
+
+    struct { FFBase64Impl impl; const char* name; } impls[] = {
+        { FF_BASE64_IMPL_SCALAR, "scalar" },
+        { FF_BASE64_IMPL_SSSE3, "ssse3" },
+        { FF_BASE64_IMPL_AVX2, "avx2" },
+        { FF_BASE64_IMPL_NEON, "neon" },
+        { FF_BASE64_IMPL_AUTO, "auto" },
+    };
+
+    for (uint32_t i = 0; i < sizeof(impls) / sizeof(*impls); ++i)
+    {
+        name = impls[i].name;
+        if (!ffBase64ForceImpl(impls[i].impl))
+        {
+            printf("%s: not supported, skipped\n", name);
+            continue;
+        }
+
+        char expected[MAX_SIZE / 3 * 4 + 4];
+        char output[sizeof(expected) + 16];
+        for (uint32_t size = 0; size <= MAX_SIZE; ++size)
+        {
+            uint32_t length = ffBase64EncodedLength(size);
+            VERIFY(length == (size + 2) / 3 * 4);
+            encodeReference(size, input, expected);
+
+            // The encoder must not write past the encoded length
+            memset(output, '#', sizeof(output));
+            ffBase64EncodeRaw(size, input, output);
+            VERIFY(memcmp(output, expected, length) == 0);
+            VERIFY(output[length] == '#');
+
+            // Unaligned input
+            if (size > 0)
+            {
+                encodeReference(size - 1, input + 1, expected);
+                ffBase64EncodeRaw(size - 1, input + 1, output);
+                VERIFY(memcmp(output, expected, ffBase64EncodedLength(size - 1)) == 0);
+            }
+        }
+
+        FF_STRBUF_AUTO_DESTROY strbuf = ffStrbufCreateS("prefix:");
+        ffBase64Append(&strbuf, 5, "hello");
+        VERIFY(ffStrbufEqualS(&strbuf, "prefix:aGVsbG8="));
+    }
+
+    ffBase64ForceImpl(FF_BASE64_IMPL_AUTO);
+
+    //Success
+    puts("\033[32mAll tests passed!"FASTFETCH_TEXT_MODIFIER_RESET);
+}
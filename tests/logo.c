@@ -0,0 +1,95 @@
+#include "logo/logo.h"
+#include "util/textModifier.h"
+
+#include <ctype.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+__attribute__((__noreturn__))
+static void testFailed(const char* name, const char* expression, int lineNo)
+{
+    fputs(FASTFETCH_TEXT_MODIFIER_ERROR, stderr);
+    fprintf(stderr, "[%d] %s, name: %s", lineNo, expression, name);
+    fputs(FASTFETCH_TEXT_MODIFIER_RESET, stderr);
+    fputc('\n', stderr);
+    exit(1);
+}
+
+#define VERIFY(expression) if(!(expression)) testFailed(name, #expression, __LINE__)
+
+static bool matchesSize(const FFlogo* logo, FFLogoSize size)
+{
+    switch (size)
+    {
+        case FF_LOGO_SIZE_NORMAL:
+            return logo->type == FF_LOGO_LINE_TYPE_NORMAL;
+        case FF_LOGO_SIZE_SMALL:
+            return logo->type == FF_LOGO_LINE_TYPE_SMALL_BIT;
+        default:
+            return true;
+    }
+}
+
+// The first logo in builtin order with the given name, found the slow way
+static const FFlogo* findLinear(const char* name, FFLogoSize size)
+{
+    for (uint32_t i = 0; i < 26; ++i)
+    {
+        for (const FFlogo* logo = ffLogoBuiltins[i]; *logo->names; ++logo)
+        {
+            if (!matchesSize(logo, size))
+                continue;
+            for (uint32_t j = 0; j < FASTFETCH_LOGO_MAX_NAMES && logo->names[j]; ++j)
+            {
+                if (strcasecmp(logo->names[j], name) == 0)
+                    return logo;
+            }
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    const char* name = "";
+
+    // The index must be sorted the way the lookup compares
+    for (uint32_t i = 1; i < ffLogoBuiltinAliasCount; ++i)
+    {
+        name = ffLogoBuiltinAliases[i].name;
+        VERIFY(strcmp(ffLogoBuiltinAliases[i - 1].name, ffLogoBuiltinAliases[i].name) <= 0);
+    }
+
+    // Every name of every builtin logo must be found, and resolve to the same logo as a linear scan
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < 26; ++i)
+    {
+        for (const FFlogo* logo = ffLogoBuiltins[i]; *logo->names; ++logo)
+        {
+            for (uint32_t j = 0; j < FASTFETCH_LOGO_MAX_NAMES && logo->names[j]; ++j, ++count)
+            {
+                char lowerName[128];
+                name = logo->names[j];
+                VERIFY(strlen(name) < sizeof(lowerName));
+                for (uint32_t k = 0; k <= strlen(name); ++k)
+                    lowerName[k] = (char) tolower((unsigned char) name[k]);
+
+                for (FFLogoSize size = FF_LOGO_SIZE_UNKNOWN; size <= FF_LOGO_SIZE_SMALL; ++size)
+                {
+                    const FFlogo* expected = findLinear(name, size);
+                    const FFLogoBuiltinAlias* alias = ffLogoBuiltinFindAlias(lowerName, size);
+                    VERIFY((alias != NULL) == (expected != NULL));
+                    if (alias)
+                        VERIFY(&ffLogoBuiltins[alias->letter - 'A'][alias->index] == expected);
+                }
+            }
+        }
+    }
+
+    name = "";
+    VERIFY(count == ffLogoBuiltinAliasCount);
+
+    //Success
+    puts("\033[32mAll tests passed!"FASTFETCH_TEXT_MODIFIER_RESET);
+}
@@ -0,0 +1,222 @@
+#include "fastfetch.h"
+#include "common/networking.h"
+#include "util/textModifier.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+__attribute__((__noreturn__))
+static void testFailed(const char* name, const char* expression, int lineNo)
+{
+    fputs(FASTFETCH_TEXT_MODIFIER_ERROR, stderr);
+    fprintf(stderr, "[%d] %s, name: %s", lineNo, expression, name);
+    fputs(FASTFETCH_TEXT_MODIFIER_RESET, stderr);
+    fputc('\n', stderr);
+    exit(1);
+}
+
+#define VERIFY(expression) if(!(expression)) testFailed(name, #expression, __LINE__)
+
+// Replaces the resolver of libc, so that a host can resolve to several loopback addresses in a known order.
+// Nothing listens on 127.0.0.2, so connecting to it is refused
+int getaddrinfo(const char* node, const char* service, const struct addrinfo* hints, struct addrinfo** res)
+{
+    const char* addrs[2] = { node, NULL };
+    if (strcmp(node, "fallback.test") == 0)
+    {
+        addrs[0] = "127.0.0.2";
+        addrs[1] = "127.0.0.1";
+    }
+    else if (strcmp(node, "refused.test") == 0)
+        addrs[0] = "127.0.0.2";
+
+    if (hints && hints->ai_family == AF_INET6)
+        return EAI_FAMILY;
+
+    *res = NULL;
+    for (int i = 1; i >= 0; --i)
+    {
+        if (!addrs[i]) continue;
+
+        struct addrinfo* ai = calloc(1, sizeof(*ai) + sizeof(struct sockaddr_in));
+        struct sockaddr_in* addr = (struct sockaddr_in*) (ai + 1);
+        addr->sin_family = AF_INET;
+        addr->sin_port = htons((uint16_t) strtoul(service, NULL, 10));
+        if (inet_pton(AF_INET, addrs[i], &addr->sin_addr) != 1)
+        {
+            free(ai);
+            freeaddrinfo(*res);
+            return EAI_NONAME;
+        }
+
+        ai->ai_family = AF_INET;
+        ai->ai_socktype = SOCK_STREAM;
+        ai->ai_addrlen = sizeof(*addr);
+        ai->ai_addr = (struct sockaddr*) addr;
+        ai->ai_next = *res;
+        *res = ai;
+    }
+    return 0;
+}
+
+void freeaddrinfo(struct addrinfo* ai)
+{
+    while (ai)
+    {
+        struct addrinfo* next = ai->ai_next;
+        free(ai);
+        ai = next;
+    }
+}
+
+// How the server answers one request: `parts` are sent one by one with a pause in between.
+// If `closeAfter` is false, the connection is kept open until the client closes it, so the response must be recognized as complete by its Content-Length
+typedef struct TestServer
+{
+    int listenFd;
+    const char* parts[4];
+    bool closeAfter;
+    char request[1024];
+} TestServer;
+
+static void* serve(void* data)
+{
+    TestServer* server = data;
+    int fd = accept(server->listenFd, NULL, NULL);
+    if (fd < 0) return NULL;
+
+    size_t length = 0;
+    while (length < sizeof(server->request) - 1)
+    {
+        ssize_t received = recv(fd, server->request + length, sizeof(server->request) - 1 - length, 0);
+        if (received <= 0) break;
+        length += (size_t) received;
+        server->request[length] = '\0';
+        if (strstr(server->request, "\r\n\r\n")) break;
+    }
+
+    for (uint32_t i = 0; i < sizeof(server->parts) / sizeof(*server->parts) && server->parts[i]; ++i)
+    {
+        if (i > 0) usleep(50 * 1000);
+        send(fd, server->parts[i], strlen(server->parts[i]), MSG_NOSIGNAL);
+    }
+
+    if (!server->closeAfter)
+    {
+        char c;
+        while (recv(fd, &c, 1, 0) > 0);
+    }
+    close(fd);
+    return NULL;
+}
+
+// Without `serving`, no connection is expected to reach the server
+static const char* request(TestServer* server, const char* hostName, bool serving, FFstrbuf* response)
+{
+    struct sockaddr_in addr = { .sin_family = AF_INET };
+    socklen_t addrLen = sizeof(addr);
+    getsockname(server->listenFd, (struct sockaddr*) &addr, &addrLen);
+    char host[64];
+    snprintf(host, sizeof(host), "%s:%u", hostName, (unsigned) ntohs(addr.sin_port));
+
+    pthread_t thread;
+    if (serving)
+        pthread_create(&thread, NULL, serve, server);
+
+    FFNetworkingState state = { .timeout = 2000 };
+    const char* error = ffNetworkingSendHttpRequest(&state, host, "/test", "");
+    if (!error)
+        error = ffNetworkingRecvHttpResponse(&state, response);
+
+    if (serving)
+        pthread_join(thread, NULL);
+    return error;
+}
+
+int main(void)
+{
+    const char* name = "listen";
+
+    TestServer server = {};
+    server.listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    VERIFY(server.listenFd >= 0);
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    VERIFY(bind(server.listenFd, (struct sockaddr*) &addr, sizeof(addr)) == 0);
+    VERIFY(listen(server.listenFd, 4) == 0);
+
+    {
+        name = "complete response";
+        FF_STRBUF_AUTO_DESTROY response = ffStrbufCreate();
+        server.parts[0] = "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello";
+        server.parts[1] = NULL;
+        server.closeAfter = false;
+        VERIFY(request(&server, "127.0.0.1", true, &response) == NULL);
+        VERIFY(ffStrbufStartsWithS(&response, "HTTP/1.1 200 OK\r\n"));
+        VERIFY(ffStrbufEndsWithS(&response, "\r\n\r\nhello"));
+        VERIFY(strncmp(server.request, "GET /test HTTP/1.1\r\n", strlen("GET /test HTTP/1.1\r\n")) == 0);
+    }
+
+    {
+        name = "body in chunks";
+        FF_STRBUF_AUTO_DESTROY response = ffStrbufCreate();
+        server.parts[0] = "HTTP/1.1 200 OK\r\nContent-";
+        server.parts[1] = "Length: 11\r\n\r\nhello";
+        server.parts[2] = " world";
+        server.parts[3] = NULL;
+        server.closeAfter = false;
+        VERIFY(request(&server, "127.0.0.1", true, &response) == NULL);
+        VERIFY(ffStrbufEndsWithS(&response, "\r\n\r\nhello world"));
+    }
+
+    {
+        name = "body ended by close";
+        FF_STRBUF_AUTO_DESTROY response = ffStrbufCreate();
+        server.parts[0] = "HTTP/1.0 200 OK\r\n\r\nsh";
+        server.parts[1] = "ort";
+        server.parts[2] = NULL;
+        server.closeAfter = true;
+        VERIFY(request(&server, "127.0.0.1", true, &response) == NULL);
+        VERIFY(ffStrbufEndsWithS(&response, "\r\n\r\nshort"));
+    }
+
+    {
+        name = "invalid status";
+        FF_STRBUF_AUTO_DESTROY response = ffStrbufCreate();
+        server.parts[0] = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+        server.parts[1] = NULL;
+        server.closeAfter = false;
+        VERIFY(request(&server, "127.0.0.1", true, &response) != NULL);
+        VERIFY(response.length == 0);
+    }
+
+    for (int multithreading = 0; multithreading <= 1; ++multithreading)
+    {
+        // The first candidate is refused, the second one must be used
+        name = multithreading ? "fallback (resolver thread)" : "fallback";
+        instance.config.general.multithreading = multithreading;
+        FF_STRBUF_AUTO_DESTROY response = ffStrbufCreate();
+        server.parts[0] = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+        server.parts[1] = NULL;
+        server.closeAfter = false;
+        VERIFY(request(&server, "fallback.test", true, &response) == NULL);
+        VERIFY(ffStrbufEndsWithS(&response, "\r\n\r\nok"));
+        VERIFY(strstr(server.request, "\r\nHost: fallback.test:") != NULL);
+    }
+
+    {
+        name = "all candidates refused";
+        FF_STRBUF_AUTO_DESTROY response = ffStrbufCreate();
+        VERIFY(request(&server, "refused.test", false, &response) != NULL);
+    }
+
+    close(server.listenFd);
+
+    //Success
+    puts("\033[32mAll tests passed!"FASTFETCH_TEXT_MODIFIER_RESET);
+}